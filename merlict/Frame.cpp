@@ -15,6 +15,7 @@ namespace merlict {
 
 Frame::Frame():
     bounding_sphere_radius(0.0),
+    world2frame_is_translation(true),
     mother(this),
     root_frame(this) {}
 
@@ -132,6 +133,8 @@ void Frame::init_tree_based_on_mother_child_relations() {
 void Frame::init_frame2world() {
     // Run from top to bottom through the tree.
     T_frame2world = calculate_frame2world();
+    T_world2frame = T_frame2world.inverse();
+    world2frame_is_translation = T_frame2world.has_unit_rotation();
 
     for (Frame* child : children)
         child->init_frame2world();
@@ -146,6 +149,13 @@ void Frame::update_bounding_sphere() {
             bound::bounding_sphere_radius(children, VEC3_ORIGIN);
 }
 
+void Frame::share_world_frame_of(const Frame* frame) {
+    T_frame2world = frame->T_frame2world;
+    T_world2frame = frame->T_world2frame;
+    world2frame_is_translation = frame->world2frame_is_translation;
+    root_frame = frame->root_frame;
+}
+
 void Frame::init_root() {
     // Run from top to bottom through the tree.
     if (has_mother())
@@ -187,6 +197,15 @@ void Frame::calculate_intersection_with(
     (void)*intersections;
 }
 
+bool Frame::find_intersection_candidates(
+    const Ray* ray,
+    std::vector<const Frame*> *candidates
+)const {
+    (void)*ray;
+    (void)*candidates;
+    return false;
+}
+
 void Frame::cluster_children() {
     if (children.size() > FRAME_MAX_NUMBER_CHILDREN) {
         std::vector<Frame*> oct_tree[8];
@@ -292,22 +311,6 @@ Vec3 Frame::position_in_world()const {
     return T_frame2world.translation();
 }
 
-double Frame::get_bounding_sphere_radius()const {
-    return bounding_sphere_radius;
-}
-
-const HomTra3* Frame::frame2mother()const {
-    return &T_frame2mother;
-}
-
-const HomTra3* Frame::frame2world()const {
-    return &T_frame2world;
-}
-
-const std::vector<Frame*>* Frame::get_children()const {
-    return &children;
-}
-
 void Frame::assert_no_children_duplicate_names()const {
     // this also checks for duplicate frames
     std::set<std::string> unique_set;
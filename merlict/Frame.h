@@ -30,6 +30,12 @@ class Frame {
     double bounding_sphere_radius;
     HomTra3 T_frame2mother;
     HomTra3 T_frame2world;
+    // The inverse of T_frame2world, cached for the transformation of the
+    // rays into the frame.
+    HomTra3 T_world2frame;
+    // True when the frame is only translated with respect to the world,
+    // as all frames with ROT3_UNITY in the tree above are.
+    bool world2frame_is_translation;
     std::vector<Frame*> children;
     Frame *mother;
     const Frame *root_frame;
@@ -51,6 +57,8 @@ class Frame {
     double get_bounding_sphere_radius()const;
     const HomTra3* frame2mother()const;
     const HomTra3* frame2world()const;
+    const HomTra3* world2frame()const;
+    bool world2frame_is_only_translation()const;
     const std::vector<Frame*>* get_children()const;
     const Frame* root()const;
     bool has_mother()const;
@@ -71,6 +79,21 @@ class Frame {
     virtual void calculate_intersection_with(
         const Ray* ray,
         std::vector<Intersection> *intersections)const;
+    // Frames which know the layout of their children can tell from the ray
+    // (in world coordinates) which descendants it can possibly hit, and
+    // append only these to the candidates. A frame may append itself to be
+    // intersected as a whole by its own calculate_intersection_with().
+    // Returns false when all children need to be tested.
+    virtual bool find_intersection_candidates(
+        const Ray* ray,
+        std::vector<const Frame*> *candidates)const;
+
+ protected:
+    virtual void update_bounding_sphere();
+    // For a frame outside of the tree which shares the frame of a frame in
+    // the tree. Copies the state the initialization of the tree derives
+    // for a frame.
+    void share_world_frame_of(const Frame* frame);
 
  private:
     HomTra3 calculate_frame2world()const;
@@ -81,9 +104,32 @@ class Frame {
     void warn_about_close_frames()const;
     void cluster_children();
     void assert_name_is_valid(const std::string name_to_check)const;
-    void update_bounding_sphere();
 };
 
+inline double Frame::get_bounding_sphere_radius()const {
+    return bounding_sphere_radius;
+}
+
+inline const HomTra3* Frame::frame2mother()const {
+    return &T_frame2mother;
+}
+
+inline const HomTra3* Frame::frame2world()const {
+    return &T_frame2world;
+}
+
+inline const HomTra3* Frame::world2frame()const {
+    return &T_world2frame;
+}
+
+inline bool Frame::world2frame_is_only_translation()const {
+    return world2frame_is_translation;
+}
+
+inline const std::vector<Frame*>* Frame::get_children()const {
+    return &children;
+}
+
 const Frame VOID_FRAME;
 
 }  // namespace merlict
@@ -7,39 +7,6 @@
 
 namespace merlict {
 
-// homogenous Transformation, component adresses:
-// [ 0,0    0,1     0,2     0,3 ]
-// [ 1,0    1,1     1,2     1,3 ]
-// [ 2,0    2,1     2,2     2,3 ]
-// [ 3,0    3,1     3,2     3,3 ]
-//
-// -Rotatin component: Matrix r[3x3]
-// -Translation component: Vector t[1x3]
-//
-// homoT =  [ r(0,0) r(0,1) r(0,2) t(1) ]
-//          [ r(1,0) r(1,1) r(1,2) t(2) ]
-//          [ r(2,0) r(2,1) r(2,2) t(3) ]
-//          [ 0      0      0      1    ]
-//
-
-HomTra3::HomTra3():
-    T{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}
-{
-    // default init is unit matrix
-    // [1 0 0 0]
-    // [0 1 0 0]
-    // [0 0 1 0]
-    // [0 0 0 1] //last row is always the same
-}
-
-HomTra3::HomTra3(
-    const double r00, const double r10, const double r20, const double t30,
-    const double r01, const double r11, const double r21, const double t31,
-    const double r02, const double r12, const double r22, const double t32
-):
-    T{{r00, r10, r20, t30}, {r01, r11, r21, t31}, {r02, r12, r22, t32}}
-{}
-
 void HomTra3::set_transformation(const Rot3 R, const Vec3 pos) {
     HomTra3 TrafRotation;
     TrafRotation.set_rotation_component(R);
@@ -151,78 +118,6 @@ void HomTra3::set_z_column_of_rotation_component(const Vec3 &R) {
     T[2][2] = R.z;
 }
 
-Vec3 HomTra3::orientation(const Vec3& ori)const {
-    return Vec3(
-        // x
-        ori.x*T[0][0] +
-        ori.y*T[0][1] +
-        ori.z*T[0][2],
-        // y
-        ori.x*T[1][0] +
-        ori.y*T[1][1] +
-        ori.z*T[1][2],
-        // z
-        ori.x*T[2][0] +
-        ori.y*T[2][1] +
-        ori.z*T[2][2]);
-}
-
-Vec3 HomTra3::orientation_inverse(const Vec3& ori)const {
-    return Vec3(
-        // x
-        ori.x*T[0][0] +
-        ori.y*T[1][0] +
-        ori.z*T[2][0],
-        // y
-        ori.x*T[0][1] +
-        ori.y*T[1][1] +
-        ori.z*T[2][1],
-        // z
-        ori.x*T[0][2] +
-        ori.y*T[1][2] +
-        ori.z*T[2][2]);
-}
-
-Vec3 HomTra3::position(const Vec3& pos)const {
-    return Vec3(
-        // x
-        pos.x*T[0][0] +
-        pos.y*T[0][1] +
-        pos.z*T[0][2] + T[0][3],
-        // y
-        pos.x*T[1][0] +
-        pos.y*T[1][1] +
-        pos.z*T[1][2] + T[1][3],
-        // z
-        pos.x*T[2][0] +
-        pos.y*T[2][1] +
-        pos.z*T[2][2] + T[2][3]);
-}
-
-Vec3 HomTra3::position_inverse(const Vec3& pos)const {
-  return Vec3(
-    // x
-    pos.x*T[0][0] +
-    pos.y*T[1][0] +
-    pos.z*T[2][0] - (T[0][0]*T[0][3] + T[1][0]*T[1][3] + T[2][0]*T[2][3]),
-    // y
-    pos.x*T[0][1] +
-    pos.y*T[1][1] +
-    pos.z*T[2][1] - (T[0][1]*T[0][3] + T[1][1]*T[1][3] + T[2][1]*T[2][3]),
-    // z
-    pos.x*T[0][2] +
-    pos.y*T[1][2] +
-    pos.z*T[2][2] - (T[0][2]*T[0][3] + T[1][2]*T[1][3] + T[2][2]*T[2][3]));
-}
-
-Vec3 HomTra3::translation()const {
-    return Vec3(T[0][3], T[1][3], T[2][3]);
-}
-
-Vec3 HomTra3::rot_x()const { return Vec3(T[0][0], T[1][0], T[2][0]); }
-Vec3 HomTra3::rot_y()const { return Vec3(T[0][1], T[1][1], T[2][1]); }
-Vec3 HomTra3::rot_z()const { return Vec3(T[0][2], T[1][2], T[2][2]); }
-
 std::string HomTra3::str()const {
     std::stringstream out;
     out << std::setprecision(3);
@@ -242,61 +137,27 @@ std::string HomTra3::single_row_str(const unsigned int r)const {
 }
 
 
-HomTra3 HomTra3::operator* (const HomTra3 G)const {
-  // Matrix multiplication
-
-  return HomTra3(
-    T[0][0]*G.T[0][0] + T[0][1]*G.T[1][0] + T[0][2]*G.T[2][0],  // + T[0][3]*  0
-    T[0][0]*G.T[0][1] + T[0][1]*G.T[1][1] + T[0][2]*G.T[2][1],  // + T[0][3]*  0
-    T[0][0]*G.T[0][2] + T[0][1]*G.T[1][2] + T[0][2]*G.T[2][2],  // + T[0][3]*  0
-    T[0][0]*G.T[0][3] + T[0][1]*G.T[1][3] + T[0][2]*G.T[2][3] + T[0][3],  //*  1
-
-    T[1][0]*G.T[0][0] + T[1][1]*G.T[1][0] + T[1][2]*G.T[2][0],  // + T[1][3]*  0
-    T[1][0]*G.T[0][1] + T[1][1]*G.T[1][1] + T[1][2]*G.T[2][1],  // + T[1][3]*  0
-    T[1][0]*G.T[0][2] + T[1][1]*G.T[1][2] + T[1][2]*G.T[2][2],  // + T[1][3]*  0
-    T[1][0]*G.T[0][3] + T[1][1]*G.T[1][3] + T[1][2]*G.T[2][3] + T[1][3],  //*  1
-
-    T[2][0]*G.T[0][0] + T[2][1]*G.T[1][0] + T[2][2]*G.T[2][0],  // + T[2][3]*  0
-    T[2][0]*G.T[0][1] + T[2][1]*G.T[1][1] + T[2][2]*G.T[2][1],  // + T[2][3]*  0
-    T[2][0]*G.T[0][2] + T[2][1]*G.T[1][2] + T[2][2]*G.T[2][2],  // + T[2][3]*  0
-    T[2][0]*G.T[0][3] + T[2][1]*G.T[1][3] + T[2][2]*G.T[2][3] + T[2][3]);  //* 1
-
-    // T[3][0]*G.T[0][0]+T[3][1]*G.T[1][0]+T[3][2]*G.T[2][0]+T[3][3]*G.T[3][0]
-    // T[3][0]*G.T[0][1]+T[3][1]*G.T[1][1]+T[3][2]*G.T[2][1]+T[3][3]*G.T[3][1]
-    // T[3][0]*G.T[0][2]+T[3][1]*G.T[1][2]+T[3][2]*G.T[2][2]+T[3][3]*G.T[3][2]
-    // T[3][0]*G.T[0][3]+T[3][1]*G.T[1][3]+T[3][2]*G.T[2][3]+T[3][3]*G.T[3][3]
-}
-
-HomTra3 HomTra3::inverse()const {
-    // The inverse Homogenous Transformation is a composition of two components:
-    //
-    // 1)
-    //   inverse_HomTra3_rot =           | 0   The inverse rotation matrix R^-1
-    //                             R^-1  | 0   is the same as R^T since rotation
-    //                                   | 0   matrices are orthogonal.
-    //                          ---------+---  The translation component is
-    //                           0  0  0 | 1   (0,0,0).
-    //
-    // 2)
-    //   inverse_HomTra3_trans = 1  0  0 | -tx  The rotation part is unity.
-    //                           0  1  0 | -ty  The translation part is the
-    //                           0  0  1 | -tz  negative translation component
-    //                          ---------+---   of the original
-    //                           0  0  0 | 1
-    //
-    // Now these two components are multiplied to compose the inverse HomTra3:
-    //
-    // inverse_HomTra3 = inverse_HomTra3_rot * inverse_HomTra3_trans
-    //
-    // The composition done by hand:
-    return HomTra3(
-        T[0][0], T[1][0], T[2][0],
-            -(T[0][0]*T[0][3] + T[1][0]*T[1][3] + T[2][0]*T[2][3]),
-        T[0][1], T[1][1], T[2][1],
-            -(T[0][1]*T[0][3] + T[1][1]*T[1][3] + T[2][1]*T[2][3]),
-        T[0][2], T[1][2], T[2][2],
-            -(T[0][2]*T[0][3] + T[1][2]*T[1][3] + T[2][2]*T[2][3]));
-}
+// The inverse Homogenous Transformation is a composition of two components:
+//
+// 1)
+//   inverse_HomTra3_rot =           | 0   The inverse rotation matrix R^-1
+//                             R^-1  | 0   is the same as R^T since rotation
+//                                   | 0   matrices are orthogonal.
+//                          ---------+---  The translation component is
+//                           0  0  0 | 1   (0,0,0).
+//
+// 2)
+//   inverse_HomTra3_trans = 1  0  0 | -tx  The rotation part is unity.
+//                           0  1  0 | -ty  The translation part is the
+//                           0  0  1 | -tz  negative translation component
+//                          ---------+---   of the original
+//                           0  0  0 | 1
+//
+// Now these two components are multiplied to compose the inverse HomTra3:
+//
+// inverse_HomTra3 = inverse_HomTra3_rot * inverse_HomTra3_trans
+//
+// The composition is done by hand in HomTra3::inverse().
 
 bool HomTra3::operator== (HomTra3 G)const {
     for (unsigned int row = 0; row < 4; row++)
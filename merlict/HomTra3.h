@@ -29,23 +29,27 @@ namespace merlict {
 // - Unit Quaternion
 // - Homogeneous Transformation
 
+// The transformations of vectors and the composition are defined inline
+// below, so that they can be inlined into the ray tracing loops.
 class HomTra3 {
     double T[3][4];
 
  public:
-    HomTra3();
+    constexpr HomTra3() noexcept;
     void set_transformation(const Rot3 R, const Vec3 pos);
     void set_transformation(Vec3 rotx, Vec3 roty, Vec3 rotz, const Vec3 pos);
-    Vec3 orientation(const Vec3& ori)const;
-    Vec3 orientation_inverse(const Vec3& ori)const;
-    Vec3 position(const Vec3& pos)const;
-    Vec3 position_inverse(const Vec3& pos)const;
-    Vec3 translation()const;
-    Vec3 rot_x()const;
-    Vec3 rot_y()const;
-    Vec3 rot_z()const;
-    HomTra3 operator* (const HomTra3 G)const;
-    HomTra3 inverse()const;
+    constexpr Vec3 orientation(const Vec3& ori)const noexcept;
+    constexpr Vec3 orientation_inverse(const Vec3& ori)const noexcept;
+    constexpr Vec3 position(const Vec3& pos)const noexcept;
+    constexpr Vec3 position_inverse(const Vec3& pos)const noexcept;
+    constexpr Vec3 translation()const noexcept;
+    constexpr Vec3 rot_x()const noexcept;
+    constexpr Vec3 rot_y()const noexcept;
+    constexpr Vec3 rot_z()const noexcept;
+    constexpr HomTra3 operator* (const HomTra3 G)const noexcept;
+    constexpr HomTra3 inverse()const noexcept;
+    // Exactly, not within a tolerance.
+    constexpr bool has_unit_rotation()const noexcept;
     bool operator== (HomTra3 G)const;
     std::string str()const;
 
@@ -58,12 +62,165 @@ class HomTra3 {
     void set_x_column_of_rotation_component(const Vec3 &R);
     void set_y_column_of_rotation_component(const Vec3 &R);
     void set_z_column_of_rotation_component(const Vec3 &R);
-    HomTra3(
+    constexpr HomTra3(
         const double r00, const double r10, const double r20, const double t30,
         const double r01, const double r11, const double r21, const double t31,
-        const double r02, const double r12, const double r22, const double t32);
+        const double r02, const double r12, const double r22, const double t32)
+        noexcept;
 };
 
+// homogenous Transformation, component adresses:
+// [ 0,0    0,1     0,2     0,3 ]
+// [ 1,0    1,1     1,2     1,3 ]
+// [ 2,0    2,1     2,2     2,3 ]
+// [ 3,0    3,1     3,2     3,3 ]
+//
+// -Rotatin component: Matrix r[3x3]
+// -Translation component: Vector t[1x3]
+//
+// homoT =  [ r(0,0) r(0,1) r(0,2) t(1) ]
+//          [ r(1,0) r(1,1) r(1,2) t(2) ]
+//          [ r(2,0) r(2,1) r(2,2) t(3) ]
+//          [ 0      0      0      1    ]
+//
+
+constexpr HomTra3::HomTra3() noexcept:
+    T{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}
+{
+    // default init is unit matrix
+    // [1 0 0 0]
+    // [0 1 0 0]
+    // [0 0 1 0]
+    // [0 0 0 1] //last row is always the same
+}
+
+constexpr HomTra3::HomTra3(
+    const double r00, const double r10, const double r20, const double t30,
+    const double r01, const double r11, const double r21, const double t31,
+    const double r02, const double r12, const double r22, const double t32
+) noexcept:
+    T{{r00, r10, r20, t30}, {r01, r11, r21, t31}, {r02, r12, r22, t32}}
+{}
+
+constexpr Vec3 HomTra3::orientation(const Vec3& ori)const noexcept {
+    return Vec3(
+        // x
+        ori.x*T[0][0] +
+        ori.y*T[0][1] +
+        ori.z*T[0][2],
+        // y
+        ori.x*T[1][0] +
+        ori.y*T[1][1] +
+        ori.z*T[1][2],
+        // z
+        ori.x*T[2][0] +
+        ori.y*T[2][1] +
+        ori.z*T[2][2]);
+}
+
+constexpr Vec3 HomTra3::orientation_inverse(const Vec3& ori)const noexcept {
+    return Vec3(
+        // x
+        ori.x*T[0][0] +
+        ori.y*T[1][0] +
+        ori.z*T[2][0],
+        // y
+        ori.x*T[0][1] +
+        ori.y*T[1][1] +
+        ori.z*T[2][1],
+        // z
+        ori.x*T[0][2] +
+        ori.y*T[1][2] +
+        ori.z*T[2][2]);
+}
+
+constexpr Vec3 HomTra3::position(const Vec3& pos)const noexcept {
+    return Vec3(
+        // x
+        pos.x*T[0][0] +
+        pos.y*T[0][1] +
+        pos.z*T[0][2] + T[0][3],
+        // y
+        pos.x*T[1][0] +
+        pos.y*T[1][1] +
+        pos.z*T[1][2] + T[1][3],
+        // z
+        pos.x*T[2][0] +
+        pos.y*T[2][1] +
+        pos.z*T[2][2] + T[2][3]);
+}
+
+constexpr Vec3 HomTra3::position_inverse(const Vec3& pos)const noexcept {
+  return Vec3(
+    // x
+    pos.x*T[0][0] +
+    pos.y*T[1][0] +
+    pos.z*T[2][0] - (T[0][0]*T[0][3] + T[1][0]*T[1][3] + T[2][0]*T[2][3]),
+    // y
+    pos.x*T[0][1] +
+    pos.y*T[1][1] +
+    pos.z*T[2][1] - (T[0][1]*T[0][3] + T[1][1]*T[1][3] + T[2][1]*T[2][3]),
+    // z
+    pos.x*T[0][2] +
+    pos.y*T[1][2] +
+    pos.z*T[2][2] - (T[0][2]*T[0][3] + T[1][2]*T[1][3] + T[2][2]*T[2][3]));
+}
+
+constexpr Vec3 HomTra3::translation()const noexcept {
+    return Vec3(T[0][3], T[1][3], T[2][3]);
+}
+
+constexpr Vec3 HomTra3::rot_x()const noexcept {
+    return Vec3(T[0][0], T[1][0], T[2][0]);
+}
+
+constexpr Vec3 HomTra3::rot_y()const noexcept {
+    return Vec3(T[0][1], T[1][1], T[2][1]);
+}
+
+constexpr Vec3 HomTra3::rot_z()const noexcept {
+    return Vec3(T[0][2], T[1][2], T[2][2]);
+}
+
+constexpr HomTra3 HomTra3::operator* (const HomTra3 G)const noexcept {
+  // Matrix multiplication
+
+  return HomTra3(
+    T[0][0]*G.T[0][0] + T[0][1]*G.T[1][0] + T[0][2]*G.T[2][0],  // + T[0][3]*  0
+    T[0][0]*G.T[0][1] + T[0][1]*G.T[1][1] + T[0][2]*G.T[2][1],  // + T[0][3]*  0
+    T[0][0]*G.T[0][2] + T[0][1]*G.T[1][2] + T[0][2]*G.T[2][2],  // + T[0][3]*  0
+    T[0][0]*G.T[0][3] + T[0][1]*G.T[1][3] + T[0][2]*G.T[2][3] + T[0][3],  //*  1
+
+    T[1][0]*G.T[0][0] + T[1][1]*G.T[1][0] + T[1][2]*G.T[2][0],  // + T[1][3]*  0
+    T[1][0]*G.T[0][1] + T[1][1]*G.T[1][1] + T[1][2]*G.T[2][1],  // + T[1][3]*  0
+    T[1][0]*G.T[0][2] + T[1][1]*G.T[1][2] + T[1][2]*G.T[2][2],  // + T[1][3]*  0
+    T[1][0]*G.T[0][3] + T[1][1]*G.T[1][3] + T[1][2]*G.T[2][3] + T[1][3],  //*  1
+
+    T[2][0]*G.T[0][0] + T[2][1]*G.T[1][0] + T[2][2]*G.T[2][0],  // + T[2][3]*  0
+    T[2][0]*G.T[0][1] + T[2][1]*G.T[1][1] + T[2][2]*G.T[2][1],  // + T[2][3]*  0
+    T[2][0]*G.T[0][2] + T[2][1]*G.T[1][2] + T[2][2]*G.T[2][2],  // + T[2][3]*  0
+    T[2][0]*G.T[0][3] + T[2][1]*G.T[1][3] + T[2][2]*G.T[2][3] + T[2][3]);  //* 1
+}
+
+// The inverse is the transposed rotation R^T, followed by the translation
+// -R^T*t, see HomTra3.cpp.
+constexpr HomTra3 HomTra3::inverse()const noexcept {
+    return HomTra3(
+        T[0][0], T[1][0], T[2][0],
+            -(T[0][0]*T[0][3] + T[1][0]*T[1][3] + T[2][0]*T[2][3]),
+        T[0][1], T[1][1], T[2][1],
+            -(T[0][1]*T[0][3] + T[1][1]*T[1][3] + T[2][1]*T[2][3]),
+        T[0][2], T[1][2], T[2][2],
+            -(T[0][2]*T[0][3] + T[1][2]*T[1][3] + T[2][2]*T[2][3]));
+}
+
+constexpr bool HomTra3::has_unit_rotation()const noexcept {
+    return
+        T[0][0] == 1.0 && T[0][1] == 0.0 && T[0][2] == 0.0 &&
+        T[1][0] == 0.0 && T[1][1] == 1.0 && T[1][2] == 0.0 &&
+        T[2][0] == 0.0 && T[2][1] == 0.0 && T[2][2] == 1.0;
+}
+
 }  // namespace merlict
 
 #endif  // MERLICT_HOMTRA3_H_
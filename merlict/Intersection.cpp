@@ -84,14 +84,26 @@ double Intersection::facing_reflection_propability(
     const double wavelength
 )const {
     return __from_outside_to_inside ?
-        __object->outer_reflection->evaluate(wavelength):
-        __object->inner_reflection->evaluate(wavelength);
+        __object->evaluate(
+            &SurfaceTable::Node::outer_reflection,
+            __object->outer_reflection,
+            wavelength):
+        __object->evaluate(
+            &SurfaceTable::Node::inner_reflection,
+            __object->inner_reflection,
+            wavelength);
 }
 
 double Intersection::refractive_index_going_to(const double wavelength)const {
     return __from_outside_to_inside ?
-        __object->inner_refraction->evaluate(wavelength):
-        __object->outer_refraction->evaluate(wavelength);
+        __object->evaluate(
+            &SurfaceTable::Node::inner_refraction,
+            __object->inner_refraction,
+            wavelength):
+        __object->evaluate(
+            &SurfaceTable::Node::outer_refraction,
+            __object->outer_refraction,
+            wavelength);
 }
 
 bool Intersection::going_to_default_refractive_index()const {
@@ -104,20 +116,38 @@ double Intersection::refractive_index_coming_from(
     const double wavelength
 )const {
     return __from_outside_to_inside ?
-        __object->outer_refraction->evaluate(wavelength):
-        __object->inner_refraction->evaluate(wavelength);
+        __object->evaluate(
+            &SurfaceTable::Node::outer_refraction,
+            __object->outer_refraction,
+            wavelength):
+        __object->evaluate(
+            &SurfaceTable::Node::inner_refraction,
+            __object->inner_refraction,
+            wavelength);
 }
 
 double Intersection::half_way_depth_coming_from(const double wavelength)const {
     return __from_outside_to_inside ?
-        __object->outer_absorption->evaluate(wavelength):
-        __object->inner_absorption->evaluate(wavelength);
+        __object->evaluate(
+            &SurfaceTable::Node::outer_absorption,
+            __object->outer_absorption,
+            wavelength):
+        __object->evaluate(
+            &SurfaceTable::Node::inner_absorption,
+            __object->inner_absorption,
+            wavelength);
 }
 
 double Intersection::half_way_depth_going_to(const double wavelength)const {
     return __from_outside_to_inside ?
-        __object->inner_absorption->evaluate(wavelength):
-        __object->outer_absorption->evaluate(wavelength);
+        __object->evaluate(
+            &SurfaceTable::Node::inner_absorption,
+            __object->inner_absorption,
+            wavelength):
+        __object->evaluate(
+            &SurfaceTable::Node::outer_absorption,
+            __object->outer_absorption,
+            wavelength);
 }
 
 bool Intersection::boundary_layer_is_transparent()const {
@@ -0,0 +1,57 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/MemoryMap.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace merlict {
+
+MemoryMap::MemoryMap(const std::string &path):
+    path_(path),
+    data_(nullptr),
+    size_(0u) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "MemoryMap: Can not open file '" << path << "'.";
+        throw std::runtime_error(info.str());
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "MemoryMap: Can not stat file '" << path << "'.";
+        throw std::runtime_error(info.str());
+    }
+    size_ = static_cast<uint64_t>(status.st_size);
+    if (size_ > 0u) {
+        void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            std::stringstream info;
+            info << __FILE__ << ", " << __LINE__ << "\n";
+            info << "MemoryMap: Can not map file '" << path << "'.";
+            throw std::runtime_error(info.str());
+        }
+        data_ = static_cast<const uint8_t*>(map);
+    }
+    close(fd);
+}
+
+MemoryMap::~MemoryMap() {
+    if (data_ != nullptr)
+        munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+const uint8_t* MemoryMap::data()const {return data_;}
+
+uint64_t MemoryMap::size()const {return size_;}
+
+std::string MemoryMap::path()const {return path_;}
+
+}  // namespace merlict
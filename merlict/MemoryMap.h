@@ -0,0 +1,30 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef MERLICT_MEMORYMAP_H_
+#define MERLICT_MEMORYMAP_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace merlict {
+
+// A read-only view of a whole file mapped into memory.
+// The mapping is released when the MemoryMap goes out of scope.
+class MemoryMap {
+ public:
+    explicit MemoryMap(const std::string &path);
+    ~MemoryMap();
+    MemoryMap(const MemoryMap&) = delete;
+    MemoryMap& operator=(const MemoryMap&) = delete;
+    const uint8_t* data()const;
+    uint64_t size()const;
+    std::string path()const;
+
+ private:
+    std::string path_;
+    const uint8_t* data_;
+    uint64_t size_;
+};
+
+}  // namespace merlict
+
+#endif  // MERLICT_MEMORYMAP_H_
@@ -123,4 +123,154 @@ void Propagator::get_absorbed_on_surface() {
         ABSORPTION_ON_SURFACE);
 }
 
+BunchPropagator::BunchPropagator(
+    const std::vector<Photon*> &photons,
+    PropagationEnvironment environment
+): env(environment), bunch(photons) {
+    propagate();
+}
+
+void BunchPropagator::propagate() {
+    if (bunch.size() > 0 && limit_of_interactions_is_not_reached_yet())
+        work_on_first_causal_intersection();
+}
+
+bool BunchPropagator::limit_of_interactions_is_not_reached_yet()const {
+    return bunch.front()->num_interactions() <=
+        env.config->max_num_interactions_per_photon;
+}
+
+void BunchPropagator::work_on_first_causal_intersection() {
+    isec = rays_first_intersection_with_frame(bunch.front(), env.root_frame);
+
+    if (!isec.does_intersect()) {
+        get_absorbed(bunch, ABSORPTION_IN_VOID);
+        return;
+    }
+
+    const double one_over_e_way =
+        isec.half_way_depth_coming_from(bunch.front()->wavelength);
+    const double survival_prob =
+        exp(-isec.distance_to_ray_support()/one_over_e_way);
+    std::vector<Photon*> absorbed;
+    std::vector<Photon*> survived;
+    for (Photon* ph : bunch) {
+        if (env.prng->uniform() > survival_prob)
+            absorbed.push_back(ph);
+        else
+            survived.push_back(ph);
+    }
+    get_absorbed(absorbed, ABSORPTION_IN_VOID);
+    interact_with_object(survived);
+}
+
+void BunchPropagator::interact_with_object(
+    const std::vector<Photon*> &photons
+) {
+    if (photons.size() == 0)
+        return;
+    const double reflection_prob =
+        isec.facing_reflection_propability(bunch.front()->wavelength);
+    std::vector<Photon*> reflected;
+    std::vector<Photon*> reached;
+    for (Photon* ph : photons) {
+        if (reflection_prob >= env.prng->uniform())
+            reflected.push_back(ph);
+        else
+            reached.push_back(ph);
+    }
+    reflect_on_surface_and_propagate_on(reflected, REFLECTION_ON_SURFACE);
+    reach_boundary_layer(reached);
+}
+
+void BunchPropagator::get_absorbed(
+    const std::vector<Photon*> &photons,
+    const Interaction type
+) {
+    for (Photon* ph : photons)
+        ph->push_back_intersection_and_interaction(isec, type);
+}
+
+void BunchPropagator::reflect_on_surface_and_propagate_on(
+    const std::vector<Photon*> &photons,
+    const Interaction type
+) {
+    if (photons.size() == 0)
+        return;
+    const Vec3 support = isec.position_in_root_frame();
+    const Vec3 direction = isec.reflection_direction_in_root_frame(
+        bunch.front()->direction());
+    for (Photon* ph : photons) {
+        ph->set_support_and_direction(support, direction);
+        ph->push_back_intersection_and_interaction(isec, type);
+    }
+    BunchPropagator(photons, env);
+}
+
+void BunchPropagator::reach_boundary_layer(
+    const std::vector<Photon*> &photons
+) {
+    if (photons.size() == 0)
+        return;
+    if (isec.boundary_layer_is_transparent())
+        fresnel_refraction_and_reflection(photons);
+    else
+        get_absorbed(photons, ABSORPTION_ON_SURFACE);
+}
+
+void BunchPropagator::fresnel_refraction_and_reflection(
+    const std::vector<Photon*> &photons
+) {
+    const double wavelength = bunch.front()->wavelength;
+    Fresnel fresnel(
+        isec.object2root()->
+            orientation_inverse(bunch.front()->direction()),
+        isec.surface_normal_of_facing_surface_in_object_frame(),
+        isec.refractive_index_coming_from(wavelength),
+        isec.refractive_index_going_to(wavelength));
+
+    const double reflection_prob = fresnel.reflection_propability();
+    std::vector<Photon*> reflected;
+    std::vector<Photon*> passed;
+    for (Photon* ph : photons) {
+        if (reflection_prob > env.prng->uniform())
+            reflected.push_back(ph);
+        else
+            passed.push_back(ph);
+    }
+    reflect_on_surface_and_propagate_on(
+        reflected,
+        FRESNEL_REFLECTION_ON_SURFACE);
+    pass_the_boundary_layer(passed, fresnel);
+}
+
+void BunchPropagator::pass_the_boundary_layer(
+    const std::vector<Photon*> &photons,
+    const Fresnel &fresnel
+) {
+    if (photons.size() == 0)
+        return;
+    PropagationEnvironment env_after_boundary_layer = env;
+    if (isec.object()->has_restrictions_on_frames_to_propagate_to() &&
+        !isec.going_to_default_refractive_index()
+    )
+        env_after_boundary_layer.root_frame =
+            isec.object()->allowed_frame_to_propagate_to();
+    else
+        env_after_boundary_layer.root_frame =
+            isec.object()->root();
+
+    const Vec3 support = isec.position_in_root_frame();
+    const Vec3 direction = isec.object2root()->orientation(
+        fresnel.get_refrac_dir_in_object_system());
+    const Interaction type = isec.from_outside_to_inside() ?
+        REFRACTION_TO_INSIDE :
+        REFRACTION_TO_OUTSIDE;
+    for (Photon* ph : photons) {
+        ph->push_back_intersection_and_interaction(isec, type);
+        ph->set_support_and_direction(support, direction);
+    }
+    BunchPropagator(photons, env_after_boundary_layer);
+}
+
 }  // namespace merlict
@@ -2,6 +2,7 @@
 #ifndef MERLICT_PHOTONANDFRAME_H_
 #define MERLICT_PHOTONANDFRAME_H_
 
+#include <vector>
 #include "merlict/Photon.h"
 #include "merlict/Frame.h"
 #include "merlict/RayAndFrame.h"
@@ -32,6 +33,38 @@ class Propagator {
     void get_absorbed_on_surface();
 };
 
+class BunchPropagator {
+    // Propagates photons starting with the same support, direction and
+    // wavelength, e.g. the photons made from one bunch of CORSIKA. Their
+    // path is traced only once. On each surface every photon makes its own
+    // random decisions just like in the Propagator. The photons making the
+    // same decision go on together along their new path.
+ public:
+    Intersection isec;
+    PropagationEnvironment env;
+    std::vector<Photon*> bunch;
+
+    BunchPropagator(
+        const std::vector<Photon*> &photons,
+        PropagationEnvironment env);
+    void propagate();
+    bool limit_of_interactions_is_not_reached_yet()const;
+    void work_on_first_causal_intersection();
+    void interact_with_object(const std::vector<Photon*> &photons);
+    void get_absorbed(
+        const std::vector<Photon*> &photons,
+        const Interaction type);
+    void reflect_on_surface_and_propagate_on(
+        const std::vector<Photon*> &photons,
+        const Interaction type);
+    void reach_boundary_layer(const std::vector<Photon*> &photons);
+    void fresnel_refraction_and_reflection(
+        const std::vector<Photon*> &photons);
+    void pass_the_boundary_layer(
+        const std::vector<Photon*> &photons,
+        const Fresnel &fresnel);
+};
+
 }  // namespace merlict
 
 #endif  // MERLICT_PHOTONANDFRAME_H_
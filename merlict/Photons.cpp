@@ -17,10 +17,40 @@ void propagate_photons_in_frame_with_config(
     env.config = settings;
     env.prng = prng;
 
+    if (settings->propagate_bunches_together) {
+        uint64_t i = 0;
+        while (i < photons->size()) {
+            std::vector<Photon*> bunch;
+            bunch.push_back(&photons->at(i));
+            i++;
+            while (
+                i < photons->size() &&
+                start_the_same(photons->at(i), *bunch.front())
+            ) {
+                bunch.push_back(&photons->at(i));
+                i++;
+            }
+            BunchPropagator(bunch, env);
+        }
+        return;
+    }
+
     for (unsigned int i = 0; i < photons->size(); i++)
         Propagator(&photons->at(i), env);
 }
 
+bool start_the_same(const Photon &a, const Photon &b) {
+    return
+        a.num_interactions() == b.num_interactions() &&
+        a.wavelength == b.wavelength &&
+        a.support().x == b.support().x &&
+        a.support().y == b.support().y &&
+        a.support().z == b.support().z &&
+        a.direction().x == b.direction().x &&
+        a.direction().y == b.direction().y &&
+        a.direction().z == b.direction().z;
+}
+
 std::vector<Photon> raw_matrix2photons(
     std::vector<std::vector<double>> raw_matrix
 ) {
@@ -15,6 +15,9 @@ void propagate_photons_in_frame_with_config(
     const PropagationConfig *settings,
     random::Generator* prng);
 
+// Exactly, not within the tolerance of Vec3::operator==.
+bool start_the_same(const Photon &a, const Photon &b);
+
 std::vector<Photon> raw_matrix2photons(
     std::vector<std::vector<double>> raw_matrix);
 
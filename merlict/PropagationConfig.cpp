@@ -5,6 +5,7 @@ namespace merlict {
 
 PropagationConfig::PropagationConfig() {
     max_num_interactions_per_photon = 5;
+    propagate_bunches_together = false;
 }
 
 }  // namespace merlict
@@ -9,6 +9,11 @@ namespace merlict {
 
 struct PropagationConfig {
     unsigned int max_num_interactions_per_photon;
+    // Consecutive photons with the same support, direction and wavelength
+    // are traced together, see BunchPropagator. The photons end up just as
+    // likely in the same places, but the random numbers are drawn in a
+    // different order.
+    bool propagate_bunches_together;
     PropagationConfig();
 };
 
@@ -25,28 +25,6 @@ std::string Ray::str()const {
     return out.str();
 }
 
-Vec3 Ray::position_at(const double scalar)const {
-    return support_ + direction_*scalar;
-}
-
-Vec3 Ray::support()const {
-    return support_;
-}
-
-Vec3 Ray::direction()const {
-    return direction_;
-}
-
-void Ray::transform(const HomTra3 *T) {
-    support_ = T->position(support_);
-    direction_ = T->orientation(direction_);
-}
-
-void Ray::transform_inverse(const HomTra3 *T) {
-    support_ = T->position_inverse(support_);
-    direction_ = T->orientation_inverse(direction_);
-}
-
 double Ray::parameter_for_closest_distance_to_point(const Vec3 &point)const {
     // We create a plane orthogonal to this ray and containing the point
     // plane equation:
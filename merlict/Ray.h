@@ -17,16 +17,43 @@ class Ray {
  public:
     Ray(const Vec3 support, const Vec3 direction);
     void set_support_and_direction(const Vec3 nsup, const Vec3 ndir);
-    Vec3 support()const;
-    Vec3 direction()const;
-    Vec3 position_at(const double scalar)const;
-    void transform(const HomTra3 *T);
-    void transform_inverse(const HomTra3 *T);
+    Vec3 support()const noexcept;
+    Vec3 direction()const noexcept;
+    Vec3 position_at(const double scalar)const noexcept;
+    void transform(const HomTra3 *T) noexcept;
+    void transform_inverse(const HomTra3 *T) noexcept;
+    void translate(const Vec3 &shift) noexcept;
     std::string str()const;
     double parameter_for_closest_distance_to_point(const Vec3 &point)const;
     double closest_distance_to_point(const Vec3 &point)const;
 };
 
+inline Vec3 Ray::support()const noexcept {
+    return support_;
+}
+
+inline Vec3 Ray::direction()const noexcept {
+    return direction_;
+}
+
+inline Vec3 Ray::position_at(const double scalar)const noexcept {
+    return support_ + direction_*scalar;
+}
+
+inline void Ray::transform(const HomTra3 *T) noexcept {
+    support_ = T->position(support_);
+    direction_ = T->orientation(direction_);
+}
+
+inline void Ray::transform_inverse(const HomTra3 *T) noexcept {
+    support_ = T->position_inverse(support_);
+    direction_ = T->orientation_inverse(direction_);
+}
+
+inline void Ray::translate(const Vec3 &shift) noexcept {
+    support_ = support_ + shift;
+}
+
 }  // namespace merlict
 
 #endif  // MERLICT_RAY_H_
@@ -1,10 +1,17 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict/RayAndFrame.h"
+#include <math.h>
 #include <algorithm>
 
 
 namespace merlict {
 
+namespace {
+
+const float FLOAT_CULLING_RELATIVE_MARGIN = 1e-5f;
+
+}  // namespace
+
 bool ray_support_inside_frames_bounding_sphere(
     const Ray* ray,
     const Frame *frame
@@ -13,7 +20,8 @@ bool ray_support_inside_frames_bounding_sphere(
         norm_is_less_equal_than(frame->get_bounding_sphere_radius());
 }
 
-bool ray_intersects_frames_bounding_sphere(
+template<>
+bool ray_intersects_frames_bounding_sphere<double>(
     const Ray* ray,
     const Frame *frame
 ) {
@@ -106,24 +114,58 @@ bool ray_intersects_frames_bounding_sphere(
     }
 }
 
-Ray ray_with_respect_to_frame(
+template<>
+bool ray_intersects_frames_bounding_sphere<float>(
     const Ray* ray,
-    const Frame* frame
+    const Frame *frame
 ) {
-    Ray ray_in_object_system_of_frame = *ray;
-    ray_in_object_system_of_frame.transform_inverse(frame->frame2world());
-    return ray_in_object_system_of_frame;
+    // The same test as in double. Rounding to float moves each coordinate
+    // by half an ulp of the largest magnitude involved, and the few
+    // operations below add a few more. The margin covers many times this.
+    const Vec3 support = ray->support();
+    const Vec3 direction = ray->direction();
+    const Vec3 center = frame->position_in_world();
+    const float sx = support.x, sy = support.y, sz = support.z;
+    const float dx = direction.x, dy = direction.y, dz = direction.z;
+    const float cx = static_cast<float>(center.x) - sx;
+    const float cy = static_cast<float>(center.y) - sy;
+    const float cz = static_cast<float>(center.z) - sz;
+    const float scale =
+        fabsf(sx) + fabsf(sy) + fabsf(sz) +
+        fabsf(cx) + fabsf(cy) + fabsf(cz);
+    const float radius = static_cast<float>(
+        frame->get_bounding_sphere_radius()) +
+        FLOAT_CULLING_RELATIVE_MARGIN*scale;
+
+    const float alpha = cx*dx + cy*dy + cz*dz;
+    const float qx = cx - alpha*dx;
+    const float qy = cy - alpha*dy;
+    const float qz = cz - alpha*dz;
+    if (qx*qx + qy*qy + qz*qz > radius*radius)
+        return false;
+    if (alpha < 0.0f)
+        return cx*cx + cy*cy + cz*cz <= radius*radius;
+    return true;
 }
 
+template<class Real>
 Intersection rays_first_intersection_with_frame(
     const Ray* ray,
     const Frame* frame
 ) {
-    CausalIntersection intersect_calculator(ray, frame);
+    CausalIntersection<Real> intersect_calculator(ray, frame);
     return intersect_calculator.closest_intersection;
 }
 
-CausalIntersection::CausalIntersection(
+template Intersection rays_first_intersection_with_frame<double>(
+    const Ray* ray,
+    const Frame* frame);
+template Intersection rays_first_intersection_with_frame<float>(
+    const Ray* ray,
+    const Frame* frame);
+
+template<class Real>
+CausalIntersection<Real>::CausalIntersection(
     const Ray* _ray,
     const Frame* frame
 ): ray(_ray) {
@@ -134,21 +176,38 @@ CausalIntersection::CausalIntersection(
     calculate_closest_intersection();
 }
 
-void CausalIntersection::find_intersection_candidates_in_tree_of_frames(
+template<class Real>
+void CausalIntersection<Real>::find_intersection_candidates_in_tree_of_frames(
     const Frame* frame
 ) {
-    if (ray_intersects_frames_bounding_sphere(ray, frame)) {
+    if (ray_intersects_frames_bounding_sphere<Real>(ray, frame)) {
         if (frame->has_children()) {
-            for (unsigned int i = 0; i < frame->get_children()->size(); i++)
-                find_intersection_candidates_in_tree_of_frames(
-                    frame->get_children()->at(i));
+            // indexed_frames is used as a stack. Nested indexed frames append
+            // behind our range and shrink it back before returning.
+            const uint64_t begin = indexed_frames.size();
+            if (frame->find_intersection_candidates(ray, &indexed_frames)) {
+                const uint64_t end = indexed_frames.size();
+                for (uint64_t i = begin; i < end; i++) {
+                    if (indexed_frames[i] == frame)
+                        candidate_objects.push_back(frame);
+                    else
+                        find_intersection_candidates_in_tree_of_frames(
+                            indexed_frames[i]);
+                }
+                indexed_frames.resize(begin);
+            } else {
+                for (unsigned int i = 0; i < frame->get_children()->size(); i++)
+                    find_intersection_candidates_in_tree_of_frames(
+                        frame->get_children()->at(i));
+            }
         } else {
             candidate_objects.push_back(frame);
         }
     }
 }
 
-void CausalIntersection::find_intersections_in_candidate_objects() {
+template<class Real>
+void CausalIntersection<Real>::find_intersections_in_candidate_objects() {
     for (const Frame* object : candidate_objects) {
         Ray ray_in_object_system = ray_with_respect_to_frame(ray, object);
         object->calculate_intersection_with(
@@ -157,7 +216,8 @@ void CausalIntersection::find_intersections_in_candidate_objects() {
     }
 }
 
-void CausalIntersection::calculate_closest_intersection() {
+template<class Real>
+void CausalIntersection<Real>::calculate_closest_intersection() {
     if (candidate_intersections.size() == 0)
         closest_intersection = Intersection(
             &VOID_SURFACE_ENTITY,
@@ -172,4 +232,7 @@ void CausalIntersection::calculate_closest_intersection() {
             Intersection::compare);
 }
 
+template struct CausalIntersection<double>;
+template struct CausalIntersection<float>;
+
 }  // namespace merlict
@@ -14,29 +14,65 @@ bool ray_support_inside_frames_bounding_sphere(
     const Ray* ray,
     const Frame *frame);
 
+// The frames are culled with their bounding spheres in the floating point
+// type Real. In float, the spheres are widened so that no frame is culled
+// which is intersected in double. The candidate objects are intersected in
+// double in any case.
+template<class Real = double>
 bool ray_intersects_frames_bounding_sphere(
     const Ray* ray,
     const Frame* frame);
-
-Ray ray_with_respect_to_frame(
+template<>
+bool ray_intersects_frames_bounding_sphere<double>(
+    const Ray* ray,
+    const Frame* frame);
+template<>
+bool ray_intersects_frames_bounding_sphere<float>(
     const Ray* ray,
     const Frame* frame);
 
+// Uses the frame's cached world2frame, and skips the rotation when the
+// frame is only translated. The result is the same as of
+// transform_inverse(frame->frame2world()).
+inline Ray ray_with_respect_to_frame(
+    const Ray* ray,
+    const Frame* frame
+) {
+    Ray ray_in_object_system_of_frame = *ray;
+    if (frame->world2frame_is_only_translation())
+        ray_in_object_system_of_frame.translate(
+            frame->world2frame()->translation());
+    else
+        ray_in_object_system_of_frame.transform(frame->world2frame());
+    return ray_in_object_system_of_frame;
+}
+
+template<class Real = double>
 Intersection rays_first_intersection_with_frame(
     const Ray* ray,
     const Frame* frame);
+extern template Intersection rays_first_intersection_with_frame<double>(
+    const Ray* ray,
+    const Frame* frame);
+extern template Intersection rays_first_intersection_with_frame<float>(
+    const Ray* ray,
+    const Frame* frame);
 
+template<class Real = double>
 struct CausalIntersection {
     const Ray* ray;
     std::vector<const Frame*> candidate_objects;
     std::vector<Intersection> candidate_intersections;
     Intersection closest_intersection;
+    std::vector<const Frame*> indexed_frames;
     CausalIntersection(const Ray* _ray, const Frame* frame);
  private:
     void find_intersection_candidates_in_tree_of_frames(const Frame* frame);
     void find_intersections_in_candidate_objects();
     void calculate_closest_intersection();
 };
+extern template struct CausalIntersection<double>;
+extern template struct CausalIntersection<float>;
 
 }  // namespace merlict
 
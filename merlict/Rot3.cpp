@@ -7,10 +7,6 @@ namespace merlict {
 
 Rot3::Rot3() {}
 
-Rot3::Rot3(double rot_x, double rot_y, double rot_z) {
-    set(rot_x, rot_y, rot_z);
-}
-
 void Rot3::set(double rot_x, double rot_y, double rot_z) {
     _uses_xyz_angels = true;
     Rx = rot_x;
@@ -52,10 +48,6 @@ double Rot3::rot_angle()const {
     }
 }
 
-bool Rot3::uses_xyz_angels()const {
-    return _uses_xyz_angels;
-}
-
 std::string Rot3::str()const {
     std::stringstream out;
     if (_uses_xyz_angels == true) {
@@ -67,12 +59,6 @@ std::string Rot3::str()const {
     return out.str();
 }
 
-double Rot3::rot_x()const {return Rx;}
-
-double Rot3::rot_y()const {return Ry;}
-
-double Rot3::rot_z()const {return Rz;}
-
 bool Rot3::operator == (const Rot3& eqRot)const {
     return Rx == eqRot.Rx && Ry == eqRot.Ry && Rz == eqRot.Rz;
 }
@@ -18,21 +18,39 @@ class Rot3 {
 
  public:
     Rot3();
-    Rot3(double rot_x, double rot_y, double rot_z);
+    constexpr Rot3(double rot_x, double rot_y, double rot_z) noexcept;
     Rot3(const Vec3 rot_axis, const double rot_angle);
     void set(double rot_x, double rot_y, double rot_z);
     void set(const Vec3 rot_axis, const double rot_angle);
     Vec3 rot_axis()const;
     double rot_angle()const;
-    bool uses_xyz_angels()const;
+    constexpr bool uses_xyz_angels()const noexcept;
     std::string str()const;
-    double rot_x()const;
-    double rot_y()const;
-    double rot_z()const;
+    constexpr double rot_x()const noexcept;
+    constexpr double rot_y()const noexcept;
+    constexpr double rot_z()const noexcept;
     bool operator == (const Rot3& eqRot)const;
 };
 
-const Rot3 ROT3_UNITY = Rot3(0., 0., 0.);
+constexpr Rot3::Rot3(double rot_x, double rot_y, double rot_z) noexcept:
+    Rx(rot_x),
+    Ry(rot_y),
+    Rz(rot_z),
+    _rot_angle(0.0),
+    _rot_axis(0.0, 0.0, 0.0),
+    _uses_xyz_angels(true) {}
+
+constexpr bool Rot3::uses_xyz_angels()const noexcept {
+    return _uses_xyz_angels;
+}
+
+constexpr double Rot3::rot_x()const noexcept {return Rx;}
+
+constexpr double Rot3::rot_y()const noexcept {return Ry;}
+
+constexpr double Rot3::rot_z()const noexcept {return Rz;}
+
+constexpr Rot3 ROT3_UNITY = Rot3(0., 0., 0.);
 
 }  // namespace merlict
 
@@ -50,6 +50,8 @@ void SurfaceEntity::init_surface_defaults() {
 
     outer_absorption = DEFAULT_ABSORPTION;
     inner_absorption = DEFAULT_ABSORPTION;
+
+    surface_table = nullptr;
 }
 
 void SurfaceEntity::set_allowed_frames_to_propagate_to(const Frame* frame) {
@@ -84,6 +86,7 @@ void SurfaceEntity::adopt_surface(
     inner_refraction = proto->inner_refraction;
     outer_absorption = proto->outer_absorption;
     inner_absorption = proto->inner_absorption;
+    surface_table = proto->surface_table;
 }
 
 void SurfaceEntity::adopt_surface_inside_out(
@@ -97,6 +100,7 @@ void SurfaceEntity::adopt_surface_inside_out(
     inner_refraction = proto->outer_refraction;
     outer_absorption = proto->inner_absorption;
     inner_absorption = proto->outer_absorption;
+    surface_table = nullptr;
 }
 
 std::string SurfaceEntity::str()const {
@@ -6,6 +6,7 @@
 #include "merlict/Frame.h"
 #include "Color.h"
 #include "merlict/function/function.h"
+#include "merlict/SurfaceTable.h"
 
 namespace merlict {
 
@@ -26,6 +27,10 @@ class SurfaceEntity :public Frame {
     const function::Func1* inner_refraction;
     const function::Func1* outer_absorption;
     const function::Func1* inner_absorption;
+    // The functions above sampled on the function::WAVELENGTH_GRID, or
+    // nullptr when they are evaluated directly. Wavelengths outside of the
+    // grid are always evaluated directly.
+    const SurfaceTable* surface_table;
 
     void set_allowed_frames_to_propagate_to(const Frame* frame);
     void adopt_surface(const SurfaceEntity* proto);
@@ -34,6 +39,13 @@ class SurfaceEntity :public Frame {
     bool boundary_layer_is_transparent()const;
     bool has_restrictions_on_frames_to_propagate_to()const;
     std::string str()const;
+    // Evaluates the property in the surface_table, or func when there is
+    // no table or the wavelength is outside of the grid. func has to be
+    // the function the property is sampled from.
+    double evaluate(
+        double SurfaceTable::Node::*property,
+        const function::Func1* func,
+        const double wavelength)const;
     static const function::Func1* DEFAULT_REFLECTION;
     static const function::Func1* DEFAULT_REFRACTION;
     static const function::Func1* DEFAULT_ABSORPTION;
@@ -42,6 +54,19 @@ class SurfaceEntity :public Frame {
     void init_surface_defaults();
 };
 
+inline double SurfaceEntity::evaluate(
+    double SurfaceTable::Node::*property,
+    const function::Func1* func,
+    const double wavelength
+)const {
+    if (
+        surface_table != nullptr &&
+        function::WAVELENGTH_GRID.contains(wavelength)
+    )
+        return surface_table->evaluate(wavelength, property);
+    return func->evaluate(wavelength);
+}
+
 const SurfaceEntity SURFACE_PHOTON_SOURCE;
 extern const SurfaceEntity VOID_SURFACE_ENTITY;
 
@@ -0,0 +1,56 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/SurfaceTable.h"
+#include "merlict/SurfaceEntity.h"
+
+namespace merlict {
+
+bool SurfaceTable::can_sample(const SurfaceEntity* surface) {
+    const function::UniformGrid &grid = function::WAVELENGTH_GRID;
+    return
+        grid.is_covered_by(*surface->outer_reflection) &&
+        grid.is_covered_by(*surface->inner_reflection) &&
+        grid.is_covered_by(*surface->outer_refraction) &&
+        grid.is_covered_by(*surface->inner_refraction) &&
+        grid.is_covered_by(*surface->outer_absorption) &&
+        grid.is_covered_by(*surface->inner_absorption);
+}
+
+SurfaceTable::SurfaceTable(const SurfaceEntity* surface) {
+    const function::UniformGrid &grid = function::WAVELENGTH_GRID;
+    const std::vector<double> outer_reflection =
+        grid.sample(*surface->outer_reflection);
+    const std::vector<double> inner_reflection =
+        grid.sample(*surface->inner_reflection);
+    const std::vector<double> outer_refraction =
+        grid.sample(*surface->outer_refraction);
+    const std::vector<double> inner_refraction =
+        grid.sample(*surface->inner_refraction);
+    const std::vector<double> outer_absorption =
+        grid.sample(*surface->outer_absorption);
+    const std::vector<double> inner_absorption =
+        grid.sample(*surface->inner_absorption);
+
+    nodes.resize(grid.num_nodes());
+    for (uint32_t i = 0; i < grid.num_nodes(); i++) {
+        nodes[i].outer_reflection = outer_reflection[i];
+        nodes[i].inner_reflection = inner_reflection[i];
+        nodes[i].outer_refraction = outer_refraction[i];
+        nodes[i].inner_refraction = inner_refraction[i];
+        nodes[i].outer_absorption = outer_absorption[i];
+        nodes[i].inner_absorption = inner_absorption[i];
+    }
+}
+
+double SurfaceTable::evaluate(
+    const double wavelength,
+    double Node::*property
+)const {
+    double weight;
+    const uint32_t i = function::WAVELENGTH_GRID.bin(wavelength, &weight);
+    return function::UniformGrid::interpolate(
+        nodes[i].*property,
+        nodes[i + 1].*property,
+        weight);
+}
+
+}  // namespace merlict
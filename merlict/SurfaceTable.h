@@ -0,0 +1,35 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef MERLICT_SURFACETABLE_H_
+#define MERLICT_SURFACETABLE_H_
+
+#include <vector>
+#include "merlict/function/function.h"
+
+namespace merlict {
+
+class SurfaceEntity;
+
+struct SurfaceTable {
+    // The functions of a surface sampled on the nodes of the
+    // function::WAVELENGTH_GRID. All the properties of a node are next to
+    // each other, so the two nodes of a wavelength's bin serve all the
+    // lookups of an interaction.
+    struct Node {
+        double outer_reflection;
+        double inner_reflection;
+        double outer_refraction;
+        double inner_refraction;
+        double outer_absorption;
+        double inner_absorption;
+    };
+    std::vector<Node> nodes;
+    explicit SurfaceTable(const SurfaceEntity* surface);
+    static bool can_sample(const SurfaceEntity* surface);
+    double evaluate(
+        const double wavelength,
+        double Node::*property)const;
+};
+
+}  // namespace merlict
+
+#endif  // MERLICT_SURFACETABLE_H_
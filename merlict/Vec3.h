@@ -2,47 +2,171 @@
 #ifndef MERLICT_VEC3_H_
 #define MERLICT_VEC3_H_
 
+#include <math.h>
 #include <string>
 
 namespace merlict {
 
+// The arithmetic is defined inline here, so that it can be inlined into the
+// ray tracing loops of all translation units.
 struct Vec3 {
     double x;
     double y;
     double z;
 
-    Vec3();
-    Vec3(const double x, const double y, const double z);
-    void set(const double x, const double y, const double z);
-    unsigned int octant()const;
-    Vec3 project_in_x_z_plane()const;
-    Vec3 project_in_y_z_plane()const;
-    Vec3 project_in_x_y_plane()const;
-    double norm()const;
-    void normalize();
-    Vec3 cross(const Vec3 v)const;
-    void mirror(Vec3* ray)const;
+    Vec3() = default;
+    constexpr Vec3(const double x, const double y, const double z) noexcept;
+    constexpr void set(const double x, const double y, const double z) noexcept;
+    constexpr unsigned int octant()const noexcept;
+    constexpr Vec3 project_in_x_z_plane()const noexcept;
+    constexpr Vec3 project_in_y_z_plane()const noexcept;
+    constexpr Vec3 project_in_x_y_plane()const noexcept;
+    double norm()const noexcept;
+    void normalize() noexcept;
+    constexpr Vec3 cross(const Vec3 v)const noexcept;
+    constexpr void mirror(Vec3* ray)const noexcept;
     double angle_in_between(const Vec3& vec)const;
-    double operator*(const Vec3 v)const;
-    Vec3 operator*(const double scalar)const;
-    Vec3 operator-(const Vec3 v)const;
-    Vec3 operator+(const Vec3 v)const;
-    Vec3 operator/(const double scalar)const;
-    bool operator == (const Vec3& eqVec)const;
-    bool operator != (const Vec3& eqVec)const;
-    double distance_to(const Vec3 &v)const;
-    double squared_distance_to(const Vec3 &v)const;
-    bool is_paralell_to_z_axis()const;
-    bool is_parallel_to_x_y_plane()const;
-    bool norm_is_less_equal_than(const double length_to_compare)const;
+    constexpr double operator*(const Vec3 v)const noexcept;
+    constexpr Vec3 operator*(const double scalar)const noexcept;
+    constexpr Vec3 operator-(const Vec3 v)const noexcept;
+    constexpr Vec3 operator+(const Vec3 v)const noexcept;
+    constexpr Vec3 operator/(const double scalar)const noexcept;
+    constexpr bool operator == (const Vec3& eqVec)const noexcept;
+    constexpr bool operator != (const Vec3& eqVec)const noexcept;
+    double distance_to(const Vec3 &v)const noexcept;
+    constexpr double squared_distance_to(const Vec3 &v)const noexcept;
+    constexpr bool is_paralell_to_z_axis()const noexcept;
+    constexpr bool is_parallel_to_x_y_plane()const noexcept;
+    constexpr bool norm_is_less_equal_than(
+        const double length_to_compare)const noexcept;
     std::string str()const;
 };
 
-const Vec3 VEC3_ORIGIN = Vec3(0., 0., 0.);
-const Vec3 VEC3_UNIT_X = Vec3(1., 0., 0.);
-const Vec3 VEC3_UNIT_Y = Vec3(0., 1., 0.);
-const Vec3 VEC3_UNIT_Z = Vec3(0., 0., 1.);
-const double MAX_DEVIATION_EQUAL_VEC3_SQUARE = 1e-14;
+constexpr double MAX_DEVIATION_EQUAL_VEC3_SQUARE = 1e-14;
+
+constexpr Vec3::Vec3(const double _x, const double _y, const double _z)
+    noexcept: x(_x), y(_y), z(_z) {}
+
+constexpr void Vec3::set(
+    const double _x,
+    const double _y,
+    const double _z
+) noexcept {
+    x = _x;
+    y = _y;
+    z = _z;
+}
+
+inline double Vec3::norm()const noexcept {
+    return sqrt(x*x + y*y + z*z);
+}
+
+inline void Vec3::normalize() noexcept {
+    *this = *this/this->norm();
+}
+
+constexpr Vec3 Vec3::cross(const Vec3 v)const noexcept {
+    return Vec3(y*v.z-z*v.y, z*v.x-x*v.z, x*v.y-y*v.x);
+}
+
+constexpr double Vec3::operator*(const Vec3 v)const noexcept {
+    return v.x*x + v.y*y + v.z*z;
+}
+
+constexpr Vec3 Vec3::operator*(const double scalar)const noexcept {
+    return Vec3(x*scalar, y*scalar, z*scalar);
+}
+
+constexpr Vec3 Vec3::operator-(const Vec3 v)const noexcept {
+    return Vec3(x-v.x, y-v.y, z-v.z);
+}
+
+constexpr Vec3 Vec3::operator+(const Vec3 v)const noexcept {
+    return Vec3(x+v.x, y+v.y, z+v.z);
+}
+
+constexpr Vec3 Vec3::operator/(const double scalar)const noexcept {
+    return Vec3(x/scalar, y/scalar, z/scalar);
+}
+
+// Reflects the ray on the surface with this normal, see Vec3.cpp for the
+// derivation of the mirror matrix M = EYE - 2*n*n^T.
+constexpr void Vec3::mirror(Vec3* ray)const noexcept {
+    ray->set(   // X
+                (1. - 2.*x*x) * ray->x +
+                    - 2.*x*y  * ray->y +
+                    - 2.*x*z  * ray->z,
+                // Y
+                    - 2.*x*y  * ray->x +
+                (1. - 2.*y*y) * ray->y +
+                    - 2.*y*z  * ray->z,
+                // Z
+                    - 2.*x*z  * ray->x +
+                    - 2.*y*z  * ray->y +
+                (1. - 2.*z*z) * ray->z);
+}
+
+constexpr bool Vec3::operator == (const Vec3& eqVec)const noexcept {
+    return squared_distance_to(eqVec) <= MAX_DEVIATION_EQUAL_VEC3_SQUARE;
+}
+
+constexpr bool Vec3::operator != (const Vec3& eqVec)const noexcept {
+    return squared_distance_to(eqVec) > MAX_DEVIATION_EQUAL_VEC3_SQUARE;
+}
+
+constexpr double Vec3::squared_distance_to(const Vec3 &v)const noexcept {
+    return (*this - v)*(*this - v);
+}
+
+inline double Vec3::distance_to(const Vec3 &v)const noexcept {
+    return (*this - v).norm();
+}
+
+constexpr bool Vec3::is_paralell_to_z_axis()const noexcept {
+    return x == 0. && y == 0. && (z > 0. || z < 0.);
+}
+
+constexpr bool Vec3::is_parallel_to_x_y_plane()const noexcept {
+    return z == 0. && ( x != 0. || y != 0. );
+}
+
+constexpr bool Vec3::norm_is_less_equal_than(
+    const double length_to_compare
+)const noexcept {
+    // avoid the sqrt for speed up
+    return (*this)*(*this) <= length_to_compare*length_to_compare;
+}
+
+// encodes the octant sectors where the vector is pointing to
+// x y z sector
+// - - -   0
+// - - +   1
+// - + -   2
+// - + +   3
+// + - -   4
+// + - +   5
+// + + -   6
+// + + +   7
+constexpr unsigned int Vec3::octant()const noexcept {
+    return 4*(x >= 0.) + 2*(y >= 0.) + 1*(z >= 0.);
+}
+
+constexpr Vec3 Vec3::project_in_x_z_plane()const noexcept {
+    return Vec3(x, 0., z);
+}
+
+constexpr Vec3 Vec3::project_in_y_z_plane()const noexcept {
+    return Vec3(0., y, z);
+}
+
+constexpr Vec3 Vec3::project_in_x_y_plane()const noexcept {
+    return Vec3(x, y, 0.);
+}
+
+constexpr Vec3 VEC3_ORIGIN = Vec3(0., 0., 0.);
+constexpr Vec3 VEC3_UNIT_X = Vec3(1., 0., 0.);
+constexpr Vec3 VEC3_UNIT_Y = Vec3(0., 1., 0.);
+constexpr Vec3 VEC3_UNIT_Z = Vec3(0., 0., 1.);
 
 }  // namespace merlict
 
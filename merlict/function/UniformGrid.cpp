@@ -0,0 +1,89 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/function/UniformGrid.h"
+#include <sstream>
+
+namespace merlict {
+namespace function {
+
+const UniformGrid WAVELENGTH_GRID(200e-9, 1200e-9, 1000u);
+
+UniformGrid::UniformGrid(
+    const double lower,
+    const double upper,
+    const uint32_t _num_bins
+): limits(lower, upper), num_bins(_num_bins) {
+    if (num_bins == 0u || !(upper > lower)) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "UniformGrid: Expected at least one bin and ";
+        info << "lower < upper, but actual num_bins = " << num_bins;
+        info << ", limits = " << limits.str() << ".\n";
+        throw std::invalid_argument(info.str());
+    }
+    bin_width = limits.range()/num_bins;
+    one_over_bin_width = num_bins/limits.range();
+}
+
+uint32_t UniformGrid::num_nodes()const {
+    return num_bins + 1u;
+}
+
+double UniformGrid::node(const uint32_t i)const {
+    if (i == num_bins)
+        return limits.upper;
+    return limits.lower + i*bin_width;
+}
+
+bool UniformGrid::is_covered_by(const Func1 &f)const {
+    return f.limits.lower <= limits.lower && f.limits.upper >= limits.upper;
+}
+
+bool UniformGrid::contains(const double x)const {
+    return x >= limits.lower && x < limits.upper;
+}
+
+std::vector<double> UniformGrid::sample(const Func1 &f)const {
+    if (!is_covered_by(f)) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "UniformGrid: Expected function to cover the grid ";
+        info << limits.str() << ", but actual its limits are ";
+        info << f.limits.str() << ".\n";
+        throw std::out_of_range(info.str());
+    }
+    std::vector<double> values;
+    values.reserve(num_nodes());
+    for (uint32_t i = 0; i < num_nodes(); i++) {
+        const double x = node(i);
+        // The limits exclude the upper end, where the function is its last
+        // point.
+        if (x < f.limits.upper)
+            values.push_back(f.evaluate(x));
+        else
+            values.push_back(f.func.back().y);
+    }
+    return values;
+}
+
+uint32_t UniformGrid::bin(const double x, double* weight)const {
+    limits.assert_contains(x);
+    uint32_t i = static_cast<uint32_t>((x - limits.lower)*one_over_bin_width);
+    if (i >= num_bins)
+        i = num_bins - 1u;
+    *weight = (x - node(i))*one_over_bin_width;
+    return i;
+}
+
+double UniformGrid::interpolate(
+    const double lower_node,
+    const double upper_node,
+    const double weight
+) {
+    // Keeps constant functions exact, also when they are infinite.
+    if (lower_node == upper_node)
+        return lower_node;
+    return lower_node + (upper_node - lower_node)*weight;
+}
+
+}  // namespace function
+}  // namespace merlict
@@ -0,0 +1,47 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef MERLICT_FUNCTION_UNIFORMGRID_H_
+#define MERLICT_FUNCTION_UNIFORMGRID_H_
+
+#include <stdint.h>
+#include <vector>
+#include "Limits.h"
+#include "Func1.h"
+
+namespace merlict {
+namespace function {
+
+struct UniformGrid {
+    // Bins of equal width in between the limits. The nodes are the edges of
+    // the bins, so there is one node more than there are bins.
+    // A function sampled on the nodes is evaluated with index arithmetic
+    // instead of a search for its upper bound.
+    Limits limits;
+    uint32_t num_bins;
+    double bin_width;
+    double one_over_bin_width;
+    UniformGrid(
+        const double lower,
+        const double upper,
+        const uint32_t num_bins);
+    uint32_t num_nodes()const;
+    double node(const uint32_t i)const;
+    bool is_covered_by(const Func1 &f)const;
+    bool contains(const double x)const;
+    std::vector<double> sample(const Func1 &f)const;
+    // Returns the bin of x and the relative position of x in the bin.
+    // Throws std::out_of_range just like Func1::evaluate().
+    uint32_t bin(const double x, double* weight)const;
+    static double interpolate(
+        const double lower_node,
+        const double upper_node,
+        const double weight);
+};
+
+// Covers the wavelengths of the default functions of the surfaces in steps
+// of 1nm.
+extern const UniformGrid WAVELENGTH_GRID;
+
+}  // namespace function
+}  // namespace merlict
+
+#endif  // MERLICT_FUNCTION_UNIFORMGRID_H_
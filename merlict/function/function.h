@@ -5,5 +5,6 @@
 #include "Limits.h"
 #include "Func1.h"
 #include "tools.h"
+#include "UniformGrid.h"
 
 #endif  // MERLICT_FUNCTION_FUNCTION_H_
@@ -27,6 +27,7 @@
 #include "numeric.h"
 #include "txt.h"
 #include "binio.h"
+#include "MemoryMap.h"
 #include "tools.h"
 #include "ospath.h"
 #include "tsvio.h"
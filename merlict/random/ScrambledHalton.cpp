@@ -0,0 +1,97 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/random/ScrambledHalton.h"
+#include <math.h>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace merlict {
+namespace random {
+
+namespace {
+const uint32_t PRIMES[MAX_HALTON_DIMENSIONS] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+}  // namespace
+
+ScrambledHalton::ScrambledHalton(
+    const uint32_t num_dimensions,
+    const uint64_t seed
+): num_dimensions_(num_dimensions) {
+    if (num_dimensions > MAX_HALTON_DIMENSIONS) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "ScrambledHalton: Expected num_dimensions <= ";
+        info << MAX_HALTON_DIMENSIONS << ", but actual ";
+        info << num_dimensions << ".\n";
+        throw std::invalid_argument(info.str());
+    }
+    Mt19937 prng(seed);
+    num_digits.resize(num_dimensions);
+    permutations.resize(num_dimensions);
+    for (uint32_t d = 0; d < num_dimensions; d++) {
+        const uint32_t base = PRIMES[d];
+        // base^num_digits <= 2^52 keeps all samples below 1.0
+        num_digits[d] = static_cast<uint32_t>(floor(52.0/log2(base)));
+        permutations[d].resize(num_digits[d]*base);
+        for (uint32_t k = 0; k < num_digits[d]; k++) {
+            uint8_t* perm = &permutations[d][k*base];
+            for (uint32_t i = 0; i < base; i++)
+                perm[i] = static_cast<uint8_t>(i);
+            for (uint32_t i = base - 1; i > 0; i--) {
+                const uint32_t j = prng.create_seed()%(i + 1);
+                std::swap(perm[i], perm[j]);
+            }
+        }
+    }
+}
+
+double ScrambledHalton::sample(
+    uint64_t index,
+    const uint32_t dimension
+)const {
+    const uint32_t base = PRIMES[dimension];
+    const uint8_t* perm = permutations[dimension].data();
+    const double inv_base = 1.0/base;
+    double factor = inv_base;
+    double value = 0.0;
+    for (uint32_t k = 0; k < num_digits[dimension]; k++) {
+        const uint64_t digit = index%base;
+        index /= base;
+        value += perm[k*base + digit]*factor;
+        factor *= inv_base;
+    }
+    return value;
+}
+
+uint32_t ScrambledHalton::num_dimensions()const {
+    return num_dimensions_;
+}
+
+QuasiRandom::QuasiRandom(
+    const ScrambledHalton* _sequence,
+    const uint64_t _index,
+    const uint64_t padding_seed
+):
+    sequence(_sequence),
+    index(_index),
+    dimension(0u),
+    padding(padding_seed) {
+    this->seed_ = padding_seed;
+}
+
+double QuasiRandom::uniform() {
+    if (dimension < sequence->num_dimensions())
+        return sequence->sample(index, dimension++);
+    return padding.uniform();
+}
+
+uint64_t QuasiRandom::create_seed() {
+    return padding.create_seed();
+}
+
+double QuasiRandom::normal(const double mean, const double std_dev) {
+    return padding.normal(mean, std_dev);
+}
+
+}  // namespace random
+}  // namespace merlict
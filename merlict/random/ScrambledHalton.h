@@ -0,0 +1,55 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef MERLICT_RANDOM_SCRAMBLEDHALTON_H_
+#define MERLICT_RANDOM_SCRAMBLEDHALTON_H_
+
+#include <stdint.h>
+#include <vector>
+#include "Generator.h"
+#include "Mt19937.h"
+
+namespace merlict {
+namespace random {
+
+// A low discrepancy sequence in up to MAX_HALTON_DIMENSIONS dimensions.
+// Dimension d is the radical inverse of the index in the d-th prime base.
+// Random digit permutation scrambling: each digit position of each
+// dimension has its own random permutation of the digits, drawn once from
+// the seed. The permutation does not depend on the leading digits, so this
+// is not Owen's nested scrambling. The sample of an index does not depend
+// on any other index.
+class ScrambledHalton {
+    uint32_t num_dimensions_;
+    std::vector<uint32_t> num_digits;
+    std::vector<std::vector<uint8_t>> permutations;
+
+ public:
+    ScrambledHalton(const uint32_t num_dimensions, const uint64_t seed);
+    double sample(uint64_t index, const uint32_t dimension)const;
+    uint32_t num_dimensions()const;
+};
+
+const uint32_t MAX_HALTON_DIMENSIONS = 16u;
+
+// Draws the first num_dimensions uniform numbers of the point with index
+// from a ScrambledHalton sequence, and all further numbers from a Mt19937
+// seeded with padding_seed.
+class QuasiRandom : public Generator {
+    const ScrambledHalton* sequence;
+    uint64_t index;
+    uint32_t dimension;
+    Mt19937 padding;
+
+ public:
+    QuasiRandom(
+        const ScrambledHalton* _sequence,
+        const uint64_t _index,
+        const uint64_t padding_seed);
+    double uniform();
+    uint64_t create_seed();
+    double normal(const double mean, const double std_dev);
+};
+
+}  // namespace random
+}  // namespace merlict
+
+#endif  // MERLICT_RANDOM_SCRAMBLEDHALTON_H_
@@ -7,6 +7,7 @@
 #include "FakeConstant.h"
 #include "SamplesFromDistribution.h"
 #include "SpherePointPicker.h"
+#include "ScrambledHalton.h"
 
 namespace merlict {
 namespace random {
@@ -5,6 +5,7 @@
 #include "ColorMap.h"
 #include "FunctionMap.h"
 #include "SensorMap.h"
+#include "SurfaceTableMap.h"
 #include "merlict/Frame.h"
 
 namespace merlict {
@@ -14,6 +15,7 @@ struct Scenery {
     ColorMap colors;
     FunctionMap functions;
     SensorMap sensors;
+    SurfaceTableMap surface_tables;
 
     std::string current_working_directory;
 
@@ -0,0 +1,36 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/scenery/SurfaceTableMap.h"
+
+namespace merlict {
+
+SurfaceTableMap::Key SurfaceTableMap::key_of(const SurfaceEntity* surface) {
+    return {
+        surface->outer_reflection,
+        surface->inner_reflection,
+        surface->outer_refraction,
+        surface->inner_refraction,
+        surface->outer_absorption,
+        surface->inner_absorption};
+}
+
+void SurfaceTableMap::assign_to_surfaces_in(Frame* frame) {
+    SurfaceEntity* surface = dynamic_cast<SurfaceEntity*>(frame);
+    if (surface != nullptr) {
+        surface->surface_table = nullptr;
+        if (SurfaceTable::can_sample(surface)) {
+            const Key key = key_of(surface);
+            std::map<Key, SurfaceTable>::iterator it = tables.find(key);
+            if (it == tables.end())
+                it = tables.emplace(key, SurfaceTable(surface)).first;
+            surface->surface_table = &it->second;
+        }
+    }
+    for (Frame* child : *frame->get_children())
+        assign_to_surfaces_in(child);
+}
+
+uint64_t SurfaceTableMap::num_tables()const {
+    return tables.size();
+}
+
+}  // namespace merlict
@@ -0,0 +1,29 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef SCENERY_SURFACETABLEMAP_H_
+#define SCENERY_SURFACETABLEMAP_H_
+
+#include <stdint.h>
+#include <array>
+#include <map>
+#include "merlict/Frame.h"
+#include "merlict/SurfaceEntity.h"
+#include "merlict/SurfaceTable.h"
+
+namespace merlict {
+
+struct SurfaceTableMap {
+    // One SurfaceTable for each combination of functions found on the
+    // surfaces, so e.g. all the lenses of a lens array share one table.
+    typedef std::array<const function::Func1*, 6> Key;
+    std::map<Key, SurfaceTable> tables;
+    // Gives each surface in the tree its table. Surfaces with functions not
+    // covering the function::WAVELENGTH_GRID keep evaluating them directly.
+    // Call this again after changing the functions of a surface.
+    void assign_to_surfaces_in(Frame* frame);
+    uint64_t num_tables()const;
+    static Key key_of(const SurfaceEntity* surface);
+};
+
+}  // namespace merlict
+
+#endif  // SCENERY_SURFACETABLEMAP_H_
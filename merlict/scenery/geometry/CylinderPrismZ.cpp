@@ -10,10 +10,6 @@ void CylinderPrismZ::set_radius(const double radius) {
     radius_square = radius*radius;
 }
 
-bool CylinderPrismZ::is_inside(const Vec3* vec)const {
-    return vec->x*vec->x + vec->y*vec->y < radius_square;
-}
-
 double CylinderPrismZ::get_radius()const {
     return sqrt(radius_square);
 }
@@ -6,7 +6,7 @@
 
 namespace merlict {
 
-class CylinderPrismZ :public PrismZ {
+class CylinderPrismZ final :public PrismZ {
  protected:
     double radius_square;
 
@@ -20,6 +20,10 @@ class CylinderPrismZ :public PrismZ {
     void assert_radius_is_positiv(const double radius)const;
 };
 
+inline bool CylinderPrismZ::is_inside(const Vec3* vec)const {
+    return vec->x*vec->x + vec->y*vec->y < radius_square;
+}
+
 }  // namespace merlict
 
 #endif  // SCENERY_GEOMETRY_CYLINDERPRISMZ_H_
@@ -63,18 +63,6 @@ EllipticalCapRayIntersectionEquation::EllipticalCapRayIntersectionEquation(
     }
 }
 
-bool EllipticalCapRayIntersectionEquation::has_solutions()const {
-    return _has_solutions;
-}
-
-double EllipticalCapRayIntersectionEquation::get_minus_solution()const {
-    return minus_solution;
-}
-
-double EllipticalCapRayIntersectionEquation::get_plus_solution()const {
-    return plus_solution;
-}
-
 Vec3 EllipticalCapRayIntersectionEquation::
     get_surface_normal_given_intersection_vector(const Vec3* intersec)const {
     // surface normal is given as  ( -dz/dx , -dz/dy , 1 )
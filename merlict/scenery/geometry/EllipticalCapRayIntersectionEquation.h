@@ -6,7 +6,7 @@
 
 namespace merlict {
 
-class EllipticalCapRayIntersectionEquation :
+class EllipticalCapRayIntersectionEquation final :
     public TwoSolutionSurfaceRayEquation {
     const double A, B, C, iAA, iBB, iCC;
     double plus_solution;
@@ -29,6 +29,18 @@ class EllipticalCapRayIntersectionEquation :
         const Vec3* intersec)const;
 };
 
+inline bool EllipticalCapRayIntersectionEquation::has_solutions()const {
+    return _has_solutions;
+}
+
+inline double EllipticalCapRayIntersectionEquation::get_minus_solution()const {
+    return minus_solution;
+}
+
+inline double EllipticalCapRayIntersectionEquation::get_plus_solution()const {
+    return plus_solution;
+}
+
 }  // namespace merlict
 
 #endif  // SCENERY_GEOMETRY_ELLIPTICALCAPRAYINTERSECTIONEQUATION_H_
@@ -41,6 +41,14 @@ std::vector<Vec3> HexGridAnnulus::get_grid()const {
     return grid;
 }
 
+Vec3 HexGridAnnulus::get_unit_a()const {
+    return unit_hex_a;
+}
+
+Vec3 HexGridAnnulus::get_unit_b()const {
+    return unit_hex_b;
+}
+
 void HexGridAnnulus::init_unit_vectors_hex_grid_with_length(
     const double spacing
 ) {
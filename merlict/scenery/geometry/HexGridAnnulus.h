@@ -22,6 +22,8 @@ class HexGridAnnulus{
         const double inner_radius,
         const double spacing);
     std::vector<Vec3> get_grid()const;
+    Vec3 get_unit_a()const;
+    Vec3 get_unit_b()const;
     std::string str()const;
 
  private:
@@ -44,6 +44,14 @@ std::vector<Vec3> HexGridFlower::get_grid()const {
     return grid;
 }
 
+Vec3 HexGridFlower::get_unit_a()const {
+    return unit_hex_a;
+}
+
+Vec3 HexGridFlower::get_unit_b()const {
+    return unit_hex_b;
+}
+
 void HexGridFlower::init_unit_vectors_hex_grid_with_length() {
     unit_hex_b = VEC3_UNIT_X*facet_spacing;
     unit_hex_a = (
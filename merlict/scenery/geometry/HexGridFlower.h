@@ -22,6 +22,8 @@ class HexGridFlower{
         unsigned int facet_count_on_outer_diameter);
     double get_facet_spacing()const;
     std::vector<Vec3> get_grid()const;
+    Vec3 get_unit_a()const;
+    Vec3 get_unit_b()const;
 
  private:
     void init_unit_vectors_hex_grid_with_length();
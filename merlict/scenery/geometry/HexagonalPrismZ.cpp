@@ -11,24 +11,6 @@ void HexagonalPrismZ::set_outer_radius(const double outer_radius) {
     this->outer_radius = outer_radius;
 }
 
-bool HexagonalPrismZ::is_inside(const Vec3* vec)const {
-    const double projection_onto_UNIT_U = VEC3_UNIT_U * *vec;
-    const double projection_onto_UNIT_V = VEC3_UNIT_V * *vec;
-    const double projection_onto_UNIT_W = VEC3_UNIT_W * *vec;
-    return (
-        projection_onto_UNIT_U < inner_radius
-        &&
-        projection_onto_UNIT_U > -inner_radius
-        &&
-        projection_onto_UNIT_V < inner_radius
-        &&
-        projection_onto_UNIT_V > -inner_radius
-        &&
-        projection_onto_UNIT_W < inner_radius
-        &&
-        projection_onto_UNIT_W > -inner_radius);
-}
-
 void HexagonalPrismZ::assert_outer_radius_positive(
     const double outer_radius
 )const {
@@ -24,7 +24,7 @@ const Vec3 VEC3_UNIT_W =
 //         \_______/                                                      //
 
 
-class HexagonalPrismZ :public PrismZ {
+class HexagonalPrismZ final :public PrismZ {
  private:
     double outer_radius;
     double inner_radius;
@@ -37,6 +37,24 @@ class HexagonalPrismZ :public PrismZ {
     void assert_outer_radius_positive(const double outer_radius)const;
 };
 
+inline bool HexagonalPrismZ::is_inside(const Vec3* vec)const {
+    const double projection_onto_UNIT_U = VEC3_UNIT_U * *vec;
+    const double projection_onto_UNIT_V = VEC3_UNIT_V * *vec;
+    const double projection_onto_UNIT_W = VEC3_UNIT_W * *vec;
+    return (
+        projection_onto_UNIT_U < inner_radius
+        &&
+        projection_onto_UNIT_U > -inner_radius
+        &&
+        projection_onto_UNIT_V < inner_radius
+        &&
+        projection_onto_UNIT_V > -inner_radius
+        &&
+        projection_onto_UNIT_W < inner_radius
+        &&
+        projection_onto_UNIT_W > -inner_radius);
+}
+
 }  // namespace merlict
 
 #endif  // SCENERY_GEOMETRY_HEXAGONALPRISMZ_H_
@@ -2,6 +2,8 @@
 #ifndef SCENERY_GEOMETRY_QUADRATICEQUATION_H_
 #define SCENERY_GEOMETRY_QUADRATICEQUATION_H_
 
+#include <math.h>
+
 namespace merlict {
 
 class QuadraticEquation{
@@ -15,12 +17,41 @@ class QuadraticEquation{
     double squareroot;
 
  public:
-    QuadraticEquation(const double _p, const double _q);
-    bool has_valid_solutions();
-    double minus_solution();
-    double plus_solution();
+    QuadraticEquation(const double _p, const double _q) noexcept;
+    bool has_valid_solutions()const noexcept;
+    double minus_solution()const noexcept;
+    double plus_solution()const noexcept;
 };
 
+// y = a*x^2 + b*x + c
+// p = b/a
+// q = c/a
+// x_m = -p/2 - sqrt((-p/2)^2 - q)
+// x_p = -p/2 + sqrt((-p/2)^2 - q)
+inline QuadraticEquation::QuadraticEquation(
+    const double _p,
+    const double _q
+) noexcept:
+    p_over_2(0.5*_p),
+    q(_q),
+    inner_part_of_squareroot(p_over_2*p_over_2 - q),
+    squareroot(0.0) {
+    if (has_valid_solutions())
+        squareroot = sqrt(inner_part_of_squareroot);
+}
+
+inline bool QuadraticEquation::has_valid_solutions()const noexcept {
+    return inner_part_of_squareroot >= 0.0;
+}
+
+inline double QuadraticEquation::minus_solution()const noexcept {
+    return -p_over_2 - squareroot;
+}
+
+inline double QuadraticEquation::plus_solution()const noexcept {
+    return -p_over_2 + squareroot;
+}
+
 }  // namespace merlict
 
 #endif  // SCENERY_GEOMETRY_QUADRATICEQUATION_H_
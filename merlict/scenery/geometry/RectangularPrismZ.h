@@ -2,12 +2,13 @@
 #ifndef SCENERY_GEOMETRY_RECTANGULARPRISMZ_H_
 #define SCENERY_GEOMETRY_RECTANGULARPRISMZ_H_
 
+#include <math.h>
 #include <string>
 #include "PrismZ.h"
 
 namespace merlict {
 
-class RectangularPrismZ :public PrismZ {
+class RectangularPrismZ final :public PrismZ {
  private:
     double half_x_width;
     double half_y_width;
@@ -28,6 +29,10 @@ class RectangularPrismZ :public PrismZ {
     void set_rectangle_y_width(const double y_width);
 };
 
+inline bool RectangularPrismZ::is_inside(const Vec3* vec)const {
+    return fabs(vec->x) < half_x_width && fabs(vec->y) <  half_y_width;
+}
+
 }  // namespace merlict
 
 #endif  // SCENERY_GEOMETRY_RECTANGULARPRISMZ_H_
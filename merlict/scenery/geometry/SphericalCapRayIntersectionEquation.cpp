@@ -37,18 +37,6 @@ SphericalCapRayIntersectionEquation::SphericalCapRayIntersectionEquation(
     }
 }
 
-bool SphericalCapRayIntersectionEquation::has_solutions()const {
-    return _has_solutions;
-}
-
-double SphericalCapRayIntersectionEquation::get_minus_solution()const {
-    return minus_solution;
-}
-
-double SphericalCapRayIntersectionEquation::get_plus_solution()const {
-    return plus_solution;
-}
-
 Vec3 SphericalCapRayIntersectionEquation::
     get_surface_normal_given_intersection_vector(
     const Vec3* intersec
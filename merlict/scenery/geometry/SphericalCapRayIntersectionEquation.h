@@ -6,7 +6,7 @@
 
 namespace merlict {
 
-class SphericalCapRayIntersectionEquation :
+class SphericalCapRayIntersectionEquation final :
     public TwoSolutionSurfaceRayEquation {
     double radius;
     double plus_solution;
@@ -22,6 +22,18 @@ class SphericalCapRayIntersectionEquation :
         const Vec3* intersec)const;
 };
 
+inline bool SphericalCapRayIntersectionEquation::has_solutions()const {
+    return _has_solutions;
+}
+
+inline double SphericalCapRayIntersectionEquation::get_minus_solution()const {
+    return minus_solution;
+}
+
+inline double SphericalCapRayIntersectionEquation::get_plus_solution()const {
+    return plus_solution;
+}
+
 }  // namespace merlict
 
 #endif  // SCENERY_GEOMETRY_SPHERICALCAPRAYINTERSECTIONEQUATION_H_
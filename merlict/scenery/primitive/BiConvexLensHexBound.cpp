@@ -1,66 +1,45 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict/scenery/primitive/BiConvexLensHexBound.h"
 #include <math.h>
+#include <algorithm>
+#include <sstream>
+#include "merlict/Ray.h"
+#include "merlict/Intersection.h"
+#include "merlict/scenery/geometry/QuadraticEquation.h"
+#include "merlict/scenery/geometry/HexagonalPrismZ.h"
 
 namespace merlict {
 
+BiConvexLensHexBound::BiConvexLensHexBound() {
+    walls.set_name_pos_rot("walls", VEC3_ORIGIN, ROT3_UNITY);
+    walls.mother = this;
+    walls.outer_color = &COLOR_GREEN;
+    walls.inner_color = &COLOR_GREEN;
+}
+
 void BiConvexLensHexBound::set_curvature_radius_and_outer_hex_radius(
     const double curvature_radius,
     const double outer_aperture_radius
 ) {
-    SphereCapWithHexagonalBound* front_cap =
-        add<SphereCapWithHexagonalBound>();
-    SphereCapWithHexagonalBound* rear_cap =
-        add<SphereCapWithHexagonalBound>();
-
-    double cap_hight = height_of_a_cap_given_curv_radius_and_outer_radius(
-            curvature_radius,
-            outer_aperture_radius);
-
-    front_cap->set_name_pos_rot(
-        "front_cap",
-        Vec3(0.0, 0.0, -cap_hight),
-        ROT3_UNITY);
-    front_cap->adopt_surface_inside_out(this);
-    front_cap->set_curvature_radius_and_outer_hex_radius(
-        curvature_radius, outer_aperture_radius);
-    front_cap->set_allowed_frames_to_propagate_to(this);
-
-    rear_cap->set_name_pos_rot(
-        "rear_cap",
-        Vec3(0.0, 0.0, cap_hight),
-        Rot3(M_PI, 0.0, 0.0));
-    rear_cap->adopt_surface_inside_out(this);
-    rear_cap->set_curvature_radius_and_outer_hex_radius(
-        curvature_radius, outer_aperture_radius);
-    rear_cap->set_allowed_frames_to_propagate_to(this);
-
-    const double inner_aperture_radius = outer_aperture_radius*sqrt(3.0)/2.0;
-    const double hight = 2.0*(
-        height_of_a_cap_given_curv_radius_and_outer_radius(
-            curvature_radius, outer_aperture_radius)
-        +
-        sqrt(
-            curvature_radius*curvature_radius -
-            inner_aperture_radius*inner_aperture_radius)
-        -
-        curvature_radius);
-
-    PlaneDualSphericalBound* walls[6];
-    for (unsigned int i = 0; i < 6; i++) {
-        const double phi = static_cast<double>(i)*1.0/3.0*M_PI;
-        walls[i] = add<PlaneDualSphericalBound>();
-        walls[i]->set_name_pos_rot(
-            "wall_" + std::to_string(i),
-            Vec3(
-                inner_aperture_radius*sin(phi),
-                inner_aperture_radius*cos(phi),
-                0.0),
-            Rot3(M_PI*0.5, M_PI*0.5, phi));
-        walls[i]->set_x_hight_and_y_width(hight, outer_aperture_radius);
-        walls[i]->outer_color = &COLOR_GREEN;
-        walls[i]->inner_color = &COLOR_GREEN;
+    if (curvature_radius <= 0.0 || outer_aperture_radius <= 0.0) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "BiConvexLensHexBound '" << name << "': Expected ";
+        info << "curvature_radius > 0 and outer_aperture_radius > 0, but ";
+        info << "actual curvature_radius = " << curvature_radius << "m, ";
+        info << "outer_aperture_radius = " << outer_aperture_radius << "m.\n";
+        throw std::invalid_argument(info.str());
     }
+    this->curvature_radius = curvature_radius;
+    outer_hex_radius = std::min(outer_aperture_radius, curvature_radius);
+    inner_hex_radius = outer_hex_radius*cos(M_PI/6.0);
+    cap_height = height_of_a_cap_given_curv_radius_and_outer_radius(
+        curvature_radius,
+        outer_hex_radius);
+    // The corners of the hexagon, where the caps meet, are farthest away
+    // from the center.
+    bounding_sphere_radius = outer_hex_radius;
+    set_allowed_frames_to_propagate_to(this);
 }
 
 double BiConvexLensHexBound::height_of_a_cap_given_curv_radius_and_outer_radius(
@@ -70,4 +49,140 @@ double BiConvexLensHexBound::height_of_a_cap_given_curv_radius_and_outer_radius(
         sqrt(curvature_radius*curvature_radius - outer_radius*outer_radius);
 }
 
+void BiConvexLensHexBound::update_bounding_sphere() {
+    SurfaceEntity::update_bounding_sphere();
+    walls.share_world_frame_of(this);
+    walls.bounding_sphere_radius = bounding_sphere_radius;
+}
+
+std::string BiConvexLensHexBound::str()const {
+    std::stringstream out;
+    out << SurfaceEntity::str();
+    out << "bi convex lens with hexagonal bound:\n";
+    out << "| curvature radius: " << curvature_radius << "m\n";
+    out << "| outer hex radius: " << outer_hex_radius << "m\n";
+    out << "| thickness: " << 2.0*cap_height << "m\n";
+    return out.str();
+}
+
+void BiConvexLensHexBound::calculate_intersection_with(
+    const Ray* ray,
+    std::vector<Intersection> *intersections
+)const {
+    const Vec3 sup = ray->support();
+    const Vec3 dir = ray->direction();
+
+    // Both caps are set up as in SphericalCapRayIntersectionEquation,
+    // relative to their vertex at z = -cap_height and z = +cap_height.
+    // The rear cap is mirrored in z. Their x and y terms are shared.
+    const double dir_times_dir = dir*dir;
+    const double sup_times_dir_xy = sup.x*dir.x + sup.y*dir.y;
+    const double sup_times_sup_xy = sup.x*sup.x + sup.y*sup.y;
+    const double R = curvature_radius;
+
+    const double front_z = sup.z + cap_height;
+    const QuadraticEquation front(
+        2.0*(sup_times_dir_xy + front_z*dir.z - R*dir.z)/dir_times_dir,
+        (sup_times_sup_xy + front_z*front_z - 2.0*R*front_z)/dir_times_dir);
+    if (!front.has_valid_solutions())
+        return;
+
+    const double rear_z = cap_height - sup.z;
+    const QuadraticEquation rear(
+        2.0*(sup_times_dir_xy - rear_z*dir.z + R*dir.z)/dir_times_dir,
+        (sup_times_sup_xy + rear_z*rear_z - 2.0*R*rear_z)/dir_times_dir);
+    if (!rear.has_valid_solutions())
+        return;
+
+    // The ray is inside of the lens in between entering and leaving all of
+    // the two spheres and the three pairs of walls.
+    double entering = front.minus_solution();
+    double leaving = front.plus_solution();
+    Face entering_face = FRONT_CAP;
+    Face leaving_face = FRONT_CAP;
+    Vec3 entering_wall_normal;
+    Vec3 leaving_wall_normal;
+
+    if (rear.minus_solution() > entering) {
+        entering = rear.minus_solution();
+        entering_face = REAR_CAP;
+    }
+    if (rear.plus_solution() < leaving) {
+        leaving = rear.plus_solution();
+        leaving_face = REAR_CAP;
+    }
+
+    const Vec3 wall_normals[3] = {VEC3_UNIT_U, VEC3_UNIT_V, VEC3_UNIT_W};
+    for (const Vec3 &normal : wall_normals) {
+        const double sup_along_normal = normal*sup;
+        const double dir_along_normal = normal*dir;
+        if (dir_along_normal == 0.0) {
+            if (fabs(sup_along_normal) >= inner_hex_radius)
+                return;
+            continue;
+        }
+        // The outer normal of the wall the ray enters through points
+        // against the ray's direction.
+        const Vec3 outer_normal =
+            dir_along_normal > 0.0 ? normal*-1.0 : normal;
+        const double near =
+            (-inner_hex_radius - sup_along_normal)/dir_along_normal;
+        const double far =
+            (inner_hex_radius - sup_along_normal)/dir_along_normal;
+        if (std::min(near, far) > entering) {
+            entering = std::min(near, far);
+            entering_face = WALL;
+            entering_wall_normal = outer_normal;
+        }
+        if (std::max(near, far) < leaving) {
+            leaving = std::max(near, far);
+            leaving_face = WALL;
+            leaving_wall_normal = outer_normal*-1.0;
+        }
+    }
+
+    if (entering >= leaving)
+        return;
+
+    add_intersection(
+        ray, entering, entering_face, entering_wall_normal, intersections);
+    add_intersection(
+        ray, leaving, leaving_face, leaving_wall_normal, intersections);
+}
+
+void BiConvexLensHexBound::add_intersection(
+    const Ray* ray,
+    const double ray_parameter,
+    const Face face,
+    const Vec3 &wall_normal,
+    std::vector<Intersection> *intersections
+)const {
+    if (ray_parameter <= 0.0)
+        return;
+    const Vec3 position = ray->position_at(ray_parameter);
+    if (ray->support() == position)
+        return;
+
+    // All surface normals point out of the lens.
+    if (face == WALL) {
+        intersections->emplace_back(
+            &walls,
+            position,
+            wall_normal,
+            ray_parameter,
+            ray->direction());
+    } else {
+        const double center_z = face == FRONT_CAP ?
+            curvature_radius - cap_height : cap_height - curvature_radius;
+        Vec3 normal = position - Vec3(0.0, 0.0, center_z);
+        normal = normal/normal.norm();
+        intersections->emplace_back(
+            this,
+            position,
+            normal,
+            ray_parameter,
+            ray->direction());
+    }
+}
+
 }  // namespace merlict
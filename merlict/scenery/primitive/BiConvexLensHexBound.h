@@ -2,20 +2,54 @@
 #ifndef SCENERY_PRIMITIVE_BICONVEXLENSHEXBOUND_H_
 #define SCENERY_PRIMITIVE_BICONVEXLENSHEXBOUND_H_
 
-#include "merlict/scenery/primitive/SphereCapWithHexagonalBound.h"
-#include "merlict/scenery/primitive/PlaneDualSphericalBound.h"
+#include <string>
+#include <vector>
+#include "merlict/SurfaceEntity.h"
 
 namespace merlict {
 
 class BiConvexLensHexBound :public SurfaceEntity{
+    // The lens is the intersection of the spheres of its front and rear cap
+    // with a hexagonal prism along z. It is a single leaf in the tree and
+    // its caps and walls are intersected together in the lens' own frame.
+    // The caps face with the surface of the lens itself, i.e. the outer
+    // surface is outside of the lens. The walls face with the default,
+    // opaque surface of 'walls'.
+    class Walls :public SurfaceEntity {
+        // The walls are not a child of the lens, but share its frame.
+        // Walkers of the tree do not reach them, so e.g. they have no
+        // SurfaceTable and evaluate their functions directly.
+        friend class BiConvexLensHexBound;
+    };
+    Walls walls;
+    double curvature_radius;
+    double outer_hex_radius;
+    double inner_hex_radius;
+    double cap_height;
+
  public:
+    BiConvexLensHexBound();
     void set_curvature_radius_and_outer_hex_radius(
         const double curvature_radius,
         const double outer_aperture_radius);
+    std::string str()const;
+    void calculate_intersection_with(
+        const Ray* ray,
+        std::vector<Intersection> *intersections)const;
 
  protected:
     double height_of_a_cap_given_curv_radius_and_outer_radius(
         const double curvature_radius, const double outer_radius)const;
+    void update_bounding_sphere();
+
+ private:
+    enum Face {FRONT_CAP, REAR_CAP, WALL};
+    void add_intersection(
+        const Ray* ray,
+        const double ray_parameter,
+        const Face face,
+        const Vec3 &wall_normal,
+        std::vector<Intersection> *intersections)const;
 };
 
 }  // namespace merlict
@@ -0,0 +1,338 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/scenery/primitive/HexGridArray.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <utility>
+#include "merlict/Ray.h"
+#include "merlict/Intersection.h"
+
+
+namespace merlict {
+
+HexGridArray::HexGridArray():
+    inv_aa(0.0), inv_ab(0.0), inv_ba(0.0), inv_bb(0.0),
+    a_min(0), b_min(0),
+    num_a(0), num_b(0),
+    num_elements(0),
+    max_element_radius(0.0),
+    template_radius(0.0) {}
+
+void HexGridArray::set_lattice(const Vec3 _unit_a, const Vec3 _unit_b) {
+    const double det = _unit_a.x*_unit_b.y - _unit_b.x*_unit_a.y;
+    if (
+        fabs(det) <= 1e-9*_unit_a.norm()*_unit_b.norm() ||
+        _unit_a.z != 0.0 ||
+        _unit_b.z != 0.0
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "HexGridArray '" << name << "': Expected the lattice ";
+        info << "vectors to span the xy-plane, but actual they are ";
+        info << _unit_a.str() << " and " << _unit_b.str() << ".\n";
+        throw std::invalid_argument(info.str());
+    }
+    unit_a = _unit_a;
+    unit_b = _unit_b;
+    inv_aa = unit_b.y/det;
+    inv_ab = -unit_b.x/det;
+    inv_ba = -unit_a.y/det;
+    inv_bb = unit_a.x/det;
+}
+
+void HexGridArray::fractional_cell(
+    const double x, const double y, double *a, double *b
+)const {
+    *a = inv_aa*x + inv_ab*y;
+    *b = inv_ba*x + inv_bb*y;
+}
+
+Vec3 HexGridArray::position_of(const int64_t a, const int64_t b)const {
+    return unit_a*static_cast<double>(a) + unit_b*static_cast<double>(b);
+}
+
+void HexGridArray::cell_of(
+    const Vec3 &position, int64_t *a, int64_t *b
+)const {
+    // The closest lattice point is one of the corners of the parallelogram
+    // the position is in.
+    double fa, fb;
+    fractional_cell(position.x, position.y, &fa, &fb);
+    const int64_t a0 = static_cast<int64_t>(floor(fa));
+    const int64_t b0 = static_cast<int64_t>(floor(fb));
+    double closest = std::numeric_limits<double>::infinity();
+    for (int64_t da = 0; da <= 1; da++) {
+        for (int64_t db = 0; db <= 1; db++) {
+            const Vec3 c = position_of(a0 + da, b0 + db);
+            const double dx = c.x - position.x;
+            const double dy = c.y - position.y;
+            if (dx*dx + dy*dy < closest) {
+                closest = dx*dx + dy*dy;
+                *a = a0 + da;
+                *b = b0 + db;
+            }
+        }
+    }
+}
+
+void HexGridArray::set_positions(const std::vector<Vec3> &positions) {
+    if (inv_aa == 0.0 && inv_bb == 0.0) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "HexGridArray '" << name << "': Expected set_lattice() ";
+        info << "before set_positions().\n";
+        throw std::logic_error(info.str());
+    }
+    const double tolerance = 1e-6*std::min(unit_a.norm(), unit_b.norm());
+    std::vector<std::pair<int64_t, int64_t>> cells;
+    cells.reserve(positions.size());
+    max_element_radius = 0.0;
+    for (const Vec3 &pos : positions) {
+        int64_t a, b;
+        cell_of(pos, &a, &b);
+        if (
+            (position_of(a, b) - pos).norm() > tolerance
+        ) {
+            std::stringstream info;
+            info << __FILE__ << " " << __LINE__ << "\n";
+            info << "HexGridArray '" << name << "': Expected every position ";
+            info << "to be on the lattice, but actual " << pos.str();
+            info << " is not.\n";
+            throw std::invalid_argument(info.str());
+        }
+        cells.emplace_back(a, b);
+        max_element_radius = std::max(max_element_radius, pos.norm());
+    }
+
+    occupied.clear();
+    num_elements = 0;
+    num_a = 0;
+    num_b = 0;
+    if (cells.size() == 0)
+        return;
+    a_min = cells[0].first;
+    b_min = cells[0].second;
+    int64_t a_max = a_min;
+    int64_t b_max = b_min;
+    for (const std::pair<int64_t, int64_t> &c : cells) {
+        a_min = std::min(a_min, c.first);
+        b_min = std::min(b_min, c.second);
+        a_max = std::max(a_max, c.first);
+        b_max = std::max(b_max, c.second);
+    }
+    num_a = a_max - a_min + 1;
+    num_b = b_max - b_min + 1;
+    occupied.resize(num_a*num_b, false);
+    for (const std::pair<int64_t, int64_t> &c : cells) {
+        const uint64_t i = (c.first - a_min)*num_b + (c.second - b_min);
+        if (!occupied[i]) {
+            occupied[i] = true;
+            num_elements++;
+        }
+    }
+}
+
+uint64_t HexGridArray::size()const {
+    return num_elements;
+}
+
+bool HexGridArray::has_element_at(const int64_t a, const int64_t b)const {
+    if (a < a_min || a >= a_min + num_a || b < b_min || b >= b_min + num_b)
+        return false;
+    return occupied[(a - a_min)*num_b + (b - b_min)];
+}
+
+const Frame* HexGridArray::get_template()const {
+    if (children.size() != 1 || children.at(0)->has_children()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "HexGridArray '" << name << "': Expected exactly one child ";
+        info << "without children of its own as template, but actual there ";
+        info << "are " << children.size() << " children.\n";
+        throw std::logic_error(info.str());
+    }
+    return children.at(0);
+}
+
+void HexGridArray::update_bounding_sphere() {
+    Frame::update_bounding_sphere();
+    const Frame* tmpl = get_template();
+    template_radius =
+        tmpl->position_in_mother().norm() + tmpl->get_bounding_sphere_radius();
+    bounding_sphere_radius = max_element_radius + template_radius;
+}
+
+std::string HexGridArray::str()const {
+    std::stringstream out;
+    out << Frame::str();
+    out << "hexagonal grid array:\n";
+    out << "| unit a: " << unit_a.str() << "\n";
+    out << "| unit b: " << unit_b.str() << "\n";
+    out << "| elements: " << num_elements << "\n";
+    return out.str();
+}
+
+bool HexGridArray::find_intersection_candidates(
+    const Ray* ray,
+    std::vector<const Frame*> *candidates
+)const {
+    (void)*ray;
+    candidates->push_back(this);
+    return true;
+}
+
+template<typename OnCell>
+void HexGridArray::for_cells_along_segment(
+    const Vec3 &start,
+    const Vec3 &stop,
+    OnCell on_cell
+)const {
+    // A 2D DDA in lattice coordinates, where the cells are unit squares.
+    // Around each square passed, there is a window of the cells whose
+    // template can reach the square. The walk only moves forward in a and
+    // in b, so a cell stays in the window from the step it enters it until
+    // it leaves for good. Only the row or column entering the window is
+    // visited in each step.
+    const double det = unit_a.x*unit_b.y - unit_b.x*unit_a.y;
+    const int64_t reach_a = static_cast<int64_t>(
+        ceil(template_radius/(fabs(det)/unit_b.norm())));
+    const int64_t reach_b = static_cast<int64_t>(
+        ceil(template_radius/(fabs(det)/unit_a.norm())));
+
+    double a0, b0, a1, b1;
+    fractional_cell(start.x, start.y, &a0, &b0);
+    fractional_cell(stop.x, stop.y, &a1, &b1);
+    int64_t a = static_cast<int64_t>(floor(a0));
+    int64_t b = static_cast<int64_t>(floor(b0));
+    const int64_t a_end = static_cast<int64_t>(floor(a1));
+    const int64_t b_end = static_cast<int64_t>(floor(b1));
+    const double inf = std::numeric_limits<double>::infinity();
+    const double da = a1 - a0;
+    const double db = b1 - b0;
+    const int64_t step_a = da > 0.0 ? 1 : -1;
+    const int64_t step_b = db > 0.0 ? 1 : -1;
+    const double delta_a = da != 0.0 ? 1.0/fabs(da) : inf;
+    const double delta_b = db != 0.0 ? 1.0/fabs(db) : inf;
+    double next_a = da != 0.0 ?
+        (da > 0.0 ? (a + 1) - a0 : a0 - a)*delta_a : inf;
+    double next_b = db != 0.0 ?
+        (db > 0.0 ? (b + 1) - b0 : b0 - b)*delta_b : inf;
+    const int64_t num_steps = std::abs(a_end - a) + std::abs(b_end - b);
+
+    for (int64_t ca = a - reach_a; ca <= a + 1 + reach_a; ca++)
+        for (int64_t cb = b - reach_b; cb <= b + 1 + reach_b; cb++)
+            if (has_element_at(ca, cb))
+                on_cell(ca, cb);
+
+    for (int64_t step = 0; step < num_steps; step++) {
+        if (next_a < next_b) {
+            a += step_a;
+            next_a += delta_a;
+            const int64_t ca = step_a > 0 ? a + 1 + reach_a : a - reach_a;
+            for (int64_t cb = b - reach_b; cb <= b + 1 + reach_b; cb++)
+                if (has_element_at(ca, cb))
+                    on_cell(ca, cb);
+        } else {
+            b += step_b;
+            next_b += delta_b;
+            const int64_t cb = step_b > 0 ? b + 1 + reach_b : b - reach_b;
+            for (int64_t ca = a - reach_a; ca <= a + 1 + reach_a; ca++)
+                if (has_element_at(ca, cb))
+                    on_cell(ca, cb);
+        }
+    }
+}
+
+void HexGridArray::intersect_element(
+    const Ray* ray,
+    const int64_t a,
+    const int64_t b,
+    std::vector<Intersection> *intersections
+)const {
+    const Frame* tmpl = children.at(0);
+    const Vec3 offset = position_of(a, b);
+    Ray ray_in_template(ray->support() - offset, ray->direction());
+    ray_in_template.transform_inverse(tmpl->frame2mother());
+
+    // The template appends its hits directly, so no vector is allocated
+    // for each element.
+    const uint64_t first_hit = intersections->size();
+    tmpl->calculate_intersection_with(&ray_in_template, intersections);
+
+    // The template's frame is shifted to the element, so that the
+    // intersection transforms into the world with the template's frame2world.
+    const Vec3 offset_in_template =
+        tmpl->frame2mother()->orientation_inverse(offset);
+    for (uint64_t k = first_hit; k < intersections->size(); k++) {
+        const Intersection &isec = (*intersections)[k];
+        (*intersections)[k] = Intersection(
+            isec.object(),
+            isec.position_in_object_frame() + offset_in_template,
+            isec.surface_normal_in_object_frame(),
+            isec.distance_to_ray_support(),
+            ray_in_template.direction());
+    }
+}
+
+void HexGridArray::calculate_intersection_with(
+    const Ray* ray,
+    std::vector<Intersection> *intersections
+)const {
+    const Vec3 s = ray->support();
+    const Vec3 d = ray->direction();
+    double t_start = 0.0;
+    double t_stop = std::numeric_limits<double>::infinity();
+
+    // slab of the templates around the xy-plane
+    if (d.z != 0.0) {
+        const double t_a = (-template_radius - s.z)/d.z;
+        const double t_b = (template_radius - s.z)/d.z;
+        t_start = std::max(t_start, std::min(t_a, t_b));
+        t_stop = std::min(t_stop, std::max(t_a, t_b));
+    } else if (fabs(s.z) > template_radius) {
+        return;
+    }
+
+    // cylinder around all elements
+    const double R = max_element_radius + template_radius;
+    const double A = d.x*d.x + d.y*d.y;
+    const double C = s.x*s.x + s.y*s.y - R*R;
+    if (A > 0.0) {
+        const double B = 2.0*(s.x*d.x + s.y*d.y);
+        const double discriminant = B*B - 4.0*A*C;
+        if (discriminant < 0.0)
+            return;
+        const double sq = sqrt(discriminant);
+        t_start = std::max(t_start, (-B - sq)/(2.0*A));
+        t_stop = std::min(t_stop, (-B + sq)/(2.0*A));
+    } else if (C > 0.0) {
+        return;
+    }
+    if (t_start > t_stop)
+        return;
+
+    const Vec3 start = ray->position_at(t_start);
+    const Vec3 stop = ray->position_at(t_stop);
+
+    const double sx = stop.x - start.x;
+    const double sy = stop.y - start.y;
+    const double segment_length_square = sx*sx + sy*sy;
+    for_cells_along_segment(
+        start,
+        stop,
+        [&](const int64_t a, const int64_t b) {
+            const Vec3 c = position_of(a, b);
+            double u = 0.0;
+            if (segment_length_square > 0.0)
+                u = std::max(0.0, std::min(1.0,
+                    ((c.x - start.x)*sx + (c.y - start.y)*sy)/
+                    segment_length_square));
+            const double ex = start.x + u*sx - c.x;
+            const double ey = start.y + u*sy - c.y;
+            if (ex*ex + ey*ey <= template_radius*template_radius)
+                intersect_element(ray, a, b, intersections);
+        });
+}
+
+}  // namespace merlict
@@ -0,0 +1,75 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef SCENERY_PRIMITIVE_HEXGRIDARRAY_H_
+#define SCENERY_PRIMITIVE_HEXGRIDARRAY_H_
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "merlict/Frame.h"
+
+namespace merlict {
+
+class HexGridArray :public Frame {
+    // Repeats one template primitive at the cells of a hexagonal lattice in
+    // the xy-plane. The template is the only child of the array, and is added
+    // with add<>() as usual. Each element only costs one bit of an occupancy
+    // map. A ray is marched cell by cell across the lattice, and the template
+    // is only intersected in the cells it passes close by.
+    // All elements share the template's SurfaceEntity. Use it for surfaces
+    // which are neither sensors nor restrict the frames to propagate to,
+    // e.g. a face plate made of many identical facets.
+    Vec3 unit_a;
+    Vec3 unit_b;
+    // inverse of the 2x2 matrix [unit_a, unit_b]
+    double inv_aa, inv_ab, inv_ba, inv_bb;
+    int64_t a_min, b_min;
+    int64_t num_a, num_b;
+    std::vector<bool> occupied;
+    uint64_t num_elements;
+    double max_element_radius;
+    double template_radius;
+
+ public:
+    HexGridArray();
+    // The lattice is spanned by the two vectors unit_a and unit_b in the
+    // xy-plane, e.g. the unit vectors of HexGridAnnulus or HexGridFlower.
+    void set_lattice(const Vec3 unit_a, const Vec3 unit_b);
+    // Every position has to be on the lattice.
+    void set_positions(const std::vector<Vec3> &positions);
+    uint64_t size()const;
+    bool has_element_at(const int64_t a, const int64_t b)const;
+    // Returns the lattice cell closest to the xy position.
+    void cell_of(const Vec3 &position, int64_t *a, int64_t *b)const;
+    Vec3 position_of(const int64_t a, const int64_t b)const;
+    std::string str()const;
+    bool find_intersection_candidates(
+        const Ray* ray,
+        std::vector<const Frame*> *candidates)const;
+    void calculate_intersection_with(
+        const Ray* ray,
+        std::vector<Intersection> *intersections)const;
+
+ protected:
+    void update_bounding_sphere();
+
+ private:
+    const Frame* get_template()const;
+    void fractional_cell(
+        const double x, const double y, double *a, double *b)const;
+    // Calls on_cell(a, b) once for each occupied cell whose template can
+    // reach the segment.
+    template<typename OnCell>
+    void for_cells_along_segment(
+        const Vec3 &start,
+        const Vec3 &stop,
+        OnCell on_cell)const;
+    void intersect_element(
+        const Ray* ray,
+        const int64_t a,
+        const int64_t b,
+        std::vector<Intersection> *intersections)const;
+};
+
+}  // namespace merlict
+
+#endif  // SCENERY_PRIMITIVE_HEXGRIDARRAY_H_
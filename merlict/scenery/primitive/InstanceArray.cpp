@@ -0,0 +1,252 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/scenery/primitive/InstanceArray.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include "merlict/Ray.h"
+#include "merlict/Intersection.h"
+#include "merlict/SurfaceEntity.h"
+
+
+namespace merlict {
+
+InstanceArray::InstanceArray():
+    prototype_radius(0.0) {}
+
+void InstanceArray::add_instance(const Vec3 pos, const Rot3 rot) {
+    HomTra3 placement;
+    placement.set_transformation(rot, pos);
+    placements.push_back(placement);
+}
+
+uint64_t InstanceArray::size()const {
+    return placements.size();
+}
+
+uint64_t InstanceArray::num_nodes()const {
+    return nodes.size();
+}
+
+const Frame* InstanceArray::get_prototype()const {
+    if (children.size() != 1) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "InstanceArray '" << name << "': Expected exactly one child ";
+        info << "as prototype, but actual there are " << children.size();
+        info << " children.\n";
+        throw std::logic_error(info.str());
+    }
+    return children.at(0);
+}
+
+void InstanceArray::collect_prototype_leafs(const Frame* frame) {
+    if (frame->has_children()) {
+        for (const Frame* child : *frame->get_children())
+            collect_prototype_leafs(child);
+        return;
+    }
+    const SurfaceEntity* surface = dynamic_cast<const SurfaceEntity*>(frame);
+    if (
+        surface != nullptr &&
+        surface->has_restrictions_on_frames_to_propagate_to()
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "InstanceArray '" << name << "': Expected the prototype's ";
+        info << "surfaces not to restrict the frames to propagate to, but ";
+        info << "actual '" << frame->path_in_tree() << "' does. ";
+        info << "Propagation inside of an instance is not supported.\n";
+        throw std::logic_error(info.str());
+    }
+    prototype_leafs.push_back(frame);
+    leaf2array.push_back(
+        frame2world()->inverse()*(*frame->frame2world()));
+}
+
+void InstanceArray::update_bounding_sphere() {
+    Frame::update_bounding_sphere();
+    const Frame* prototype = get_prototype();
+    prototype_leafs.clear();
+    leaf2array.clear();
+    collect_prototype_leafs(prototype);
+    prototype_center = prototype->position_in_mother();
+    prototype_radius = prototype->get_bounding_sphere_radius();
+
+    nodes.clear();
+    bvh_order.resize(placements.size());
+    for (uint32_t i = 0; i < placements.size(); i++)
+        bvh_order[i] = i;
+    bounding_sphere_radius = 0.0;
+    if (placements.size() == 0)
+        return;
+    nodes.reserve(2*placements.size()/MAX_INSTANCES_IN_LEAF + 1);
+    build_node(0, placements.size());
+
+    for (const HomTra3 &placement : placements)
+        bounding_sphere_radius = std::max(
+            bounding_sphere_radius,
+            placement.position(prototype_center).norm() + prototype_radius);
+}
+
+uint32_t InstanceArray::build_node(const uint32_t begin, const uint32_t end) {
+    const double inf = std::numeric_limits<double>::infinity();
+    BoxNode node;
+    node.lower = Vec3(inf, inf, inf);
+    node.upper = Vec3(-inf, -inf, -inf);
+    for (uint32_t i = begin; i < end; i++) {
+        const Vec3 c = placements[bvh_order[i]].position(prototype_center);
+        node.lower = Vec3(
+            std::min(node.lower.x, c.x - prototype_radius),
+            std::min(node.lower.y, c.y - prototype_radius),
+            std::min(node.lower.z, c.z - prototype_radius));
+        node.upper = Vec3(
+            std::max(node.upper.x, c.x + prototype_radius),
+            std::max(node.upper.y, c.y + prototype_radius),
+            std::max(node.upper.z, c.z + prototype_radius));
+    }
+    const uint32_t node_index = nodes.size();
+    nodes.push_back(node);
+
+    if (end - begin <= MAX_INSTANCES_IN_LEAF) {
+        nodes[node_index].first = begin;
+        nodes[node_index].count = end - begin;
+        return node_index;
+    }
+
+    // split at the median along the longest axis of the box
+    const Vec3 extent = node.upper - node.lower;
+    unsigned int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > (axis == 0 ? extent.x : extent.y)) axis = 2;
+    const uint32_t middle = begin + (end - begin)/2;
+    std::nth_element(
+        bvh_order.begin() + begin,
+        bvh_order.begin() + middle,
+        bvh_order.begin() + end,
+        [&](const uint32_t a, const uint32_t b) {
+            const Vec3 ca = placements[a].position(prototype_center);
+            const Vec3 cb = placements[b].position(prototype_center);
+            if (axis == 0) return ca.x < cb.x;
+            if (axis == 1) return ca.y < cb.y;
+            return ca.z < cb.z;
+        });
+
+    // The left child directly follows its parent.
+    build_node(begin, middle);
+    nodes[node_index].first = build_node(middle, end);
+    nodes[node_index].count = 0;
+    return node_index;
+}
+
+std::string InstanceArray::str()const {
+    std::stringstream out;
+    out << Frame::str();
+    out << "instance array:\n";
+    out << "| instances: " << placements.size() << "\n";
+    out << "| bvh nodes: " << nodes.size() << "\n";
+    return out.str();
+}
+
+bool InstanceArray::find_intersection_candidates(
+    const Ray* ray,
+    std::vector<const Frame*> *candidates
+)const {
+    (void)*ray;
+    candidates->push_back(this);
+    return true;
+}
+
+namespace {
+
+bool ray_hits_box(
+    const Vec3 &support,
+    const Vec3 &inverse_direction,
+    const Vec3 &lower,
+    const Vec3 &upper
+) {
+    double t1 = (lower.x - support.x)*inverse_direction.x;
+    double t2 = (upper.x - support.x)*inverse_direction.x;
+    double t_start = std::min(t1, t2);
+    double t_stop = std::max(t1, t2);
+    t1 = (lower.y - support.y)*inverse_direction.y;
+    t2 = (upper.y - support.y)*inverse_direction.y;
+    t_start = std::max(t_start, std::min(t1, t2));
+    t_stop = std::min(t_stop, std::max(t1, t2));
+    t1 = (lower.z - support.z)*inverse_direction.z;
+    t2 = (upper.z - support.z)*inverse_direction.z;
+    t_start = std::max(t_start, std::min(t1, t2));
+    t_stop = std::min(t_stop, std::max(t1, t2));
+    return t_stop >= std::max(t_start, 0.0);
+}
+
+}  // namespace
+
+void InstanceArray::calculate_intersection_with(
+    const Ray* ray,
+    std::vector<Intersection> *intersections
+)const {
+    if (nodes.size() == 0)
+        return;
+    const Vec3 support = ray->support();
+    const Vec3 inverse_direction(
+        1.0/ray->direction().x,
+        1.0/ray->direction().y,
+        1.0/ray->direction().z);
+
+    // The median split limits the depth of the hierarchy to 32.
+    uint32_t stack[64];
+    uint32_t stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        const uint32_t node_index = stack[--stack_size];
+        const BoxNode &node = nodes[node_index];
+        if (!ray_hits_box(support, inverse_direction, node.lower, node.upper))
+            continue;
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++)
+                intersect_instance(ray, bvh_order[i], intersections);
+        } else {
+            stack[stack_size++] = node.first;
+            stack[stack_size++] = node_index + 1;
+        }
+    }
+}
+
+void InstanceArray::intersect_instance(
+    const Ray* ray,
+    const uint32_t instance,
+    std::vector<Intersection> *intersections
+)const {
+    const HomTra3 &placement = placements[instance];
+    for (uint64_t j = 0; j < prototype_leafs.size(); j++) {
+        const HomTra3 leaf2instance = placement*leaf2array[j];
+        Ray ray_in_leaf = *ray;
+        ray_in_leaf.transform_inverse(&leaf2instance);
+
+        // The leaf appends its hits directly, so no vector is allocated
+        // for each instance.
+        const uint64_t first_hit = intersections->size();
+        prototype_leafs[j]->calculate_intersection_with(
+            &ray_in_leaf,
+            intersections);
+
+        // The hits are expressed in the leaf's own frame, but moved to the
+        // instance, so that the leaf's frame2world still maps them into the
+        // world exactly.
+        for (uint64_t k = first_hit; k < intersections->size(); k++) {
+            const Intersection &isec = (*intersections)[k];
+            (*intersections)[k] = Intersection(
+                isec.object(),
+                leaf2array[j].position_inverse(
+                    leaf2instance.position(isec.position_in_object_frame())),
+                leaf2array[j].orientation_inverse(
+                    leaf2instance.orientation(
+                        isec.surface_normal_in_object_frame())),
+                isec.distance_to_ray_support(),
+                leaf2array[j].orientation_inverse(ray->direction()));
+        }
+    }
+}
+
+}  // namespace merlict
@@ -0,0 +1,71 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef SCENERY_PRIMITIVE_INSTANCEARRAY_H_
+#define SCENERY_PRIMITIVE_INSTANCEARRAY_H_
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "merlict/Frame.h"
+#include "merlict/HomTra3.h"
+
+namespace merlict {
+
+class InstanceArray :public Frame {
+    // Places one prototype many times. The prototype is the only child of
+    // the array, and is added with add<>() as usual. It holds the shape and
+    // the SurfaceEntity of all instances. An instance only holds its
+    // placement relative to the prototype.
+    // The instances are found by a bounding volume hierarchy of axis aligned
+    // boxes around their bounding spheres.
+    // All instances share the prototype's surfaces. Use it for surfaces
+    // which are neither sensors nor restrict the frames to propagate to,
+    // e.g. mirror facets.
+    struct BoxNode {
+        Vec3 lower;
+        Vec3 upper;
+        // leaf: first instance in bvh_order, else: index of the right child.
+        // The left child directly follows its parent.
+        uint32_t first;
+        // leaf: number of instances, else: 0
+        uint32_t count;
+    };
+
+    std::vector<HomTra3> placements;
+    std::vector<const Frame*> prototype_leafs;
+    std::vector<HomTra3> leaf2array;
+    Vec3 prototype_center;
+    double prototype_radius;
+    std::vector<BoxNode> nodes;
+    std::vector<uint32_t> bvh_order;
+
+ public:
+    static const uint32_t MAX_INSTANCES_IN_LEAF = 4;
+    InstanceArray();
+    // The placement moves the prototype within the array.
+    void add_instance(const Vec3 pos, const Rot3 rot);
+    uint64_t size()const;
+    uint64_t num_nodes()const;
+    std::string str()const;
+    bool find_intersection_candidates(
+        const Ray* ray,
+        std::vector<const Frame*> *candidates)const;
+    void calculate_intersection_with(
+        const Ray* ray,
+        std::vector<Intersection> *intersections)const;
+
+ protected:
+    void update_bounding_sphere();
+
+ private:
+    const Frame* get_prototype()const;
+    void collect_prototype_leafs(const Frame* frame);
+    uint32_t build_node(const uint32_t begin, const uint32_t end);
+    void intersect_instance(
+        const Ray* ray,
+        const uint32_t instance,
+        std::vector<Intersection> *intersections)const;
+};
+
+}  // namespace merlict
+
+#endif  // SCENERY_PRIMITIVE_INSTANCEARRAY_H_
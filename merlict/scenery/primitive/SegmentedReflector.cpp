@@ -0,0 +1,332 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/scenery/primitive/SegmentedReflector.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include "merlict/Ray.h"
+#include "merlict/Intersection.h"
+#include "merlict/HomTra3.h"
+#include "merlict/scenery/geometry/HexagonalPrismZ.h"
+#include "merlict/scenery/geometry/QuadraticEquation.h"
+
+namespace merlict {
+
+SegmentedReflector::SegmentedReflector():
+    unit_a(VEC3_UNIT_X),
+    unit_b(VEC3_UNIT_Y),
+    dual_a(VEC3_UNIT_X),
+    dual_b(VEC3_UNIT_Y),
+    outer_hex_radius(0.0),
+    inner_hex_radius(0.0),
+    max_facet_radius(0.0),
+    z_lower(std::numeric_limits<double>::infinity()),
+    z_upper(-std::numeric_limits<double>::infinity()),
+    a_begin(0), a_end(0), b_begin(0), b_end(0) {}
+
+void SegmentedReflector::set_lattice_and_outer_hex_radius(
+    const Vec3 _unit_a,
+    const Vec3 _unit_b,
+    const double _outer_hex_radius
+) {
+    const double det = _unit_a.x*_unit_b.y - _unit_a.y*_unit_b.x;
+    if (det == 0.0 || _outer_hex_radius <= 0.0) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "SegmentedReflector '" << name << "': Expected the lattice ";
+        info << "to span the x-y plane and the outer hex radius to be ";
+        info << "positive, but actual unit_a = " << _unit_a.str() << ", ";
+        info << "unit_b = " << _unit_b.str() << " and outer hex radius = ";
+        info << _outer_hex_radius << "m.\n";
+        throw std::invalid_argument(info.str());
+    }
+    unit_a = Vec3(_unit_a.x, _unit_a.y, 0.0);
+    unit_b = Vec3(_unit_b.x, _unit_b.y, 0.0);
+    dual_a = Vec3(unit_b.y, -unit_b.x, 0.0)/det;
+    dual_b = Vec3(-unit_a.y, unit_a.x, 0.0)/det;
+    outer_hex_radius = _outer_hex_radius;
+    inner_hex_radius = outer_hex_radius*cos(M_PI/6.0);
+    facets = Facets();
+    lattice.clear();
+    max_facet_radius = 0.0;
+    z_lower = std::numeric_limits<double>::infinity();
+    z_upper = -std::numeric_limits<double>::infinity();
+    bounding_sphere_radius = 0.0;
+}
+
+void SegmentedReflector::add_facet(
+    const Vec3 pos,
+    const Rot3 rot,
+    const double curvature_radius
+) {
+    if (curvature_radius < outer_hex_radius) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "SegmentedReflector '" << name << "': Expected the ";
+        info << "curvature radius of facet " << num_facets() << " to be ";
+        info << "at least the outer hex radius " << outer_hex_radius;
+        info << "m, but actual it is " << curvature_radius << "m.\n";
+        throw std::invalid_argument(info.str());
+    }
+    const double a = pos*dual_a;
+    const double b = pos*dual_b;
+    const int32_t lattice_a = static_cast<int32_t>(round(a));
+    const int32_t lattice_b = static_cast<int32_t>(round(b));
+    const Vec3 on_lattice = unit_a*lattice_a + unit_b*lattice_b;
+    if (
+        hypot(on_lattice.x - pos.x, on_lattice.y - pos.y) >
+        1e-6*unit_a.norm()
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "SegmentedReflector '" << name << "': Expected facet ";
+        info << num_facets() << " to be on the lattice, but actual its ";
+        info << "position " << pos.str() << " is at a = " << a << ", ";
+        info << "b = " << b << ".\n";
+        throw std::invalid_argument(info.str());
+    }
+
+    HomTra3 facet2reflector;
+    facet2reflector.set_transformation(rot, pos);
+    const Vec3 ex = facet2reflector.orientation(VEC3_UNIT_X);
+    const Vec3 ey = facet2reflector.orientation(VEC3_UNIT_Y);
+    const Vec3 ez = facet2reflector.orientation(VEC3_UNIT_Z);
+    const double facet_radius = hypot(
+        outer_hex_radius,
+        curvature_radius - sqrt(
+            curvature_radius*curvature_radius -
+            outer_hex_radius*outer_hex_radius));
+
+    facets.x.push_back(pos.x);
+    facets.y.push_back(pos.y);
+    facets.z.push_back(pos.z);
+    facets.ex_x.push_back(ex.x);
+    facets.ex_y.push_back(ex.y);
+    facets.ex_z.push_back(ex.z);
+    facets.ey_x.push_back(ey.x);
+    facets.ey_y.push_back(ey.y);
+    facets.ey_z.push_back(ey.z);
+    facets.ez_x.push_back(ez.x);
+    facets.ez_y.push_back(ez.y);
+    facets.ez_z.push_back(ez.z);
+    facets.curvature_radius.push_back(curvature_radius);
+    facets.bounding_radius.push_back(facet_radius);
+    facets.lattice_a.push_back(lattice_a);
+    facets.lattice_b.push_back(lattice_b);
+
+    max_facet_radius = std::max(max_facet_radius, facet_radius);
+    z_lower = std::min(z_lower, pos.z - facet_radius);
+    z_upper = std::max(z_upper, pos.z + facet_radius);
+    bounding_sphere_radius = std::max(
+        bounding_sphere_radius,
+        pos.norm() + facet_radius);
+}
+
+uint64_t SegmentedReflector::num_facets()const {
+    return facets.x.size();
+}
+
+void SegmentedReflector::update_bounding_sphere() {
+    lattice.clear();
+    if (num_facets() == 0)
+        return;
+    a_begin = *std::min_element(
+        facets.lattice_a.begin(), facets.lattice_a.end());
+    a_end = *std::max_element(
+        facets.lattice_a.begin(), facets.lattice_a.end()) + 1;
+    b_begin = *std::min_element(
+        facets.lattice_b.begin(), facets.lattice_b.end());
+    b_end = *std::max_element(
+        facets.lattice_b.begin(), facets.lattice_b.end()) + 1;
+    lattice.resize(
+        static_cast<uint64_t>(a_end - a_begin)*(b_end - b_begin), 0u);
+    for (uint32_t i = 0; i < num_facets(); i++) {
+        uint32_t &cell = lattice[
+            (facets.lattice_a[i] - a_begin)*(b_end - b_begin) +
+            (facets.lattice_b[i] - b_begin)];
+        if (cell != 0u) {
+            std::stringstream info;
+            info << __FILE__ << " " << __LINE__ << "\n";
+            info << "SegmentedReflector '" << name << "': Expected one ";
+            info << "facet at each point of the lattice, but actual facet ";
+            info << cell - 1u << " and facet " << i << " are both at a = ";
+            info << facets.lattice_a[i] << ", b = " << facets.lattice_b[i];
+            info << ".\n";
+            throw std::logic_error(info.str());
+        }
+        cell = i + 1u;
+    }
+}
+
+std::string SegmentedReflector::str()const {
+    std::stringstream out;
+    out << SurfaceEntity::str();
+    out << "segmented reflector:\n";
+    out << "| facets: " << num_facets() << "\n";
+    out << "| outer hex radius: " << outer_hex_radius << "m\n";
+    out << "| lattice: " << unit_a.str() << ", " << unit_b.str() << "\n";
+    return out.str();
+}
+
+double SegmentedReflector::intersect_facet(
+    const uint32_t i,
+    const Vec3 &support,
+    const Vec3 &direction,
+    Vec3* normal
+)const {
+    // the ray in the frame of the facet
+    const Vec3 ex(facets.ex_x[i], facets.ex_y[i], facets.ex_z[i]);
+    const Vec3 ey(facets.ey_x[i], facets.ey_y[i], facets.ey_z[i]);
+    const Vec3 ez(facets.ez_x[i], facets.ez_y[i], facets.ez_z[i]);
+    const Vec3 s_in_reflector =
+        support - Vec3(facets.x[i], facets.y[i], facets.z[i]);
+    const Vec3 s(ex*s_in_reflector, ey*s_in_reflector, ez*s_in_reflector);
+    const Vec3 d(ex*direction, ey*direction, ez*direction);
+
+    // See SphericalCapRayIntersectionEquation.
+    const double R = facets.curvature_radius[i];
+    const double d_times_d = d*d;
+    QuadraticEquation eq(
+        2.0*(s*d - R*d.z)/d_times_d,
+        (s*s - 2.0*R*s.z)/d_times_d);
+    if (!eq.has_valid_solutions())
+        return 0.0;
+
+    // The closest solution on the cap and within the hexagon, see
+    // SurfaceWithOuterPrismBound.
+    double t = std::numeric_limits<double>::infinity();
+    for (const double solution : {eq.minus_solution(), eq.plus_solution()}) {
+        const Vec3 p = s + d*solution;
+        const double u = VEC3_UNIT_U*p;
+        const double v = VEC3_UNIT_V*p;
+        const double w = VEC3_UNIT_W*p;
+        if (
+            solution > 0.0 &&
+            solution < t &&
+            p.norm_is_less_equal_than(facets.bounding_radius[i]) &&
+            u < inner_hex_radius && u > -inner_hex_radius &&
+            v < inner_hex_radius && v > -inner_hex_radius &&
+            w < inner_hex_radius && w > -inner_hex_radius
+        )
+            t = solution;
+    }
+    if (isinf(t) || s + d*t == s)
+        return 0.0;
+
+    Vec3 n = Vec3(0.0, 0.0, R) - (s + d*t);
+    n = n/n.norm();
+    *normal = ex*n.x + ey*n.y + ez*n.z;
+    return t;
+}
+
+void SegmentedReflector::calculate_intersection_with(
+    const Ray* ray,
+    std::vector<Intersection> *intersections
+)const {
+    if (lattice.size() == 0)
+        return;
+    const Vec3 support = ray->support();
+    const Vec3 direction = ray->direction();
+
+    // The part of the ray in the bounding sphere and in between z_lower and
+    // z_upper.
+    const double s_times_d = support*direction;
+    const double discriminant = s_times_d*s_times_d -
+        (support*support - bounding_sphere_radius*bounding_sphere_radius);
+    if (discriminant < 0.0)
+        return;
+    double t_start = std::max(0.0, -s_times_d - sqrt(discriminant));
+    double t_stop = -s_times_d + sqrt(discriminant);
+    if (direction.z != 0.0) {
+        const double t1 = (z_lower - support.z)/direction.z;
+        const double t2 = (z_upper - support.z)/direction.z;
+        t_start = std::max(t_start, std::min(t1, t2));
+        t_stop = std::min(t_stop, std::max(t1, t2));
+    } else if (support.z < z_lower || support.z > z_upper) {
+        return;
+    }
+    if (t_start > t_stop)
+        return;
+
+    // The projection of this part onto the x-y plane is walked in steps
+    // shorter than the lattice spacing. A facet is tested in the step which
+    // holds the closest point of the projection to the facet's center.
+    const Vec3 start = ray->position_at(t_start);
+    const Vec3 stop = ray->position_at(t_stop);
+    const Vec3 projection(stop.x - start.x, stop.y - start.y, 0.0);
+    const double length = projection.norm();
+    const uint32_t num_steps = static_cast<uint32_t>(std::max(
+        1.0,
+        ceil(length/std::min(unit_a.norm(), unit_b.norm()))));
+    const double margin_a = max_facet_radius*dual_a.norm();
+    const double margin_b = max_facet_radius*dual_b.norm();
+
+    double closest = std::numeric_limits<double>::infinity();
+    Vec3 closest_normal;
+    for (uint32_t step = 0; step < num_steps; step++) {
+        const double l1 = static_cast<double>(step)/num_steps;
+        const double l2 = static_cast<double>(step + 1)/num_steps;
+        const Vec3 p1 = start + projection*l1;
+        const Vec3 p2 = start + projection*l2;
+        const double a1 = p1*dual_a;
+        const double a2 = p2*dual_a;
+        const double b1 = p1*dual_b;
+        const double b2 = p2*dual_b;
+        const int32_t a_min = std::max(a_begin, static_cast<int32_t>(
+            floor(std::min(a1, a2) - margin_a)));
+        const int32_t a_max = std::min(a_end - 1, static_cast<int32_t>(
+            ceil(std::max(a1, a2) + margin_a)));
+        const int32_t b_min = std::max(b_begin, static_cast<int32_t>(
+            floor(std::min(b1, b2) - margin_b)));
+        const int32_t b_max = std::min(b_end - 1, static_cast<int32_t>(
+            ceil(std::max(b1, b2) + margin_b)));
+
+        for (int32_t a = a_min; a <= a_max; a++) {
+            for (int32_t b = b_min; b <= b_max; b++) {
+                const uint32_t cell = lattice[
+                    (a - a_begin)*(b_end - b_begin) + (b - b_begin)];
+                if (cell == 0u)
+                    continue;
+                const uint32_t i = cell - 1u;
+                const Vec3 center(facets.x[i], facets.y[i], facets.z[i]);
+
+                double l = 0.0;
+                if (length > 0.0) {
+                    l = (Vec3(center.x - start.x, center.y - start.y, 0.0)*
+                        projection)/(length*length);
+                    l = std::min(1.0, std::max(0.0, l));
+                }
+                const bool in_step = step + 1 == num_steps ?
+                    l >= l1 : l >= l1 && l < l2;
+                if (!in_step)
+                    continue;
+
+                const Vec3 to_center = center - support;
+                if (
+                    to_center.cross(direction).norm() >
+                    facets.bounding_radius[i]
+                )
+                    continue;
+
+                Vec3 normal;
+                const double t = intersect_facet(
+                    i, support, direction, &normal);
+                if (t > 0.0 && t < closest) {
+                    closest = t;
+                    closest_normal = normal;
+                }
+            }
+        }
+    }
+
+    if (isinf(closest))
+        return;
+    intersections->emplace_back(
+        this,
+        ray->position_at(closest),
+        closest_normal,
+        closest,
+        direction);
+}
+
+}  // namespace merlict
@@ -0,0 +1,84 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef SCENERY_PRIMITIVE_SEGMENTEDREFLECTOR_H_
+#define SCENERY_PRIMITIVE_SEGMENTEDREFLECTOR_H_
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "merlict/SurfaceEntity.h"
+
+namespace merlict {
+
+class SegmentedReflector :public SurfaceEntity {
+    // The mirror facets of a segmented imaging reflector in a single frame.
+    // Each facet is a spherical cap with a hexagonal bound, just like
+    // SphereCapWithHexagonalBound, and its center is on a hexagonal lattice
+    // in the x-y plane. A ray is projected onto the lattice and only the
+    // facets close to its projection are intersected.
+    // The outer surface of a facet faces its center of curvature.
+    struct Facets {
+        // the centers
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        // The unit vectors of a facet's frame in the reflector's frame.
+        // The z-axis is the normal of the facet.
+        std::vector<double> ex_x, ex_y, ex_z;
+        std::vector<double> ey_x, ey_y, ey_z;
+        std::vector<double> ez_x, ez_y, ez_z;
+        std::vector<double> curvature_radius;
+        std::vector<double> bounding_radius;
+        std::vector<int32_t> lattice_a;
+        std::vector<int32_t> lattice_b;
+    };
+    Facets facets;
+    Vec3 unit_a;
+    Vec3 unit_b;
+    // The lattice coordinates of a point q in the x-y plane are
+    // a = q*dual_a and b = q*dual_b.
+    Vec3 dual_a;
+    Vec3 dual_b;
+    double outer_hex_radius;
+    double inner_hex_radius;
+    double max_facet_radius;
+    // All facets are in between z_lower and z_upper.
+    double z_lower;
+    double z_upper;
+    // The index of the facet plus one at each point of the lattice, or 0
+    // when there is no facet.
+    int32_t a_begin, a_end, b_begin, b_end;
+    std::vector<uint32_t> lattice;
+
+ public:
+    SegmentedReflector();
+    // The facets' centers are at a*unit_a + b*unit_b in the x-y plane.
+    // Drops all facets.
+    void set_lattice_and_outer_hex_radius(
+        const Vec3 unit_a,
+        const Vec3 unit_b,
+        const double outer_hex_radius);
+    void add_facet(
+        const Vec3 pos,
+        const Rot3 rot,
+        const double curvature_radius);
+    uint64_t num_facets()const;
+    std::string str()const;
+    void calculate_intersection_with(
+        const Ray* ray,
+        std::vector<Intersection> *intersections)const;
+
+ protected:
+    void update_bounding_sphere();
+
+ private:
+    // Returns the ray parameter, or a non positive one when the ray misses.
+    double intersect_facet(
+        const uint32_t i,
+        const Vec3 &support,
+        const Vec3 &direction,
+        Vec3* normal)const;
+};
+
+}  // namespace merlict
+
+#endif  // SCENERY_PRIMITIVE_SEGMENTEDREFLECTOR_H_
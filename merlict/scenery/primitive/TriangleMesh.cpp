@@ -0,0 +1,310 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/scenery/primitive/TriangleMesh.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include "merlict/Ray.h"
+#include "merlict/Intersection.h"
+
+namespace merlict {
+
+void TriangleMesh::set_vertices_and_faces(
+    const std::vector<Vec3> &_vertices,
+    const std::vector<Face> &_faces
+) {
+    vertices = _vertices;
+    faces = _faces;
+    assert_faces_refer_to_vertices();
+
+    nodes.clear();
+    if (faces.size() > 0) {
+        nodes.reserve(2*faces.size()/MAX_FACES_IN_LEAF + 1);
+        build_node(0, faces.size());
+    }
+
+    bounding_sphere_radius = 0.0;
+    for (const Vec3 &vertex : vertices)
+        bounding_sphere_radius = std::max(
+            bounding_sphere_radius,
+            vertex.norm());
+}
+
+void TriangleMesh::assert_faces_refer_to_vertices()const {
+    for (uint64_t i = 0; i < faces.size(); i++) {
+        const Face &face = faces[i];
+        if (
+            face.a >= vertices.size() ||
+            face.b >= vertices.size() ||
+            face.c >= vertices.size()
+        ) {
+            std::stringstream info;
+            info << __FILE__ << " " << __LINE__ << "\n";
+            info << "TriangleMesh '" << name << "': Expected face " << i;
+            info << " to refer to the " << vertices.size() << " vertices, ";
+            info << "but actual it refers to vertex " << face.a << ", ";
+            info << face.b << ", " << face.c << ".\n";
+            throw std::out_of_range(info.str());
+        }
+    }
+}
+
+namespace {
+
+float round_down(const double x) {
+    float f = static_cast<float>(x);
+    if (f > x)
+        f = nextafterf(f, -std::numeric_limits<float>::infinity());
+    return f;
+}
+
+float round_up(const double x) {
+    float f = static_cast<float>(x);
+    if (f < x)
+        f = nextafterf(f, std::numeric_limits<float>::infinity());
+    return f;
+}
+
+}  // namespace
+
+Vec3 TriangleMesh::centroid(const Face &face)const {
+    return (vertices[face.a] + vertices[face.b] + vertices[face.c])/3.0;
+}
+
+Vec3 TriangleMesh::normal(const Face &face)const {
+    const Vec3 n = (vertices[face.b] - vertices[face.a]).cross(
+        vertices[face.c] - vertices[face.a]);
+    return n/n.norm();
+}
+
+uint32_t TriangleMesh::build_node(const uint32_t begin, const uint32_t end) {
+    const double inf = std::numeric_limits<double>::infinity();
+    Vec3 lower(inf, inf, inf);
+    Vec3 upper(-inf, -inf, -inf);
+    for (uint32_t i = begin; i < end; i++) {
+        for (const uint32_t v : {faces[i].a, faces[i].b, faces[i].c}) {
+            const Vec3 &p = vertices[v];
+            lower = Vec3(
+                std::min(lower.x, p.x),
+                std::min(lower.y, p.y),
+                std::min(lower.z, p.z));
+            upper = Vec3(
+                std::max(upper.x, p.x),
+                std::max(upper.y, p.y),
+                std::max(upper.z, p.z));
+        }
+    }
+    BoxNode node;
+    node.lower[0] = round_down(lower.x);
+    node.lower[1] = round_down(lower.y);
+    node.lower[2] = round_down(lower.z);
+    node.upper[0] = round_up(upper.x);
+    node.upper[1] = round_up(upper.y);
+    node.upper[2] = round_up(upper.z);
+    const uint32_t node_index = nodes.size();
+    nodes.push_back(node);
+
+    if (end - begin <= MAX_FACES_IN_LEAF) {
+        nodes[node_index].first = begin;
+        nodes[node_index].count = end - begin;
+        return node_index;
+    }
+
+    // split at the median along the longest axis of the box
+    const Vec3 extent = upper - lower;
+    unsigned int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > (axis == 0 ? extent.x : extent.y)) axis = 2;
+    const uint32_t middle = begin + (end - begin)/2;
+    std::nth_element(
+        faces.begin() + begin,
+        faces.begin() + middle,
+        faces.begin() + end,
+        [&](const Face &a, const Face &b) {
+            const Vec3 ca = centroid(a);
+            const Vec3 cb = centroid(b);
+            if (axis == 0) return ca.x < cb.x;
+            if (axis == 1) return ca.y < cb.y;
+            return ca.z < cb.z;
+        });
+
+    // The left child directly follows its parent.
+    build_node(begin, middle);
+    nodes[node_index].first = build_node(middle, end);
+    nodes[node_index].count = 0;
+    return node_index;
+}
+
+uint64_t TriangleMesh::num_vertices()const {
+    return vertices.size();
+}
+
+uint64_t TriangleMesh::num_faces()const {
+    return faces.size();
+}
+
+uint64_t TriangleMesh::num_nodes()const {
+    return nodes.size();
+}
+
+uint64_t TriangleMesh::num_bytes()const {
+    return vertices.size()*sizeof(Vec3) +
+        faces.size()*sizeof(Face) +
+        nodes.size()*sizeof(BoxNode);
+}
+
+std::string TriangleMesh::str()const {
+    std::stringstream out;
+    out << SurfaceEntity::str();
+    out << "triangle mesh:\n";
+    out << "| vertices: " << vertices.size() << "\n";
+    out << "| faces: " << faces.size() << "\n";
+    out << "| bvh nodes: " << nodes.size() << "\n";
+    out << "| memory: " << num_bytes() << " bytes\n";
+    return out.str();
+}
+
+namespace {
+
+double component(const Vec3 &v, const unsigned int k) {
+    return k == 0 ? v.x : (k == 1 ? v.y : v.z);
+}
+
+// The ray is moved to the origin and sheared to run along the z-axis.
+// The triangles are tested in this frame by the signs of their edge
+// functions, which are the same for faces sharing an edge. See Woop,
+// Benthin and Wald, Watertight Ray/Triangle Intersection, Journal of
+// Computer Graphics Techniques, Vol. 2, No. 1, 2013.
+struct ShearedRay {
+    Vec3 support;
+    unsigned int kx, ky, kz;
+    double sx, sy, sz;
+
+    explicit ShearedRay(const Ray* ray) {
+        support = ray->support();
+        const Vec3 dir = ray->direction();
+        kz = 0;
+        if (fabs(dir.y) > fabs(dir.x)) kz = 1;
+        if (fabs(dir.z) > fabs(component(dir, kz))) kz = 2;
+        kx = (kz + 1)%3;
+        ky = (kx + 1)%3;
+        // keep the winding
+        if (component(dir, kz) < 0.0)
+            std::swap(kx, ky);
+        sx = component(dir, kx)/component(dir, kz);
+        sy = component(dir, ky)/component(dir, kz);
+        sz = 1.0/component(dir, kz);
+    }
+
+    // Returns the ray parameter, or a non positive one when the ray misses.
+    double intersect(const Vec3 &a, const Vec3 &b, const Vec3 &c)const {
+        const Vec3 A = a - support;
+        const Vec3 B = b - support;
+        const Vec3 C = c - support;
+        const double Az = component(A, kz);
+        const double Bz = component(B, kz);
+        const double Cz = component(C, kz);
+        const double Ax = component(A, kx) - sx*Az;
+        const double Ay = component(A, ky) - sy*Az;
+        const double Bx = component(B, kx) - sx*Bz;
+        const double By = component(B, ky) - sy*Bz;
+        const double Cx = component(C, kx) - sx*Cz;
+        const double Cy = component(C, ky) - sy*Cz;
+
+        const double U = Cx*By - Cy*Bx;
+        const double V = Ax*Cy - Ay*Cx;
+        const double W = Bx*Ay - By*Ax;
+        if ((U < 0.0 || V < 0.0 || W < 0.0) && (U > 0.0 || V > 0.0 || W > 0.0))
+            return 0.0;
+        const double det = U + V + W;
+        if (det == 0.0)
+            return 0.0;
+        const double T = (U*Az + V*Bz + W*Cz)*sz;
+        return T/det;
+    }
+};
+
+bool ray_hits_box(
+    const double support[3],
+    const double inverse_direction[3],
+    const float lower[3],
+    const float upper[3],
+    const double max_ray_parameter
+) {
+    double t_start = 0.0;
+    double t_stop = max_ray_parameter;
+    for (unsigned int k = 0; k < 3; k++) {
+        if (isinf(inverse_direction[k])) {
+            // A ray parallel to the slab, even on its border, would make
+            // 0*inf = nan.
+            if (support[k] < lower[k] || support[k] > upper[k])
+                return false;
+            continue;
+        }
+        const double t1 = (lower[k] - support[k])*inverse_direction[k];
+        const double t2 = (upper[k] - support[k])*inverse_direction[k];
+        t_start = std::max(t_start, std::min(t1, t2));
+        t_stop = std::min(t_stop, std::max(t1, t2));
+    }
+    return t_start <= t_stop;
+}
+
+}  // namespace
+
+void TriangleMesh::calculate_intersection_with(
+    const Ray* ray,
+    std::vector<Intersection> *intersections
+)const {
+    if (nodes.size() == 0)
+        return;
+    const ShearedRay sheared(ray);
+    const Vec3 support = ray->support();
+    const double box_support[3] = {support.x, support.y, support.z};
+    const double inverse_direction[3] = {
+        1.0/ray->direction().x,
+        1.0/ray->direction().y,
+        1.0/ray->direction().z};
+
+    // Only the closest face can be the first intersection of the ray.
+    double closest = std::numeric_limits<double>::infinity();
+    uint32_t closest_face = faces.size();
+
+    // The median split limits the depth of the hierarchy to 32.
+    uint32_t stack[64];
+    uint32_t stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        const uint32_t node_index = stack[--stack_size];
+        const BoxNode &node = nodes[node_index];
+        if (!ray_hits_box(
+            box_support, inverse_direction, node.lower, node.upper, closest)
+        )
+            continue;
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                const double t = sheared.intersect(
+                    vertices[faces[i].a],
+                    vertices[faces[i].b],
+                    vertices[faces[i].c]);
+                if (t > 0.0 && t < closest && ray->position_at(t) != support) {
+                    closest = t;
+                    closest_face = i;
+                }
+            }
+        } else {
+            stack[stack_size++] = node.first;
+            stack[stack_size++] = node_index + 1;
+        }
+    }
+
+    if (closest_face == faces.size())
+        return;
+    intersections->emplace_back(
+        this,
+        ray->position_at(closest),
+        normal(faces[closest_face]),
+        closest,
+        ray->direction());
+}
+
+}  // namespace merlict
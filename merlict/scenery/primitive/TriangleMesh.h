@@ -0,0 +1,67 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef SCENERY_PRIMITIVE_TRIANGLEMESH_H_
+#define SCENERY_PRIMITIVE_TRIANGLEMESH_H_
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "merlict/SurfaceEntity.h"
+
+namespace merlict {
+
+class TriangleMesh :public SurfaceEntity {
+    // Many triangles with one surface in a single frame, e.g. a CAD model
+    // read from an STL file. The vertices and the faces are stored
+    // contiguously, and the faces are found by a bounding volume hierarchy
+    // of axis aligned boxes. The intersection is watertight, i.e. a ray
+    // through a shared edge or vertex hits at least one of its faces.
+    // The outer surface is on the side of a face its vertices run counter
+    // clockwise, i.e. a, b, c are right handed with the surface normal.
+ public:
+    struct Face {
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+    };
+
+ private:
+    struct BoxNode {
+        // float to keep the hierarchy small, rounded outwards
+        float lower[3];
+        float upper[3];
+        // leaf: first face in faces, else: index of the right child
+        uint32_t first;
+        // leaf: number of faces, else: 0
+        uint32_t count;
+    };
+
+    std::vector<Vec3> vertices;
+    std::vector<Face> faces;
+    std::vector<BoxNode> nodes;
+
+ public:
+    static const uint32_t MAX_FACES_IN_LEAF = 4;
+    // Faces with zero area are kept, but are never intersected.
+    void set_vertices_and_faces(
+        const std::vector<Vec3> &vertices,
+        const std::vector<Face> &faces);
+    uint64_t num_vertices()const;
+    uint64_t num_faces()const;
+    uint64_t num_nodes()const;
+    // The memory of the vertices, the faces and the hierarchy.
+    uint64_t num_bytes()const;
+    std::string str()const;
+    void calculate_intersection_with(
+        const Ray* ray,
+        std::vector<Intersection> *intersections)const;
+
+ private:
+    void assert_faces_refer_to_vertices()const;
+    uint32_t build_node(const uint32_t begin, const uint32_t end);
+    Vec3 centroid(const Face &face)const;
+    Vec3 normal(const Face &face)const;
+};
+
+}  // namespace merlict
+
+#endif  // SCENERY_PRIMITIVE_TRIANGLEMESH_H_
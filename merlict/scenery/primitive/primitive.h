@@ -8,14 +8,18 @@
 #include "Cylinder.h"
 #include "Disc.h"
 #include "EllipticalCapWithHexagonalBound.h"
+#include "HexGridArray.h"
 #include "HexPlane.h"
+#include "InstanceArray.h"
 #include "Plane.h"
 #include "PlaneDualSphericalBound.h"
 #include "RectangularBox.h"
+#include "SegmentedReflector.h"
 #include "Sphere.h"
 #include "SphereCapWithCylinderBound.h"
 #include "SphereCapWithHexagonalBound.h"
 #include "SphereCapWithRectangularBound.h"
 #include "Triangle.h"
+#include "TriangleMesh.h"
 
 #endif  // SCENERY_PRIMITIVE_PRIMITIVE_H_
@@ -7,6 +7,7 @@
 #include "ColorMap.h"
 #include "FunctionMap.h"
 #include "SensorMap.h"
+#include "SurfaceTableMap.h"
 #include "Scenery.h"
 
 #include "geometry/geometry.h"
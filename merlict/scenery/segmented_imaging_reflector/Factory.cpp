@@ -1,6 +1,6 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict/scenery/segmented_imaging_reflector/Factory.h"
-#include "merlict/scenery/primitive/SphereCapWithHexagonalBound.h"
+#include "merlict/scenery/primitive/SegmentedReflector.h"
 
 
 namespace merlict {
@@ -12,18 +12,22 @@ Factory::Factory(const Config ncfg):
 {}
 
 void Factory::add_to_SurfaceEntity(SurfaceEntity* reflector) {
+    // All facets are in one primitive, which finds the few facets a ray
+    // can hit on their lattice.
+    SegmentedReflector* facets = reflector->add<SegmentedReflector>();
+    facets->set_name_pos_rot("mirror_facets", VEC3_ORIGIN, ROT3_UNITY);
+    facets->adopt_surface(reflector);
+    facets->set_lattice_and_outer_hex_radius(
+        geometry.facet_lattice_unit_a(),
+        geometry.facet_lattice_unit_b(),
+        geometry.facet_outer_hex_radius());
+
     std::vector<Vec3> facet_positions = geometry.facet_positions();
     for (unsigned int i = 0; i < facet_positions.size(); i++) {
-        SphereCapWithHexagonalBound* facet =
-            reflector->add<SphereCapWithHexagonalBound>();
-        facet->set_name_pos_rot(
-            "mirror_facet_" + std::to_string(i),
+        facets->add_facet(
             facet_positions.at(i),
-            geometry.get_rotation_for_facet_position(facet_positions.at(i)));
-        facet->set_curvature_radius_and_outer_hex_radius(
-            geometry.focal_length()*2.0,
-            geometry.facet_outer_hex_radius());
-        facet->adopt_surface(reflector);
+            geometry.get_rotation_for_facet_position(facet_positions.at(i)),
+            geometry.focal_length()*2.0);
     }
 }
 
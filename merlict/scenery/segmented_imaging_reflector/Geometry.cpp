@@ -30,9 +30,8 @@ void Geometry::init_facet_xy_positions() {
         min_inner_aperture_radius() + facet_spacing()/2.0;
 
     if (cfg.outer_aperture_shape_hex == 1) {
-        const Vec3 UNIT_HEX_B = VEC3_UNIT_Y*facet_spacing();
-        const Vec3 UNIT_HEX_A = (
-            VEC3_UNIT_Y*0.5 + VEC3_UNIT_X*sqrt(3.0)/2.0)*facet_spacing();
+        const Vec3 UNIT_HEX_B = facet_lattice_unit_b();
+        const Vec3 UNIT_HEX_A = facet_lattice_unit_a();
 
         const Vec3 UNIT_U = VEC3_UNIT_X;
         const Vec3 UNIT_V =
@@ -212,6 +211,14 @@ double Geometry::facet_spacing()const {
     return facet_inner_hex_radius()*2.0 + gap_between_facets();
 }
 
+Vec3 Geometry::facet_lattice_unit_a()const {
+    return (VEC3_UNIT_Y*0.5 + VEC3_UNIT_X*sqrt(3.0)/2.0)*facet_spacing();
+}
+
+Vec3 Geometry::facet_lattice_unit_b()const {
+    return VEC3_UNIT_Y*facet_spacing();
+}
+
 double Geometry::naive_f_over_D()const {
     return focal_length()/(2.0*max_outer_aperture_radius());
 }
@@ -38,6 +38,9 @@ class Geometry {
     double DaviesCotton_weight()const;
     double Parabolic_weight()const;
     double facet_spacing()const;
+    // The facets are centered on the lattice spanned by unit a and b.
+    Vec3 facet_lattice_unit_a()const;
+    Vec3 facet_lattice_unit_b()const;
     double naive_f_over_D()const;
     double effective_f_over_D()const;
     double naive_area()const;
@@ -1,33 +1,329 @@
 // Copyright 2015 Sebastian A. Mueller
 #include "merlict/scenery/stereo_litography.h"
-#include "merlict/scenery/primitive/Triangle.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <thread>
+#include "merlict/MemoryMap.h"
 
 
 namespace merlict {
 namespace stereo_litography {
 
+namespace {
+
+const uint64_t STL_HEADER_SIZE_BYTES = 80;
+const uint64_t STL_FACET_SIZE_BYTES = 50;
+// Smaller files are decoded in a single thread.
+const uint32_t MIN_FACETS_IN_CHUNK = 1u << 14;
+
+struct Chunk {
+    uint32_t begin;
+    uint32_t end;
+    // The kept facets are moved to the front of the chunk.
+    uint32_t num_kept = 0;
+    uint32_t num_bad_normal = 0;
+    uint32_t num_bad_attribute_count = 0;
+};
+
+// Writes the 9 floats of the vertices of each facet in the chunk to
+// positions. The records are not aligned, so they are copied.
+void decode_chunk(
+    const uint8_t* records,
+    float* positions,
+    Chunk* chunk
+) {
+    for (uint32_t i = chunk->begin; i < chunk->end; i++) {
+        const uint8_t* record = records + i*STL_FACET_SIZE_BYTES;
+        float f[12];
+        memcpy(f, record, sizeof(f));
+        uint16_t attribute_byte_count;
+        memcpy(
+            &attribute_byte_count,
+            record + sizeof(f),
+            sizeof(attribute_byte_count));
+        if (attribute_byte_count != 0)
+            chunk->num_bad_attribute_count++;
+
+        const Vec3 n(f[0], f[1], f[2]);
+        const double norm = n.norm();
+        if (norm != 0.0 && fabs(norm - 1.0) > 1e-3)
+            chunk->num_bad_normal++;
+
+        const Vec3 a(f[3], f[4], f[5]);
+        const Vec3 b(f[6], f[7], f[8]);
+        const Vec3 c(f[9], f[10], f[11]);
+        const Vec3 winding = (b - a).cross(c - a);
+        // also drops facets with nan
+        if (!(winding.norm() > 0.0))
+            continue;
+        if (winding*n < 0.0) {
+            for (unsigned int k = 0; k < 3; k++)
+                std::swap(f[6 + k], f[9 + k]);
+        }
+        float* position = positions +
+            9u*static_cast<uint64_t>(chunk->begin + chunk->num_kept);
+        memcpy(position, f + 3, 9*sizeof(float));
+        chunk->num_kept++;
+    }
+}
+
+uint32_t bits_of(const float v) {
+    // -0.0 and 0.0 are the same vertex
+    const float w = v == 0.0f ? 0.0f : v;
+    uint32_t bits;
+    memcpy(&bits, &w, sizeof(bits));
+    return bits;
+}
+
+// Finds equal vertices by their bits with open addressing. A slot holds
+// the index of its vertex plus one, or zero when it is empty.
+class VertexTable {
+    std::vector<float>* vertices;
+    std::vector<uint32_t> slots;
+    uint32_t num_vertices = 0;
+
+ public:
+    VertexTable(std::vector<float>* _vertices, const uint64_t expected_size):
+        vertices(_vertices) {
+        uint64_t capacity = 1024;
+        while (capacity < 2*expected_size)
+            capacity *= 2;
+        slots.resize(capacity, 0u);
+        vertices->reserve(3*expected_size);
+    }
+
+    uint32_t index_of(const float* p) {
+        if (2u*(num_vertices + 1u) > slots.size())
+            grow();
+        const uint32_t key[3] = {bits_of(p[0]), bits_of(p[1]), bits_of(p[2])};
+        uint64_t slot = hash(key);
+        while (slots[slot] != 0u) {
+            const uint32_t index = slots[slot] - 1u;
+            if (is_equal(index, key))
+                return index;
+            slot = (slot + 1u) & (slots.size() - 1u);
+        }
+        vertices->insert(vertices->end(), p, p + 3);
+        slots[slot] = ++num_vertices;
+        return num_vertices - 1u;
+    }
+
+ private:
+    uint64_t hash(const uint32_t key[3])const {
+        uint64_t h = key[0];
+        h = h*0x9E3779B97F4A7C15ull ^ key[1];
+        h = h*0x9E3779B97F4A7C15ull ^ key[2];
+        h = h*0x9E3779B97F4A7C15ull;
+        return (h ^ (h >> 32)) & (slots.size() - 1u);
+    }
+
+    bool is_equal(const uint32_t index, const uint32_t key[3])const {
+        const float* v = &(*vertices)[3u*index];
+        return
+            bits_of(v[0]) == key[0] &&
+            bits_of(v[1]) == key[1] &&
+            bits_of(v[2]) == key[2];
+    }
+
+    void grow() {
+        slots.assign(2*slots.size(), 0u);
+        for (uint32_t index = 0; index < num_vertices; index++) {
+            const float* v = &(*vertices)[3u*index];
+            const uint32_t key[3] = {
+                bits_of(v[0]), bits_of(v[1]), bits_of(v[2])};
+            uint64_t slot = hash(key);
+            while (slots[slot] != 0u)
+                slot = (slot + 1u) & (slots.size() - 1u);
+            slots[slot] = index + 1u;
+        }
+    }
+};
+
+// All facets go into one mesh, which is centered in the box around its
+// vertices.
+TriangleMesh* add_mesh(
+    const Mesh &stl,
+    Frame* mother,
+    const double scale
+) {
+    const double inf = std::numeric_limits<double>::infinity();
+    Vec3 lower(inf, inf, inf);
+    Vec3 upper(-inf, -inf, -inf);
+    std::vector<Vec3> vertices;
+    vertices.reserve(stl.num_vertices());
+    for (uint64_t i = 0; i < stl.num_vertices(); i++) {
+        const Vec3 v = Vec3(
+            stl.vertices[3*i + 0],
+            stl.vertices[3*i + 1],
+            stl.vertices[3*i + 2])*scale;
+        lower = Vec3(
+            std::min(lower.x, v.x),
+            std::min(lower.y, v.y),
+            std::min(lower.z, v.z));
+        upper = Vec3(
+            std::max(upper.x, v.x),
+            std::max(upper.y, v.y),
+            std::max(upper.z, v.z));
+        vertices.push_back(v);
+    }
+    const Vec3 center = vertices.size() > 0 ?
+        (lower + upper)*0.5 : VEC3_ORIGIN;
+    for (Vec3 &v : vertices)
+        v = v - center;
+
+    TriangleMesh* mesh = mother->add<TriangleMesh>();
+    mesh->set_name_pos_rot("mesh", center, ROT3_UNITY);
+    mesh->set_vertices_and_faces(vertices, stl.faces);
+    return mesh;
+}
+
+void warn_about_bad_facets(const std::string &path, const Mesh &stl) {
+    std::stringstream out;
+    out << "___Warning___\n";
+    out << __FILE__ << " " << __func__ << "(path) " << __LINE__ << "\n";
+    out << "In STL file '" << path << "':\n";
+    out << stl.get_report();
+    std::cerr << out.str();
+}
+
+}  // namespace
+
+uint64_t Mesh::num_vertices()const {
+    return vertices.size()/3;
+}
+
+bool Mesh::has_bad_facets()const {
+    return
+        num_degenerate_facets > 0 ||
+        num_facets_with_bad_normal > 0 ||
+        num_facets_with_bad_attribute_count > 0;
+}
+
+std::string Mesh::get_report()const {
+    std::stringstream out;
+    out << num_facets << " facets, ";
+    out << faces.size() << " faces, ";
+    out << num_vertices() << " vertices\n";
+    if (num_degenerate_facets > 0) {
+        out << num_degenerate_facets << " facets have no area ";
+        out << "and are dropped.\n";
+    }
+    if (num_facets_with_bad_normal > 0) {
+        out << num_facets_with_bad_normal << " facets have a normal ";
+        out << "which is not normalized.\n";
+    }
+    if (num_facets_with_bad_attribute_count > 0) {
+        out << num_facets_with_bad_attribute_count << " facets have ";
+        out << "an attribute_byte_count which is not zero.\n";
+    }
+    return out.str();
+}
+
+Mesh read_mesh(const std::string &path) {
+    std::unique_ptr<MemoryMap> map;
+    try {
+        map = std::unique_ptr<MemoryMap>(new MemoryMap(path));
+    } catch (std::runtime_error &error) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "read_mesh: Unable to open file: '" << path << "'\n";
+        info << error.what();
+        throw BinaryIo::CanNotReadFile(info.str());
+    }
+
+    const uint64_t body_begin = STL_HEADER_SIZE_BYTES + sizeof(uint32_t);
+    if (map->size() < body_begin) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "read_mesh: Unable to read file: '" << path << "'\n";
+        info << "Expected at least " << body_begin << " bytes of header, ";
+        info << "but actual the file has " << map->size() << " bytes.\n";
+        throw BinaryIo::CanNotReadFile(info.str());
+    }
+    const std::string header(
+        reinterpret_cast<const char*>(map->data()), STL_HEADER_SIZE_BYTES);
+    if (txt::is_equal("solid", header.substr(0, 5))) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "read_mesh: Unable to read file: '" << path << "'\n";
+        info << "Expected binary file, but actual header ";
+        info << "implies ascii format.\n";
+        throw BinaryIo::CanNotReadAscii(info.str());
+    }
+
+    Mesh stl;
+    memcpy(
+        &stl.num_facets,
+        map->data() + STL_HEADER_SIZE_BYTES,
+        sizeof(stl.num_facets));
+    const uint64_t expected_size =
+        body_begin + stl.num_facets*STL_FACET_SIZE_BYTES;
+    if (map->size() < expected_size) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "read_mesh: Unable to read file: '" << path << "'\n";
+        info << "Expected " << expected_size << " bytes for ";
+        info << stl.num_facets << " facets, ";
+        info << "but actual the file has " << map->size() << " bytes.\n";
+        throw BinaryIo::CanNotReadFile(info.str());
+    }
+
+    const uint8_t* records = map->data() + body_begin;
+    std::vector<float> positions(9u*static_cast<uint64_t>(stl.num_facets));
+    const uint32_t num_chunks = std::max(
+        1u,
+        std::min(
+            std::thread::hardware_concurrency(),
+            stl.num_facets/MIN_FACETS_IN_CHUNK));
+    std::vector<Chunk> chunks(num_chunks);
+    for (uint32_t c = 0; c < num_chunks; c++) {
+        chunks[c].begin = static_cast<uint64_t>(stl.num_facets)*c/num_chunks;
+        chunks[c].end =
+            static_cast<uint64_t>(stl.num_facets)*(c + 1)/num_chunks;
+    }
+    std::vector<std::thread> threads;
+    for (uint32_t c = 1; c < num_chunks; c++)
+        threads.emplace_back(
+            decode_chunk, records, positions.data(), &chunks[c]);
+    decode_chunk(records, positions.data(), &chunks[0]);
+    for (std::thread &thread : threads)
+        thread.join();
+
+    // A closed surface has about half as many vertices as facets.
+    VertexTable vertex_table(&stl.vertices, stl.num_facets/2u);
+    stl.faces.reserve(stl.num_facets);
+    for (const Chunk &chunk : chunks) {
+        stl.num_degenerate_facets += chunk.end - chunk.begin - chunk.num_kept;
+        stl.num_facets_with_bad_normal += chunk.num_bad_normal;
+        stl.num_facets_with_bad_attribute_count +=
+            chunk.num_bad_attribute_count;
+        for (uint32_t i = chunk.begin; i < chunk.begin + chunk.num_kept; i++) {
+            const float* p = &positions[9u*static_cast<uint64_t>(i)];
+            stl.faces.push_back({
+                vertex_table.index_of(p),
+                vertex_table.index_of(p + 3),
+                vertex_table.index_of(p + 6)});
+        }
+    }
+    stl.vertices.shrink_to_fit();
+    return stl;
+}
+
 void add_stl_to_and_inherit_surface_from_surfac_entity(
     const std::string path,
     SurfaceEntity* proto,
     const double scale
 ) {
-    BinaryReader reader(path);
-    std::vector<Facet> facets = reader.get_facets();
-    unsigned int facet_count = 0;
-    for (Facet facet : facets) {
-        Triangle* tri = proto->add<Triangle>();
-        tri->set_name_pos_rot(
-            "triangle_"+std::to_string(facet_count++),
-            VEC3_ORIGIN,
-            ROT3_UNITY);
-        tri->set_normal_and_3_vertecies(
-            facet.n,
-            facet.a*scale,
-            facet.b*scale,
-            facet.c*scale);
-        tri->adopt_surface(proto);
-    }
+    const Mesh stl = read_mesh(path);
+    if (stl.has_bad_facets())
+        warn_about_bad_facets(path, stl);
+    TriangleMesh* mesh = add_mesh(stl, proto, scale);
+    mesh->adopt_surface(proto);
 }
 
 void add_stl_to_frame(
@@ -35,23 +331,12 @@ void add_stl_to_frame(
     Frame* proto,
     const double scale
 ) {
-    BinaryReader reader(path);
-    std::vector<Facet> facets = reader.get_facets();
-    unsigned int facet_count = 0;
-    for (Facet facet : facets) {
-        Triangle* tri = proto->add<Triangle>();
-        tri->set_name_pos_rot(
-            "triangle_"+std::to_string(facet_count++),
-            VEC3_ORIGIN,
-            ROT3_UNITY);
-        tri->set_normal_and_3_vertecies(
-            facet.n,
-            facet.a*scale,
-            facet.b*scale,
-            facet.c*scale);
-        tri->outer_color = &COLOR_GRAY;
-        tri->inner_color = &COLOR_DARK_GRAY;
-    }
+    const Mesh stl = read_mesh(path);
+    if (stl.has_bad_facets())
+        warn_about_bad_facets(path, stl);
+    TriangleMesh* mesh = add_mesh(stl, proto, scale);
+    mesh->outer_color = &COLOR_GRAY;
+    mesh->inner_color = &COLOR_DARK_GRAY;
 }
 
 
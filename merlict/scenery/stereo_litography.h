@@ -2,12 +2,14 @@
 #ifndef SCENERY_STEREOLITOGRAPHY_STEREOLITOGRAPHY_H_
 #define SCENERY_STEREOLITOGRAPHY_STEREOLITOGRAPHY_H_
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <fstream>
 #include "merlict/merlict.h"
 #include "merlict/Frame.h"
 #include "merlict/SurfaceEntity.h"
+#include "merlict/scenery/primitive/TriangleMesh.h"
 
 namespace merlict {
 namespace stereo_litography {
@@ -60,6 +62,31 @@ struct Facet {
     Vec3 c;
 };
 
+//--------------------------------
+// MESH READER
+//--------------------------------
+
+// The facets of a binary STL file with shared vertices. The vertices of a
+// face run counter clockwise around the normal of its facet in the file.
+struct Mesh {
+    // x, y, z of each vertex
+    std::vector<float> vertices;
+    std::vector<TriangleMesh::Face> faces;
+    uint32_t num_facets = 0;
+    // Facets without area, which are not in the faces.
+    uint32_t num_degenerate_facets = 0;
+    // Normals which are neither normalized nor zero.
+    uint32_t num_facets_with_bad_normal = 0;
+    uint32_t num_facets_with_bad_attribute_count = 0;
+    uint64_t num_vertices()const;
+    bool has_bad_facets()const;
+    std::string get_report()const;
+};
+
+// The file is mapped into memory and its facets are decoded in parallel
+// chunks. Equal vertices are merged into one.
+Mesh read_mesh(const std::string &path);
+
 //--------------------------------
 // BINARY IO
 //--------------------------------
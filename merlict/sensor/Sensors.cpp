@@ -85,6 +85,15 @@ void Sensors::clear_history() {
         sensor->photon_arrival_history.clear();
 }
 
+void Sensors::clear_history(const uint64_t max_capacity) {
+    for (Sensor* sensor : by_occurence) {
+        if (sensor->photon_arrival_history.capacity() > max_capacity)
+            std::vector<PhotonArrival>().swap(sensor->photon_arrival_history);
+        else
+            sensor->photon_arrival_history.clear();
+    }
+}
+
 void Sensors::assert_no_two_sensors_have_same_frame()const {
     for (unsigned int i = 1; i < by_frame.size(); i++) {
         if (by_frame.at(i)->frame == by_frame.at(i-1)->frame) {
@@ -2,6 +2,7 @@
 #ifndef PHOTONSENSOR_SENSORS_H_
 #define PHOTONSENSOR_SENSORS_H_
 
+#include <stdint.h>
 #include <vector>
 #include <stdexcept>
 #include "merlict/sensor/Sensor.h"
@@ -34,6 +35,8 @@ class Sensors {
     void assign_photon(const Photon* photon);
     void assign_photons(const std::vector<Photon> *photons);
     void clear_history();
+    // Also releases the memory of histories which grew beyond max_capacity.
+    void clear_history(const uint64_t max_capacity);
 
  private:
     void assert_no_two_sensors_have_same_frame()const;
@@ -0,0 +1,153 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <string>
+#include "catch.hpp"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+
+namespace {
+
+// The lens assembled from two sphere caps and six walls.
+void add_assembled_lens(
+    ml::Frame* mother,
+    const ml::SurfaceEntity* surface,
+    const double curvature_radius,
+    const double outer_radius
+) {
+    ml::Frame* lens = mother->add<ml::Frame>();
+    lens->set_name_pos_rot("assembled", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    const double cap_hight = curvature_radius -
+        sqrt(curvature_radius*curvature_radius - outer_radius*outer_radius);
+
+    ml::SphereCapWithHexagonalBound* front_cap =
+        lens->add<ml::SphereCapWithHexagonalBound>();
+    front_cap->set_name_pos_rot(
+        "front_cap", ml::Vec3(0.0, 0.0, -cap_hight), ml::ROT3_UNITY);
+    front_cap->adopt_surface_inside_out(surface);
+    front_cap->set_curvature_radius_and_outer_hex_radius(
+        curvature_radius, outer_radius);
+    front_cap->set_allowed_frames_to_propagate_to(lens);
+
+    ml::SphereCapWithHexagonalBound* rear_cap =
+        lens->add<ml::SphereCapWithHexagonalBound>();
+    rear_cap->set_name_pos_rot(
+        "rear_cap", ml::Vec3(0.0, 0.0, cap_hight), ml::Rot3(M_PI, 0.0, 0.0));
+    rear_cap->adopt_surface_inside_out(surface);
+    rear_cap->set_curvature_radius_and_outer_hex_radius(
+        curvature_radius, outer_radius);
+    rear_cap->set_allowed_frames_to_propagate_to(lens);
+
+    const double inner_radius = outer_radius*sqrt(3.0)/2.0;
+    const double hight = 2.0*(
+        cap_hight +
+        sqrt(curvature_radius*curvature_radius - inner_radius*inner_radius) -
+        curvature_radius);
+    for (unsigned int i = 0; i < 6; i++) {
+        const double phi = static_cast<double>(i)*1.0/3.0*M_PI;
+        ml::PlaneDualSphericalBound* wall =
+            lens->add<ml::PlaneDualSphericalBound>();
+        wall->set_name_pos_rot(
+            "wall_" + std::to_string(i),
+            ml::Vec3(inner_radius*sin(phi), inner_radius*cos(phi), 0.0),
+            ml::Rot3(M_PI*0.5, M_PI*0.5, phi));
+        wall->set_x_hight_and_y_width(hight, outer_radius);
+        wall->outer_color = &ml::COLOR_GREEN;
+        wall->inner_color = &ml::COLOR_GREEN;
+    }
+}
+
+}  // namespace
+
+TEST_CASE("BiConvexLensHexBoundTest: same_as_assembled_lens", "[merlict]") {
+    const double curvature_radius = 0.2;
+    const double outer_radius = 0.1;
+    const double wavelength = 433e-9;
+    const ml::function::Func1 refraction({{200e-9, 1.49}, {1200e-9, 1.49}});
+
+    ml::SurfaceEntity surface;
+    surface.outer_color = &ml::COLOR_RED;
+    surface.inner_color = &ml::COLOR_BLUE;
+    surface.inner_refraction = &refraction;
+
+    ml::Frame analytic;
+    analytic.set_name_pos_rot("analytic", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::BiConvexLensHexBound* lens =
+        analytic.add<ml::BiConvexLensHexBound>();
+    lens->set_name_pos_rot("lens", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    lens->adopt_surface(&surface);
+    lens->set_curvature_radius_and_outer_hex_radius(
+        curvature_radius,
+        outer_radius);
+    analytic.init_tree_based_on_mother_child_relations();
+    CHECK(!lens->has_children());
+    CHECK(lens->get_bounding_sphere_radius() == outer_radius);
+
+    ml::Frame assembled;
+    assembled.set_name_pos_rot("assembled", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    add_assembled_lens(&assembled, &surface, curvature_radius, outer_radius);
+    assembled.init_tree_based_on_mother_child_relations();
+
+    ml::random::Mt19937 prng(0);
+    unsigned int num_hits = 0;
+    unsigned int num_wall_hits = 0;
+    for (unsigned int i = 0; i < 20000; i++) {
+        // Half of the rays start inside of the lens.
+        const double start_radius = i%2 == 0 ? 0.3 : 0.01;
+        const ml::Vec3 support(
+            start_radius*(prng.uniform() - 0.5),
+            start_radius*(prng.uniform() - 0.5),
+            start_radius*(prng.uniform() - 0.5));
+        const ml::Vec3 target(
+            0.25*(prng.uniform() - 0.5),
+            0.25*(prng.uniform() - 0.5),
+            0.05*(prng.uniform() - 0.5));
+        const ml::Ray ray(support, target - support);
+
+        const ml::Intersection a =
+            ml::rays_first_intersection_with_frame(&ray, &analytic);
+        const ml::Intersection b =
+            ml::rays_first_intersection_with_frame(&ray, &assembled);
+
+        REQUIRE(a.does_intersect() == b.does_intersect());
+        if (!a.does_intersect())
+            continue;
+        num_hits++;
+        CHECK(a.distance_to_ray_support() ==
+            Approx(b.distance_to_ray_support()).margin(1e-9));
+        CHECK(
+            (a.position_in_root_frame() - b.position_in_root_frame()).norm()
+            < 1e-9);
+        CHECK(a.boundary_layer_is_transparent() ==
+            b.boundary_layer_is_transparent());
+        CHECK(a.facing_color() == b.facing_color());
+        CHECK(a.refractive_index_coming_from(wavelength) ==
+            b.refractive_index_coming_from(wavelength));
+        CHECK(a.refractive_index_going_to(wavelength) ==
+            b.refractive_index_going_to(wavelength));
+        if (a.boundary_layer_is_transparent()) {
+            const ml::Vec3 a_normal = a.object2root()->orientation(
+                a.surface_normal_of_facing_surface_in_object_frame());
+            const ml::Vec3 b_normal = b.object2root()->orientation(
+                b.surface_normal_of_facing_surface_in_object_frame());
+            CHECK((a_normal - b_normal).norm() < 1e-9);
+            CHECK(
+                a.object()->allowed_frame_to_propagate_to() ==
+                lens);
+        } else {
+            num_wall_hits++;
+            CHECK(a.object()->path_in_tree() == "/lens/walls");
+        }
+    }
+    CHECK(num_hits > 10000u);
+    CHECK(num_wall_hits > 100u);
+}
+
+TEST_CASE("BiConvexLensHexBoundTest: radii_must_be_positive", "[merlict]") {
+    ml::BiConvexLensHexBound lens;
+    CHECK_THROWS_AS(
+        lens.set_curvature_radius_and_outer_hex_radius(0.0, 0.1),
+        std::invalid_argument);
+    CHECK_THROWS_AS(
+        lens.set_curvature_radius_and_outer_hex_radius(1.0, -0.1),
+        std::invalid_argument);
+}
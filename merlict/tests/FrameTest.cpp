@@ -246,3 +246,27 @@ TEST_CASE("FrameTest: removing_a_cild", "[merlict]") {
     isec = ml::rays_first_intersection_with_frame(&ray, &scenery.root);
     CHECK(!isec.does_intersect());
 }
+
+TEST_CASE("FrameTest: world2frame", "[merlict]") {
+    ml::Frame root;
+    root.set_name_pos_rot("root", ml::Vec3(1, 0, 0), ml::ROT3_UNITY);
+    ml::Frame* shifted = root.add<ml::Frame>();
+    shifted->set_name_pos_rot("shifted", ml::Vec3(0, 2, 3), ml::ROT3_UNITY);
+    ml::Frame* rotated = shifted->add<ml::Frame>();
+    rotated->set_name_pos_rot("rotated", ml::Vec3(0, 0, 1), ml::Rot3(0, 0, 1));
+    root.init_tree_based_on_mother_child_relations();
+
+    CHECK(root.world2frame_is_only_translation());
+    CHECK(shifted->world2frame_is_only_translation());
+    CHECK(!rotated->world2frame_is_only_translation());
+    CHECK(*rotated->world2frame() == rotated->frame2world()->inverse());
+
+    const ml::Ray ray(ml::Vec3(0.3, -0.2, 5.0), ml::Vec3(0.1, 0.2, -1.0));
+    for (const ml::Frame* frame : {&root, shifted, rotated}) {
+        ml::Ray expected = ray;
+        expected.transform_inverse(frame->frame2world());
+        const ml::Ray actual = ml::ray_with_respect_to_frame(&ray, frame);
+        CHECK(actual.support() == expected.support());
+        CHECK(actual.direction() == expected.direction());
+    }
+}
@@ -0,0 +1,120 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <vector>
+#include "catch.hpp"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+
+
+TEST_CASE("HexGridArrayTest: positions_on_lattice", "[merlict]") {
+    ml::HexGridAnnulus grid(1.0, 0.1);
+    ml::HexGridArray array;
+    array.set_name_pos_rot("array", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    array.set_lattice(grid.get_unit_a(), grid.get_unit_b());
+    array.set_positions(grid.get_grid());
+    CHECK(array.size() == grid.get_grid().size());
+
+    for (const ml::Vec3 &pos : grid.get_grid()) {
+        int64_t a, b;
+        array.cell_of(pos + ml::Vec3(0.01, -0.02, 0.0), &a, &b);
+        CHECK(array.has_element_at(a, b));
+        CHECK(array.position_of(a, b).distance_to(pos) < 1e-9);
+    }
+    CHECK(!array.has_element_at(1000, 0));
+
+    std::vector<ml::Vec3> off_lattice;
+    off_lattice.push_back(ml::Vec3(0.05, 0.0, 0.0));
+    CHECK_THROWS_AS(array.set_positions(off_lattice), std::invalid_argument);
+    CHECK_THROWS_AS(
+        array.set_lattice(ml::VEC3_UNIT_X, ml::VEC3_UNIT_X),
+        std::invalid_argument);
+}
+
+void intersect_leafs(
+    const ml::Ray* ray,
+    const ml::Frame* frame,
+    std::vector<ml::Intersection> *intersections
+) {
+    if (!frame->has_children()) {
+        const ml::Ray ray_in_leaf = ml::ray_with_respect_to_frame(ray, frame);
+        frame->calculate_intersection_with(&ray_in_leaf, intersections);
+    }
+    for (const ml::Frame* child : *frame->get_children())
+        intersect_leafs(ray, child, intersections);
+}
+
+TEST_CASE("HexGridArrayTest: same_as_individual_frames", "[merlict]") {
+    const double spacing = 0.1;
+    const double hex_radius = spacing/sqrt(3.0);
+    ml::HexGridAnnulus grid(1.0, 0.3, spacing);
+
+    ml::Frame arrayed;
+    arrayed.set_name_pos_rot("arrayed", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::HexGridArray* array = arrayed.add<ml::HexGridArray>();
+    array->set_name_pos_rot(
+        "array", ml::Vec3(0.1, 0.2, 0.3), ml::Rot3(0.1, -0.2, 0.3));
+    array->set_lattice(grid.get_unit_a(), grid.get_unit_b());
+    array->set_positions(grid.get_grid());
+    ml::HexPlane* face = array->add<ml::HexPlane>();
+    face->set_name_pos_rot("face", ml::VEC3_ORIGIN, ml::Rot3(0.0, 0.0, 0.1));
+    face->set_outer_hex_radius(hex_radius);
+    arrayed.init_tree_based_on_mother_child_relations();
+
+    ml::Frame individual;
+    individual.set_name_pos_rot("individual", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::Frame* faces = individual.add<ml::Frame>();
+    faces->set_name_pos_rot(
+        "faces", ml::Vec3(0.1, 0.2, 0.3), ml::Rot3(0.1, -0.2, 0.3));
+    for (unsigned int i = 0; i < grid.get_grid().size(); i++) {
+        ml::HexPlane* f = faces->add<ml::HexPlane>();
+        f->set_name_pos_rot(
+            "face_" + std::to_string(i),
+            grid.get_grid().at(i),
+            ml::Rot3(0.0, 0.0, 0.1));
+        f->set_outer_hex_radius(hex_radius);
+    }
+    individual.init_tree_based_on_mother_child_relations();
+
+    ml::random::Mt19937 prng(0);
+    uint64_t num_hits = 0;
+    for (uint64_t i = 0; i < 5000; i++) {
+        const ml::Vec3 support(
+            prng.uniform()*3.0 - 1.5,
+            prng.uniform()*3.0 - 1.5,
+            prng.uniform()*3.0 - 1.5);
+        ml::Vec3 direction(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5);
+        if (i % 5 == 0)
+            direction.z = 1e-3*direction.z;
+        const ml::Ray ray(support, direction);
+
+        const ml::Intersection a =
+            ml::rays_first_intersection_with_frame(&ray, &arrayed);
+        const ml::Intersection b =
+            ml::rays_first_intersection_with_frame(&ray, &individual);
+        REQUIRE(a.does_intersect() == b.does_intersect());
+
+        // every element is intersected once
+        std::vector<ml::Intersection> array_hits;
+        const ml::Ray ray_in_array = ml::ray_with_respect_to_frame(&ray, array);
+        array->calculate_intersection_with(&ray_in_array, &array_hits);
+        std::vector<ml::Intersection> face_hits;
+        intersect_leafs(&ray, faces, &face_hits);
+        CHECK(array_hits.size() == face_hits.size());
+
+        if (b.does_intersect()) {
+            num_hits++;
+            CHECK(a.object() == face);
+            CHECK(a.distance_to_ray_support() ==
+                Approx(b.distance_to_ray_support()));
+            CHECK(a.position_in_root_frame().distance_to(
+                b.position_in_root_frame()) < 1e-9);
+            CHECK(a.surface_normal_in_root_frame().distance_to(
+                b.surface_normal_in_root_frame()) < 1e-9);
+            CHECK(a.from_outside_to_inside() == b.from_outside_to_inside());
+        }
+    }
+    CHECK(num_hits > 100u);
+}
@@ -99,3 +99,14 @@ TEST_CASE("HomTra3Test: trans_orientation_forth_and_back_only_rot_component_set"
     CHECK(ux_original.y == ux_back.y);
     CHECK(ux_original.z == ux_back.z);
 }
+
+TEST_CASE("HomTra3Test: constexpr", "[merlict]") {
+    constexpr ml::HomTra3 unit;
+    static_assert(
+        unit.position(ml::Vec3(1., 2., 3.)) == ml::Vec3(1., 2., 3.),
+        "unit position");
+    static_assert(
+        (unit*unit.inverse()).translation() == ml::VEC3_ORIGIN,
+        "unit composition");
+    CHECK(unit.rot_z() == ml::VEC3_UNIT_Z);
+}
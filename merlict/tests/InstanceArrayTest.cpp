@@ -0,0 +1,125 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <vector>
+#include "catch.hpp"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+
+
+TEST_CASE("InstanceArrayTest: needs_one_prototype", "[merlict]") {
+    ml::Frame world;
+    world.set_name_pos_rot("world", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::InstanceArray* array = world.add<ml::InstanceArray>();
+    array->set_name_pos_rot("array", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    array->add_instance(ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    CHECK_THROWS_AS(
+        world.init_tree_based_on_mother_child_relations(),
+        std::logic_error);
+}
+
+TEST_CASE("InstanceArrayTest: no_propagation_inside_instances", "[merlict]") {
+    ml::Frame world;
+    world.set_name_pos_rot("world", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::InstanceArray* array = world.add<ml::InstanceArray>();
+    array->set_name_pos_rot("array", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::BiConvexLensHexBound* lens = array->add<ml::BiConvexLensHexBound>();
+    lens->set_name_pos_rot("lens", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    lens->set_curvature_radius_and_outer_hex_radius(1.0, 0.1);
+    array->add_instance(ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    CHECK_THROWS_AS(
+        world.init_tree_based_on_mother_child_relations(),
+        std::logic_error);
+}
+
+TEST_CASE("InstanceArrayTest: same_as_individual_frames", "[merlict]") {
+    ml::random::Mt19937 prng(0);
+    std::vector<ml::Vec3> positions;
+    std::vector<ml::Rot3> rotations;
+    for (unsigned int i = 0; i < 300; i++) {
+        positions.push_back(ml::Vec3(
+            prng.uniform()*4.0 - 2.0,
+            prng.uniform()*4.0 - 2.0,
+            prng.uniform()*0.4 - 0.2));
+        rotations.push_back(ml::Rot3(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform()*2.0*M_PI));
+    }
+    const ml::Vec3 prototype_pos(0.01, 0.02, 0.03);
+    const ml::Rot3 prototype_rot(0.1, 0.0, 0.2);
+
+    ml::Frame instanced;
+    instanced.set_name_pos_rot("instanced", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::InstanceArray* array = instanced.add<ml::InstanceArray>();
+    array->set_name_pos_rot(
+        "array", ml::Vec3(0.1, 0.2, 0.3), ml::Rot3(0.1, -0.2, 0.3));
+    ml::Frame* prototype = array->add<ml::Frame>();
+    prototype->set_name_pos_rot("prototype", prototype_pos, prototype_rot);
+    ml::SphereCapWithHexagonalBound* cap =
+        prototype->add<ml::SphereCapWithHexagonalBound>();
+    cap->set_name_pos_rot("cap", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    cap->set_curvature_radius_and_outer_hex_radius(2.0, 0.1);
+    ml::Disc* disc = prototype->add<ml::Disc>();
+    disc->set_name_pos_rot("disc", ml::Vec3(0.0, 0.0, 0.05), ml::ROT3_UNITY);
+    disc->set_radius(0.02);
+    for (unsigned int i = 0; i < positions.size(); i++)
+        array->add_instance(positions.at(i), rotations.at(i));
+    instanced.init_tree_based_on_mother_child_relations();
+    CHECK(array->size() == positions.size());
+    CHECK(array->num_nodes() > 1u);
+
+    ml::Frame individual;
+    individual.set_name_pos_rot("individual", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::Frame* group = individual.add<ml::Frame>();
+    group->set_name_pos_rot(
+        "group", ml::Vec3(0.1, 0.2, 0.3), ml::Rot3(0.1, -0.2, 0.3));
+    for (unsigned int i = 0; i < positions.size(); i++) {
+        ml::Frame* placement = group->add<ml::Frame>();
+        placement->set_name_pos_rot(
+            "placement_" + std::to_string(i),
+            positions.at(i),
+            rotations.at(i));
+        ml::Frame* proto = placement->add<ml::Frame>();
+        proto->set_name_pos_rot("prototype", prototype_pos, prototype_rot);
+        ml::SphereCapWithHexagonalBound* c =
+            proto->add<ml::SphereCapWithHexagonalBound>();
+        c->set_name_pos_rot("cap", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+        c->set_curvature_radius_and_outer_hex_radius(2.0, 0.1);
+        ml::Disc* d = proto->add<ml::Disc>();
+        d->set_name_pos_rot("disc", ml::Vec3(0.0, 0.0, 0.05), ml::ROT3_UNITY);
+        d->set_radius(0.02);
+    }
+    individual.init_tree_based_on_mother_child_relations();
+
+    uint64_t num_hits = 0;
+    for (uint64_t i = 0; i < 5000; i++) {
+        const ml::Vec3 support(
+            prng.uniform()*4.0 - 2.0,
+            prng.uniform()*4.0 - 2.0,
+            prng.uniform()*4.0 - 2.0);
+        const ml::Vec3 direction(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5);
+        const ml::Ray ray(support, direction);
+
+        const ml::Intersection a =
+            ml::rays_first_intersection_with_frame(&ray, &instanced);
+        const ml::Intersection b =
+            ml::rays_first_intersection_with_frame(&ray, &individual);
+        REQUIRE(a.does_intersect() == b.does_intersect());
+        if (b.does_intersect()) {
+            num_hits++;
+            CHECK((a.object() == cap || a.object() == disc));
+            CHECK(a.object()->get_name() == b.object()->get_name());
+            CHECK(a.distance_to_ray_support() ==
+                Approx(b.distance_to_ray_support()));
+            CHECK(a.position_in_root_frame().distance_to(
+                b.position_in_root_frame()) < 1e-9);
+            CHECK(a.surface_normal_in_root_frame().distance_to(
+                b.surface_normal_in_root_frame()) < 1e-9);
+            CHECK(a.from_outside_to_inside() == b.from_outside_to_inside());
+        }
+    }
+    CHECK(num_hits > 100u);
+}
@@ -300,3 +300,68 @@ TEST_CASE("PhotonTest: absorbtion_in_medium", "[merlict]") {
     sensors.assign_photons(&photons);
     CHECK(0.367 == Approx(static_cast<double>(collector_sensor.photon_arrival_history.size())/static_cast<double>(num_phot)).margin(2e-2));
 }
+
+TEST_CASE("PhotonTest: bunches_propagate_like_single_photons", "[merlict]") {
+    // Photons run down onto a half reflecting glass surface. The reflected
+    // ones are absorbed on the roof, the refracted ones in the void below.
+    ml::Scenery scenery;
+    scenery.functions.add("half", ml::function::Func1(
+        {{200e-9, 0.5}, {1200e-9, 0.5}}));
+    scenery.functions.add("glass", ml::function::Func1(
+        {{200e-9, 1.5}, {1200e-9, 1.5}}));
+    ml::Disc* glass = scenery.root.add<ml::Disc>();
+    glass->set_name_pos_rot("glass", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    glass->set_radius(10.0);
+    glass->outer_reflection = scenery.functions.get("half");
+    glass->inner_refraction = scenery.functions.get("glass");
+    ml::Disc* roof = scenery.root.add<ml::Disc>();
+    roof->set_name_pos_rot("roof", ml::Vec3(0.0, 0.0, 2.0), ml::ROT3_UNITY);
+    roof->set_radius(10.0);
+    scenery.root.init_tree_based_on_mother_child_relations();
+
+    const unsigned int num_bunches = 1000;
+    const unsigned int bunch_size = 10;
+    std::vector<ml::Photon> photons;
+    ml::random::Mt19937 prng(0u);
+    for (unsigned int i = 0; i < num_bunches; i++) {
+        const ml::Vec3 support(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            1.0);
+        const ml::Vec3 direction(0.1*prng.uniform(), 0.0, -1.0);
+        for (unsigned int j = 0; j < bunch_size; j++)
+            photons.push_back(ml::Photon(support, direction, 433e-9));
+    }
+    CHECK(ml::start_the_same(photons.at(0), photons.at(bunch_size - 1)));
+    CHECK(!ml::start_the_same(photons.at(0), photons.at(bunch_size)));
+
+    std::vector<ml::Photon> singles = photons;
+    std::vector<ml::Photon> bunches = photons;
+    ml::PropagationConfig setup;
+    ml::propagate_photons_in_frame_with_config(
+        &singles, &scenery.root, &setup, &prng);
+    setup.propagate_bunches_together = true;
+    ml::propagate_photons_in_frame_with_config(
+        &bunches, &scenery.root, &setup, &prng);
+
+    unsigned int singles_on_roof = 0;
+    unsigned int bunches_on_roof = 0;
+    for (unsigned int i = 0; i < photons.size(); i++) {
+        if (singles.at(i).final_intersection().object() == roof)
+            singles_on_roof++;
+        if (bunches.at(i).final_intersection().object() == roof) {
+            bunches_on_roof++;
+            CHECK(bunches.at(i).num_interactions() == 3u);
+        } else {
+            CHECK(bunches.at(i).final_interaction() ==
+                ml::ABSORPTION_IN_VOID);
+            CHECK(bunches.at(i).num_interactions() == 3u);
+        }
+    }
+    // half reflected plus the Fresnel reflection of the other half
+    const double expected = 0.5 + 0.5*0.04;
+    CHECK(singles_on_roof/static_cast<double>(photons.size()) ==
+        Approx(expected).margin(0.02));
+    CHECK(bunches_on_roof/static_cast<double>(photons.size()) ==
+        Approx(expected).margin(0.02));
+}
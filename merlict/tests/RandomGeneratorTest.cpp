@@ -212,3 +212,78 @@ TEST_CASE("RandomGeneratorTest: normal_distribution", "[merlict]") {
         }
     }
 }
+
+TEST_CASE("RandomGeneratorTest: scrambled_halton_in_unit_interval", "[merlict]") {
+    ml::random::ScrambledHalton halton(ml::random::MAX_HALTON_DIMENSIONS, 0);
+    for (uint32_t d = 0; d < halton.num_dimensions(); d++) {
+        for (uint64_t i = 0; i < 1000; i++) {
+            const double u = halton.sample(i, d);
+            CHECK(u >= 0.0);
+            CHECK(u < 1.0);
+        }
+        CHECK(halton.sample(0xFFFFFFFFFFFFFull, d) < 1.0);
+    }
+    CHECK_THROWS_AS(
+        ml::random::ScrambledHalton(ml::random::MAX_HALTON_DIMENSIONS + 1, 0),
+        std::invalid_argument);
+}
+
+TEST_CASE("RandomGeneratorTest: scrambled_halton_is_deterministic", "[merlict]") {
+    ml::random::ScrambledHalton a(4, 1337);
+    ml::random::ScrambledHalton b(4, 1337);
+    ml::random::ScrambledHalton c(4, 1338);
+    bool all_equal_to_c = true;
+    for (uint64_t i = 1000; i > 0; i--) {
+        for (uint32_t d = 0; d < 4; d++) {
+            CHECK(a.sample(i, d) == b.sample(i, d));
+            all_equal_to_c = all_equal_to_c && a.sample(i, d) == c.sample(i, d);
+        }
+    }
+    CHECK(!all_equal_to_c);
+}
+
+TEST_CASE("RandomGeneratorTest: scrambled_halton_stratifies", "[merlict]") {
+    // The first base^k points fall one into each interval of width base^-k,
+    // here for the bases 2 and 3.
+    ml::random::ScrambledHalton halton(2, 42);
+    const uint32_t num_points[2] = {1024, 729};
+    for (uint32_t d = 0; d < 2; d++) {
+        std::vector<uint32_t> hits(num_points[d], 0u);
+        for (uint64_t i = 0; i < num_points[d]; i++)
+            hits.at(halton.sample(i, d)*num_points[d])++;
+        for (const uint32_t h : hits)
+            CHECK(h == 1u);
+    }
+}
+
+TEST_CASE("RandomGeneratorTest: scrambled_halton_integrates_better", "[merlict]") {
+    ml::random::ScrambledHalton halton(4, 7);
+    ml::random::Mt19937 prng(7);
+    const uint64_t n = 4096;
+    double qmc = 0.0;
+    double mc = 0.0;
+    for (uint64_t i = 0; i < n; i++) {
+        ml::random::QuasiRandom qrng(&halton, i, 0);
+        double q = 1.0;
+        double m = 1.0;
+        for (uint32_t d = 0; d < 4; d++) {
+            q *= qrng.uniform();
+            m *= prng.uniform();
+        }
+        qmc += q;
+        mc += m;
+    }
+    const double expected = 1.0/16.0;
+    CHECK(fabs(qmc/n - expected) < 2e-4);
+    CHECK(fabs(qmc/n - expected) < fabs(mc/n - expected));
+}
+
+TEST_CASE("RandomGeneratorTest: quasi_random_pads_pseudo_randomly", "[merlict]") {
+    ml::random::ScrambledHalton halton(2, 0);
+    ml::random::QuasiRandom qrng(&halton, 17, 42);
+    ml::random::Mt19937 padding(42);
+    CHECK(qrng.uniform() == halton.sample(17, 0));
+    CHECK(qrng.uniform() == halton.sample(17, 1));
+    for (unsigned int i = 0; i < 10; i++)
+        CHECK(qrng.uniform() == padding.uniform());
+}
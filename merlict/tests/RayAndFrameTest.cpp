@@ -1,7 +1,9 @@
 // Copyright 2014 Sebastian A. Mueller
 #include <math.h>
+#include <string>
 #include "catch.hpp"
 #include "merlict/RayAndFrame.h"
+#include "merlict/random/Mt19937.h"
 #include "merlict/scenery/primitive/Sphere.h"
 namespace ml = merlict;
 
@@ -121,6 +123,45 @@ TEST_CASE("RayAndFrameBoundingSphereTest: frontal_hits", "[merlict]") {
 
 
 
+TEST_CASE("RayAndFrameBoundingSphereTest: float_culls_no_hit_of_double", "[merlict]") {
+    ml::random::Mt19937 prng(0);
+    unsigned int num_double = 0;
+    unsigned int num_float = 0;
+    for (unsigned int i = 0; i < 100000; i++) {
+        const double radius = pow(10.0, -4.0 + 5.0*prng.uniform());
+        const ml::Vec3 center = ml::Vec3(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5)*pow(10.0, 3.0*prng.uniform());
+        ml::Sphere sphere("sphere", center, ml::ROT3_UNITY);
+        sphere.set_radius(radius);
+        sphere.init_tree_based_on_mother_child_relations();
+
+        // The rays graze the sphere, just inside or just outside of it.
+        const ml::Vec3 direction = ml::Vec3(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5);
+        ml::Vec3 offset = direction.cross(ml::VEC3_UNIT_Z);
+        offset = offset/offset.norm();
+        const double distance = radius*(1.0 + 1e-6*(prng.uniform() - 0.5));
+        const ml::Vec3 support =
+            center + offset*distance - direction*(10.0*prng.uniform() - 2.0);
+        const ml::Ray ray(support, direction);
+
+        const bool in_double =
+            ml::ray_intersects_frames_bounding_sphere<double>(&ray, &sphere);
+        const bool in_float =
+            ml::ray_intersects_frames_bounding_sphere<float>(&ray, &sphere);
+        if (in_double)
+            CHECK(in_float);
+        num_double += in_double;
+        num_float += in_float;
+    }
+    CHECK(num_double > 10000u);
+    CHECK(num_float >= num_double);
+}
+
 TEST_CASE("RayAndFrameTest: transform_into_unit_frame", "[merlict]") {
     ml::Frame frame;
     frame.set_name_pos_rot("frame", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
@@ -203,3 +244,45 @@ TEST_CASE("RayAndFrameTest: causal_intersection", "[merlict]") {
 
     spheres_in_a_row.init_tree_based_on_mother_child_relations();
 }
+
+TEST_CASE("RayAndFrameTest: first_intersection_culled_in_float", "[merlict]") {
+    ml::random::Mt19937 prng(0);
+    ml::Frame spheres;
+    spheres.set_name_pos_rot("spheres", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    for (unsigned int i = 0; i < 500; i++) {
+        ml::Sphere* sphere = spheres.add<ml::Sphere>();
+        sphere->set_name_pos_rot(
+            "sphere_" + std::to_string(i),
+            ml::Vec3(
+                prng.uniform() - 0.5,
+                prng.uniform() - 0.5,
+                prng.uniform() - 0.5)*100.0,
+            ml::ROT3_UNITY);
+        sphere->set_radius(0.01 + 2.0*prng.uniform());
+    }
+    spheres.init_tree_based_on_mother_child_relations();
+
+    unsigned int num_hits = 0;
+    for (unsigned int i = 0; i < 10000; i++) {
+        const ml::Vec3 support = ml::Vec3(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5)*200.0;
+        const ml::Vec3 target = ml::Vec3(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5)*50.0;
+        const ml::Ray ray(support, target - support);
+        const ml::Intersection a =
+            ml::rays_first_intersection_with_frame<double>(&ray, &spheres);
+        const ml::Intersection b =
+            ml::rays_first_intersection_with_frame<float>(&ray, &spheres);
+        REQUIRE(a.does_intersect() == b.does_intersect());
+        if (!a.does_intersect())
+            continue;
+        num_hits++;
+        CHECK(a.object() == b.object());
+        CHECK(a.distance_to_ray_support() == b.distance_to_ray_support());
+    }
+    CHECK(num_hits > 1000u);
+}
@@ -0,0 +1,128 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+#include "merlict/merlict.h"
+#include "merlict/scenery/segmented_imaging_reflector/segmented_imaging_reflector.h"
+namespace ml = merlict;
+namespace sir = merlict::segmented_imaging_reflector;
+
+namespace {
+
+// Each facet in its own frame.
+void add_facet_frames(
+    ml::SurfaceEntity* reflector,
+    const sir::Geometry &geometry
+) {
+    const std::vector<ml::Vec3> positions = geometry.facet_positions();
+    for (unsigned int i = 0; i < positions.size(); i++) {
+        ml::SphereCapWithHexagonalBound* facet =
+            reflector->add<ml::SphereCapWithHexagonalBound>();
+        facet->set_name_pos_rot(
+            "facet_" + std::to_string(i),
+            positions.at(i),
+            geometry.get_rotation_for_facet_position(positions.at(i)));
+        facet->set_curvature_radius_and_outer_hex_radius(
+            geometry.focal_length()*2.0,
+            geometry.facet_outer_hex_radius());
+        facet->adopt_surface(reflector);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("SegmentedReflectorTest: same_as_facet_frames", "[merlict]") {
+    for (int hex_shape = 0; hex_shape <= 1; hex_shape++) {
+        sir::Config cfg;
+        cfg.outer_aperture_shape_hex = hex_shape;
+        const sir::Geometry geometry(cfg);
+
+        ml::Frame lattice;
+        lattice.set_name_pos_rot("lattice", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+        ml::SurfaceEntity* reflector = lattice.add<ml::SurfaceEntity>();
+        reflector->set_name_pos_rot(
+            "reflector", ml::Vec3(0.1, 0.2, 0.3), ml::Rot3(0.1, 0.2, 0.3));
+        sir::Factory factory(cfg);
+        factory.add_to_SurfaceEntity(reflector);
+        lattice.init_tree_based_on_mother_child_relations();
+        REQUIRE(reflector->get_children()->size() == 1u);
+        const ml::SegmentedReflector* facets =
+            dynamic_cast<const ml::SegmentedReflector*>(
+                reflector->get_children()->at(0));
+        REQUIRE(facets != nullptr);
+        CHECK(facets->num_facets() == geometry.num_facets());
+
+        ml::Frame frames;
+        frames.set_name_pos_rot("frames", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+        ml::SurfaceEntity* reference = frames.add<ml::SurfaceEntity>();
+        reference->set_name_pos_rot(
+            "reflector", ml::Vec3(0.1, 0.2, 0.3), ml::Rot3(0.1, 0.2, 0.3));
+        add_facet_frames(reference, geometry);
+        frames.init_tree_based_on_mother_child_relations();
+
+        ml::random::Mt19937 prng(hex_shape);
+        unsigned int num_hits = 0;
+        for (unsigned int i = 0; i < 20000; i++) {
+            // Most rays come from the focal point's side, the others from
+            // anywhere, e.g. behind or beside the dish.
+            const ml::Vec3 support = i%4 != 0 ?
+                ml::Vec3(
+                    6.0*(prng.uniform() - 0.5),
+                    6.0*(prng.uniform() - 0.5),
+                    3.0 + 3.0*prng.uniform()) :
+                ml::Vec3(
+                    12.0*(prng.uniform() - 0.5),
+                    12.0*(prng.uniform() - 0.5),
+                    12.0*(prng.uniform() - 0.5));
+            const ml::Vec3 target(
+                5.0*(prng.uniform() - 0.5),
+                5.0*(prng.uniform() - 0.5),
+                0.3 + 0.5*(prng.uniform() - 0.5));
+            const ml::Ray ray(support, target - support);
+
+            const ml::Intersection a =
+                ml::rays_first_intersection_with_frame(&ray, &lattice);
+            const ml::Intersection b =
+                ml::rays_first_intersection_with_frame(&ray, &frames);
+            REQUIRE(a.does_intersect() == b.does_intersect());
+            if (!a.does_intersect())
+                continue;
+            num_hits++;
+            CHECK(a.distance_to_ray_support() ==
+                Approx(b.distance_to_ray_support()).margin(1e-9));
+            CHECK(
+                (a.position_in_root_frame() - b.position_in_root_frame()).
+                norm() < 1e-9);
+            CHECK(
+                (a.surface_normal_in_root_frame() -
+                b.surface_normal_in_root_frame()).norm() < 1e-9);
+            CHECK(a.from_outside_to_inside() == b.from_outside_to_inside());
+            CHECK(a.facing_color() == b.facing_color());
+        }
+        CHECK(num_hits > 3000u);
+    }
+}
+
+TEST_CASE("SegmentedReflectorTest: facets_on_lattice", "[merlict]") {
+    ml::SegmentedReflector reflector;
+    reflector.set_name_pos_rot("reflector", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    CHECK_THROWS_AS(
+        reflector.set_lattice_and_outer_hex_radius(
+            ml::VEC3_UNIT_X, ml::VEC3_UNIT_X*2.0, 0.5),
+        std::invalid_argument);
+    reflector.set_lattice_and_outer_hex_radius(
+        ml::VEC3_UNIT_X, ml::VEC3_UNIT_Y, 0.5);
+    reflector.add_facet(ml::Vec3(1.0, 2.0, 0.1), ml::ROT3_UNITY, 10.0);
+    CHECK_THROWS_AS(
+        reflector.add_facet(ml::Vec3(0.5, 2.0, 0.0), ml::ROT3_UNITY, 10.0),
+        std::invalid_argument);
+    CHECK_THROWS_AS(
+        reflector.add_facet(ml::Vec3(0.0, 0.0, 0.0), ml::ROT3_UNITY, 0.4),
+        std::invalid_argument);
+    reflector.add_facet(ml::Vec3(1.0, 2.0, 0.3), ml::ROT3_UNITY, 10.0);
+    CHECK(reflector.num_facets() == 2u);
+    CHECK_THROWS_AS(
+        reflector.init_tree_based_on_mother_child_relations(),
+        std::logic_error);
+}
@@ -108,3 +108,22 @@ TEST_CASE("SensorAssignmentTest: sort_sensors_by_brame", "[merlict]") {
         CHECK(by_frame.at(i)->frame < by_frame.at(i+1)->frame);
     }
 }
+
+TEST_CASE("SensorAssignmentTest: clear_history_releases_large_histories", "[merlict]") {
+    ml::Frame car;
+    car.set_name_pos_rot("car", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::Frame duck;
+    duck.set_name_pos_rot("duck", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::sensor::Sensor on_car(0u, &car);
+    ml::sensor::Sensor on_duck(1u, &duck);
+    ml::sensor::Sensors sensors({&on_car, &on_duck});
+
+    on_car.photon_arrival_history.resize(10);
+    on_duck.photon_arrival_history.resize(1000);
+
+    sensors.clear_history(100u);
+    CHECK(on_car.photon_arrival_history.size() == 0u);
+    CHECK(on_car.photon_arrival_history.capacity() >= 10u);
+    CHECK(on_duck.photon_arrival_history.size() == 0u);
+    CHECK(on_duck.photon_arrival_history.capacity() == 0u);
+}
@@ -94,3 +94,98 @@ TEST_CASE("StereoLitographyTest: write_and_read_simple_stl", "[merlict]") {
     ml::stereo_litography::BinaryReader stl_reader(filename);
     CHECK(stl_reader.get_facets().size() == 1u);
 }
+
+TEST_CASE("StereoLitographyTest: read_mesh_of_bad_files", "[merlict]") {
+    CHECK_THROWS_AS(
+        ml::stereo_litography::read_mesh("not_existing_file"),
+        ml::stereo_litography::BinaryIo::CanNotReadFile);
+    CHECK_THROWS_AS(
+        ml::stereo_litography::read_mesh(
+            "merlict/tests/resources/scenery/ascii_format.stl"),
+        ml::stereo_litography::BinaryIo::CanNotReadAscii);
+
+    // The header claims two facets, but only one follows.
+    std::string filename = "merlict/tests/resources/scenery/single_triangle.stl";
+    std::ofstream fout(filename, std::ios::out | std::ios::binary);
+    const std::string header(80, ' ');
+    fout.write(header.c_str(), header.size());
+    const uint32_t num_facets = 2;
+    fout.write(reinterpret_cast<const char*>(&num_facets), sizeof(num_facets));
+    const std::string facet(50, '\0');
+    fout.write(facet.c_str(), facet.size());
+    fout.close();
+    CHECK_THROWS_AS(
+        ml::stereo_litography::read_mesh(filename),
+        ml::stereo_litography::BinaryIo::CanNotReadFile);
+}
+
+TEST_CASE("StereoLitographyTest: read_mesh_shares_vertices", "[merlict]") {
+    const std::string filename =
+        "merlict/tests/resources/scenery/LCCone-simple_parab.stl";
+    const ml::stereo_litography::Mesh mesh =
+        ml::stereo_litography::read_mesh(filename);
+    const std::vector<ml::stereo_litography::Facet> facets =
+        ml::stereo_litography::BinaryReader(filename).get_facets();
+    CHECK(mesh.num_facets == 3692u);
+    REQUIRE(mesh.faces.size() == facets.size());
+    CHECK(!mesh.has_bad_facets());
+    CHECK(mesh.num_vertices() < 3u*facets.size());
+
+    for (uint64_t i = 0; i < facets.size(); i++) {
+        const ml::TriangleMesh::Face &face = mesh.faces[i];
+        const ml::Vec3 a(
+            mesh.vertices[3*face.a + 0],
+            mesh.vertices[3*face.a + 1],
+            mesh.vertices[3*face.a + 2]);
+        const ml::Vec3 b(
+            mesh.vertices[3*face.b + 0],
+            mesh.vertices[3*face.b + 1],
+            mesh.vertices[3*face.b + 2]);
+        const ml::Vec3 c(
+            mesh.vertices[3*face.c + 0],
+            mesh.vertices[3*face.c + 1],
+            mesh.vertices[3*face.c + 2]);
+        CHECK(a == facets[i].a);
+        CHECK((b - a).cross(c - a)*facets[i].n > 0.0);
+        CHECK(a + b + c == facets[i].a + facets[i].b + facets[i].c);
+    }
+}
+
+TEST_CASE("StereoLitographyTest: read_mesh_reports_bad_facets", "[merlict]") {
+    const ml::Vec3 up(0.0, 0.0, 1.0);
+    const ml::Vec3 o(0.0, 0.0, 0.0);
+    const ml::Vec3 x(1.0, 0.0, 0.0);
+    const ml::Vec3 y(0.0, 1.0, 0.0);
+    const ml::Vec3 xy(1.0, 1.0, 0.0);
+    std::vector<ml::stereo_litography::Facet> facets = {
+        {up, o, x, xy},
+        // clockwise around its normal
+        {up, o, y, xy},
+        // not normalized
+        {up*2.0, o, x, y},
+        // no area
+        {up, o, x, x},
+        {up, o, x, x*2.0}};
+
+    std::string filename = "merlict/tests/resources/scenery/single_triangle.stl";
+    ml::stereo_litography::BinaryWriter writer;
+    writer.add_facets(facets);
+    writer.write_to_file(filename);
+
+    const ml::stereo_litography::Mesh mesh =
+        ml::stereo_litography::read_mesh(filename);
+    CHECK(mesh.num_facets == 5u);
+    CHECK(mesh.num_degenerate_facets == 2u);
+    CHECK(mesh.num_facets_with_bad_normal == 1u);
+    CHECK(mesh.num_facets_with_bad_attribute_count == 0u);
+    CHECK(mesh.has_bad_facets());
+    REQUIRE(mesh.faces.size() == 3u);
+    CHECK(mesh.num_vertices() == 4u);
+    // o, x, xy, y
+    CHECK(mesh.faces[0].a == 0u);
+    CHECK(mesh.faces[0].b == 1u);
+    CHECK(mesh.faces[0].c == 2u);
+    CHECK(mesh.faces[1].a == 0u);
+    CHECK(mesh.faces[1].b == 2u);
+    CHECK(mesh.faces[1].c == 3u);
+}
@@ -0,0 +1,159 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <limits>
+#include <vector>
+#include "catch.hpp"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+
+
+TEST_CASE("SurfaceTableTest: uniform_grid", "[merlict]") {
+    CHECK_THROWS_AS(
+        ml::function::UniformGrid(0.0, 1.0, 0u),
+        std::invalid_argument);
+    CHECK_THROWS_AS(
+        ml::function::UniformGrid(1.0, 1.0, 4u),
+        std::invalid_argument);
+
+    const ml::function::UniformGrid grid(0.0, 1.0, 4u);
+    CHECK(grid.num_nodes() == 5u);
+    CHECK(grid.node(0) == 0.0);
+    CHECK(grid.node(2) == 0.5);
+    CHECK(grid.node(4) == 1.0);
+
+    double weight;
+    CHECK(grid.bin(0.0, &weight) == 0u);
+    CHECK(weight == 0.0);
+    CHECK(grid.bin(0.625, &weight) == 2u);
+    CHECK(weight == 0.5);
+    CHECK(grid.bin(nextafter(1.0, 0.0), &weight) == 3u);
+    CHECK(weight == Approx(1.0));
+    CHECK_THROWS_AS(grid.bin(1.0, &weight), std::out_of_range);
+    CHECK_THROWS_AS(grid.bin(-0.1, &weight), std::out_of_range);
+
+    CHECK(ml::function::UniformGrid::interpolate(1.0, 3.0, 0.25) == 1.5);
+    const double inf = std::numeric_limits<double>::infinity();
+    CHECK(ml::function::UniformGrid::interpolate(inf, inf, 0.5) == inf);
+}
+
+TEST_CASE("SurfaceTableTest: sample_function_on_grid", "[merlict]") {
+    const ml::function::UniformGrid grid(0.0, 1.0, 4u);
+    const ml::function::Func1 narrow({{0.0, 0.0}, {0.5, 1.0}});
+    CHECK(!grid.is_covered_by(narrow));
+    CHECK_THROWS_AS(grid.sample(narrow), std::out_of_range);
+
+    const ml::function::Func1 f({{0.0, 0.0}, {0.5, 1.0}, {1.0, 3.0}});
+    CHECK(grid.is_covered_by(f));
+    const std::vector<double> values = grid.sample(f);
+    REQUIRE(values.size() == 5u);
+    CHECK(values[0] == 0.0);
+    CHECK(values[1] == 0.5);
+    CHECK(values[2] == 1.0);
+    CHECK(values[3] == 2.0);
+    // The upper limit itself is excluded from the function.
+    CHECK(values[4] == 3.0);
+}
+
+TEST_CASE("SurfaceTableTest: same_as_functions", "[merlict]") {
+    const ml::function::Func1 reflection({
+        {200e-9, 0.1}, {300e-9, 0.8}, {650e-9, 0.7}, {1200e-9, 0.2}});
+    const ml::function::Func1 refraction({
+        {200e-9, 1.55}, {400e-9, 1.5}, {1200e-9, 1.45}});
+    const ml::function::Func1 absorption({
+        {200e-9, 1.0}, {500e-9, 5.0}, {1200e-9, 8.0}});
+
+    ml::Frame world;
+    world.set_name_pos_rot("world", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::Disc* disc = world.add<ml::Disc>();
+    disc->set_name_pos_rot("disc", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    disc->set_radius(1.0);
+    disc->outer_reflection = &reflection;
+    disc->inner_refraction = &refraction;
+    disc->inner_absorption = &absorption;
+    ml::Disc* twin = world.add<ml::Disc>();
+    twin->set_name_pos_rot("twin", ml::Vec3(0.0, 0.0, -1.0), ml::ROT3_UNITY);
+    twin->set_radius(1.0);
+    twin->adopt_surface(disc);
+    world.init_tree_based_on_mother_child_relations();
+
+    ml::SurfaceTableMap surface_tables;
+    surface_tables.assign_to_surfaces_in(&world);
+    CHECK(surface_tables.num_tables() == 1u);
+    REQUIRE(disc->surface_table != nullptr);
+    CHECK(disc->surface_table == twin->surface_table);
+
+    const ml::Ray ray(ml::Vec3(0.0, 0.0, 1.0), ml::Vec3(0.0, 0.0, -1.0));
+    const ml::Intersection isec =
+        ml::rays_first_intersection_with_frame(&ray, &world);
+    REQUIRE(isec.object() == disc);
+    for (double wavelength = 200e-9; wavelength < 1200e-9; wavelength += 7e-9) {
+        CHECK(isec.facing_reflection_propability(wavelength) ==
+            Approx(reflection.evaluate(wavelength)).margin(1e-12));
+        CHECK(isec.refractive_index_going_to(wavelength) ==
+            Approx(refraction.evaluate(wavelength)).margin(1e-12));
+        CHECK(isec.refractive_index_coming_from(wavelength) == 1.0);
+        CHECK(isec.half_way_depth_going_to(wavelength) ==
+            Approx(absorption.evaluate(wavelength)).margin(1e-12));
+        CHECK(!isfinite(isec.half_way_depth_coming_from(wavelength)));
+    }
+    CHECK_THROWS_AS(
+        isec.facing_reflection_propability(1200e-9),
+        std::out_of_range);
+}
+
+TEST_CASE("SurfaceTableTest: narrow_functions_are_not_sampled", "[merlict]") {
+    const ml::function::Func1 narrow({{300e-9, 0.5}, {700e-9, 0.5}});
+    ml::Frame world;
+    world.set_name_pos_rot("world", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::Disc* disc = world.add<ml::Disc>();
+    disc->set_name_pos_rot("disc", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    disc->set_radius(1.0);
+    disc->outer_reflection = &narrow;
+    ml::Disc* plain = world.add<ml::Disc>();
+    plain->set_name_pos_rot("plain", ml::Vec3(0.0, 0.0, -1.0), ml::ROT3_UNITY);
+    plain->set_radius(1.0);
+    world.init_tree_based_on_mother_child_relations();
+
+    ml::SurfaceTableMap surface_tables;
+    surface_tables.assign_to_surfaces_in(&world);
+    CHECK(surface_tables.num_tables() == 1u);
+    CHECK(disc->surface_table == nullptr);
+    CHECK(plain->surface_table != nullptr);
+
+    const ml::Ray ray(ml::Vec3(0.0, 0.0, 1.0), ml::Vec3(0.0, 0.0, -1.0));
+    const ml::Intersection isec =
+        ml::rays_first_intersection_with_frame(&ray, &world);
+    REQUIRE(isec.object() == disc);
+    CHECK(isec.facing_reflection_propability(500e-9) == 0.5);
+    CHECK_THROWS_AS(
+        isec.facing_reflection_propability(800e-9),
+        std::out_of_range);
+}
+
+TEST_CASE("SurfaceTableTest: wide_functions_beyond_the_grid", "[merlict]") {
+    const ml::function::Func1 wide({
+        {100e-9, 0.2}, {700e-9, 0.6}, {1500e-9, 0.4}});
+    ml::Frame world;
+    world.set_name_pos_rot("world", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::Disc* disc = world.add<ml::Disc>();
+    disc->set_name_pos_rot("disc", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    disc->set_radius(1.0);
+    disc->outer_reflection = &wide;
+    world.init_tree_based_on_mother_child_relations();
+
+    ml::SurfaceTableMap surface_tables;
+    surface_tables.assign_to_surfaces_in(&world);
+    REQUIRE(disc->surface_table != nullptr);
+
+    const ml::Ray ray(ml::Vec3(0.0, 0.0, 1.0), ml::Vec3(0.0, 0.0, -1.0));
+    const ml::Intersection isec =
+        ml::rays_first_intersection_with_frame(&ray, &world);
+    REQUIRE(isec.object() == disc);
+    for (const double wavelength : {150e-9, 450e-9, 1200e-9, 1250e-9}) {
+        CHECK(isec.facing_reflection_propability(wavelength) ==
+            Approx(wide.evaluate(wavelength)).margin(1e-12));
+    }
+    CHECK_THROWS_AS(
+        isec.facing_reflection_propability(1500e-9),
+        std::out_of_range);
+}
@@ -0,0 +1,165 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+#include "merlict/merlict.h"
+#include "merlict/scenery/stereo_litography.h"
+namespace ml = merlict;
+
+
+TEST_CASE("TriangleMeshTest: faces_must_refer_to_vertices", "[merlict]") {
+    ml::TriangleMesh mesh;
+    std::vector<ml::Vec3> vertices = {
+        ml::Vec3(0.0, 0.0, 0.0),
+        ml::Vec3(1.0, 0.0, 0.0),
+        ml::Vec3(0.0, 1.0, 0.0)};
+    std::vector<ml::TriangleMesh::Face> faces = {{0, 1, 3}};
+    CHECK_THROWS_AS(
+        mesh.set_vertices_and_faces(vertices, faces),
+        std::out_of_range);
+    faces[0].c = 2;
+    mesh.set_vertices_and_faces(vertices, faces);
+    CHECK(mesh.num_faces() == 1u);
+    CHECK(mesh.num_nodes() == 1u);
+    CHECK(mesh.get_bounding_sphere_radius() == 1.0);
+}
+
+TEST_CASE("TriangleMeshTest: outer_surface", "[merlict]") {
+    ml::Frame world;
+    world.set_name_pos_rot("world", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::TriangleMesh* mesh = world.add<ml::TriangleMesh>();
+    mesh->set_name_pos_rot("mesh", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    mesh->set_vertices_and_faces(
+        {
+            ml::Vec3(-1.0, -1.0, 0.0),
+            ml::Vec3(1.0, -1.0, 0.0),
+            ml::Vec3(0.0, 1.0, 0.0)
+        },
+        {{0, 1, 2}});
+    world.init_tree_based_on_mother_child_relations();
+
+    const ml::Ray from_above(ml::Vec3(0.0, 0.0, 1.0), ml::Vec3(0.0, 0.0, -1.0));
+    const ml::Intersection isec =
+        ml::rays_first_intersection_with_frame(&from_above, &world);
+    REQUIRE(isec.does_intersect());
+    CHECK(isec.from_outside_to_inside());
+    CHECK(isec.distance_to_ray_support() == 1.0);
+    CHECK(isec.surface_normal_in_object_frame() == ml::Vec3(0.0, 0.0, 1.0));
+
+    const ml::Ray from_below(ml::Vec3(0.0, 0.0, -1.0), ml::Vec3(0.0, 0.0, 1.0));
+    CHECK(!ml::rays_first_intersection_with_frame(&from_below, &world).
+        from_outside_to_inside());
+
+    const ml::Ray away(ml::Vec3(0.0, 0.0, 1.0), ml::Vec3(0.0, 0.0, 1.0));
+    CHECK(!ml::rays_first_intersection_with_frame(&away, &world).
+        does_intersect());
+}
+
+TEST_CASE("TriangleMeshTest: watertight", "[merlict]") {
+    // A square of 4x4 cells, each cut into two faces along its diagonal.
+    const unsigned int n = 4;
+    std::vector<ml::Vec3> vertices;
+    for (unsigned int x = 0; x <= n; x++)
+        for (unsigned int y = 0; y <= n; y++)
+            vertices.push_back(ml::Vec3(x, y, 0.0));
+    std::vector<ml::TriangleMesh::Face> faces;
+    for (uint32_t x = 0; x < n; x++) {
+        for (uint32_t y = 0; y < n; y++) {
+            const uint32_t i = x*(n + 1) + y;
+            faces.push_back({i, i + n + 1, i + n + 2});
+            faces.push_back({i, i + n + 2, i + 1});
+        }
+    }
+    ml::Frame world;
+    world.set_name_pos_rot("world", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::TriangleMesh* mesh = world.add<ml::TriangleMesh>();
+    mesh->set_name_pos_rot("mesh", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    mesh->set_vertices_and_faces(vertices, faces);
+    world.init_tree_based_on_mother_child_relations();
+
+    // Rays aiming at the shared edges and vertices inside of the square.
+    const std::vector<ml::Vec3> directions = {
+        ml::Vec3(0.0, 0.0, -1.0),
+        ml::Vec3(0.25, 0.5, -1.0),
+        ml::Vec3(-0.5, 0.125, -1.0)};
+    unsigned int num_rays = 0;
+    for (const ml::Vec3 &direction : directions) {
+        for (unsigned int i = 1; i < 8*n; i++) {
+            const double s = i/8.0;
+            const std::vector<ml::Vec3> targets = {
+                ml::Vec3(s, s, 0.0),
+                ml::Vec3(s, 1.0, 0.0),
+                ml::Vec3(3.0, s, 0.0)};
+            for (const ml::Vec3 &target : targets) {
+                const ml::Ray ray(target - direction*4.0, direction);
+                CHECK(ml::rays_first_intersection_with_frame(&ray, &world).
+                    does_intersect());
+                num_rays++;
+            }
+        }
+    }
+    CHECK(num_rays == 3u*3u*(8u*n - 1u));
+}
+
+TEST_CASE("TriangleMeshTest: same_as_triangles", "[merlict]") {
+    const std::string path =
+        "merlict/tests/resources/scenery/LCCone-simple_parab.stl";
+
+    ml::Frame meshed;
+    meshed.set_name_pos_rot("meshed", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::stereo_litography::add_stl_to_frame(path, &meshed);
+    meshed.init_tree_based_on_mother_child_relations();
+    REQUIRE(meshed.get_children()->size() == 1u);
+    const ml::TriangleMesh* mesh = dynamic_cast<const ml::TriangleMesh*>(
+        meshed.get_children()->at(0));
+    REQUIRE(mesh != nullptr);
+    CHECK(mesh->num_faces() == 3692u);
+    CHECK(mesh->num_bytes() < 3692u*sizeof(ml::Triangle));
+
+    ml::Frame triangles;
+    triangles.set_name_pos_rot("triangles", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    const std::vector<ml::stereo_litography::Facet> facets =
+        ml::stereo_litography::BinaryReader(path).get_facets();
+    for (uint64_t i = 0; i < facets.size(); i++) {
+        ml::Triangle* tri = triangles.add<ml::Triangle>();
+        tri->set_name_pos_rot(
+            "triangle_" + std::to_string(i), ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+        tri->set_normal_and_3_vertecies(
+            facets[i].n,
+            facets[i].a,
+            facets[i].b,
+            facets[i].c);
+    }
+    triangles.init_tree_based_on_mother_child_relations();
+
+    const double radius = triangles.get_bounding_sphere_radius();
+    ml::random::Mt19937 prng(0);
+    unsigned int num_hits = 0;
+    for (unsigned int i = 0; i < 5000; i++) {
+        const ml::Vec3 support = ml::Vec3(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5)*4.0*radius;
+        const ml::Vec3 target = ml::Vec3(
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5,
+            prng.uniform() - 0.5)*radius;
+        const ml::Ray ray(support, target - support);
+
+        const ml::Intersection a =
+            ml::rays_first_intersection_with_frame(&ray, &meshed);
+        const ml::Intersection b =
+            ml::rays_first_intersection_with_frame(&ray, &triangles);
+        REQUIRE(a.does_intersect() == b.does_intersect());
+        if (!a.does_intersect())
+            continue;
+        num_hits++;
+        CHECK(a.distance_to_ray_support() ==
+            Approx(b.distance_to_ray_support()).margin(1e-9));
+        CHECK(a.from_outside_to_inside() == b.from_outside_to_inside());
+        CHECK(a.surface_normal_in_root_frame()*
+            b.surface_normal_in_root_frame() > 0.99);
+    }
+    CHECK(num_hits > 500u);
+}
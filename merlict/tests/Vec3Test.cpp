@@ -323,3 +323,13 @@ TEST_CASE("Vec3Test: projection_on_xy_plane", "[merlict]") {
     ml::Vec3 v(42., 13.37, 3.141);
     CHECK(v.project_in_x_y_plane() == ml::Vec3(42., 13.37, 0.));
 }
+
+TEST_CASE("Vec3Test: constexpr", "[merlict]") {
+    constexpr ml::Vec3 a(1., 2., 3.);
+    constexpr ml::Vec3 b(4., 5., 6.);
+    static_assert(a*b == 32., "dot product");
+    static_assert(a.cross(b) == ml::Vec3(-3., 6., -3.), "cross product");
+    static_assert((a + b)*0.5 == ml::Vec3(2.5, 3.5, 4.5), "sum");
+    static_assert(a.octant() == 7u, "octant");
+    CHECK(ml::VEC3_UNIT_Z.cross(ml::VEC3_UNIT_X) == ml::VEC3_UNIT_Y);
+}
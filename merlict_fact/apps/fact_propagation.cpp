@@ -31,39 +31,11 @@ R"(FACT, Cherenkov-telescope propagation for air-showhers
       --version                 Show version.
 )";
 
-double estimate_median_arrival_time(
-    const std::vector<std::vector<sp::ElectricPulse>>& electric_pipelines
-) {
-    unsigned int num_pulses = 0;
-    for (unsigned int chid = 0; chid < electric_pipelines.size(); chid++) {
-        num_pulses += electric_pipelines.at(chid).size();
-    }
-
-    if (num_pulses == 0)
-        return std::nan("");
-
-    std::vector<double> all_arrival_times;
-    all_arrival_times.reserve(num_pulses);
-
-    for (unsigned int chid = 0; chid < electric_pipelines.size(); chid++) {
-        for (unsigned int p = 0; p < electric_pipelines.at(chid).size(); p ++) {
-            all_arrival_times.push_back(
-                electric_pipelines.at(chid).at(p).arrival_time);
-        }
-    }
-
-    std::sort(all_arrival_times.begin(), all_arrival_times.end());
-    unsigned int half_num_pulses = static_cast<unsigned int>(
-        static_cast<double>(num_pulses)*0.5);
-
-    return all_arrival_times.at(half_num_pulses);
-}
-
 std::vector<uint8_t> electric_pipelines_to_photon_stream(
     const std::vector<std::vector<sp::ElectricPulse>>& electric_pipelines,
     const double trigger_time=25e-9
 ) {
-    const double median_arrival_time = estimate_median_arrival_time(
+    const double median_arrival_time = sp::median_of_arrival_times(
             electric_pipelines);
 
     std::vector<uint8_t> raw_phs;
@@ -339,6 +311,8 @@ int main(int argc, char* argv[]) {
     re::sensor::Sensors pixels = re::sensor::Sensors(scenery.sensors.sensors);
 
     scenery.root.init_tree_based_on_mother_child_relations();
+
+    scenery.surface_tables.assign_to_surfaces_in(&scenery.root);
     // Visual::Config visual_config;
     // Visual::FlyingCamera free(&scenery.root, &visual_config);
 
@@ -157,6 +157,7 @@ std::map<std::string, json_to_frame> basic_scenery() {
     mymap["SphereCapWithHexagonalBound"] = add_SphereCapWithHexagonalBound;
     mymap["SphereCapWithRectangularBound"] = add_SphereCapWithRectangularBound;
     mymap["SegmentedReflector"] = add_SegmentedReflector;
+    mymap["InstanceArray"] = add_InstanceArray;
     return mymap;
 }
 
@@ -177,9 +178,7 @@ json_to_frame get(std::map<std::string, json_to_frame> m, const std::string &key
     return m.find(key)->second;
 }
 
-void set_frame(Frame *f, const Object &o) {
-    std::string name = o.st("name");
-    Vec3 pos = o.vec3("pos");
+Rot3 rotation(const Object &o) {
     Rot3 rot;
     if (o.key("rot")) {
         rot = o.rot3("rot");
@@ -187,7 +186,13 @@ void set_frame(Frame *f, const Object &o) {
         const Vec3 rot_axis = o.vec3("rot_axis");
         const double angle = o.f8("rot_angle");
         rot = Rot3(rot_axis, angle);}
-    f->set_name_pos_rot(name, pos, rot);
+    return rot;
+}
+
+void set_frame(Frame *f, const Object &o) {
+    std::string name = o.st("name");
+    Vec3 pos = o.vec3("pos");
+    f->set_name_pos_rot(name, pos, rotation(o));
 }
 
 void set_surface(SurfaceEntity *s, Scenery *scenery, const Object &o) {
@@ -457,6 +462,27 @@ Frame* add_SegmentedReflector(
     return reflector;
 }
 
+Frame* add_InstanceArray(
+    Frame* mother,
+    Scenery *scenery,
+    const Object &o
+) {
+    InstanceArray* array = mother->add<InstanceArray>();
+    set_frame(array, o);
+
+    const Object &jprototype = o.obj("prototype");
+    json_to_frame add_prototype = get(basic_scenery(), jprototype.st("type"));
+    Frame* prototype = add_prototype(array, scenery, jprototype);
+    make_children(prototype, scenery, jprototype.obj("children"));
+
+    const Object &jinstances = o.obj("instances");
+    for (uint64_t i = 0; i < jinstances.size(); i++) {
+        const Object &jinstance = jinstances.obj(i);
+        array->add_instance(jinstance.vec3("pos"), rotation(jinstance));
+    }
+    return array;
+}
+
 visual::Config load_visual_config(const std::string &path) {
     return to_visual_config(load(path), path);
 }
@@ -506,6 +532,8 @@ PropagationConfig to_PropagationConfig(const Object &o) {
     PropagationConfig cfg;
     cfg.max_num_interactions_per_photon =
         o.u8("max_num_interactions_per_photon");
+    if (o.key("propagate_bunches_together"))
+        cfg.propagate_bunches_together = o.b1("propagate_bunches_together");
     return cfg;
 }
 
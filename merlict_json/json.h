@@ -54,6 +54,7 @@ struct Object {
 
 Object load(const std::string &path);
 
+Rot3 rotation(const Object &o);
 void set_frame(Frame *f, const Object &o);
 void set_surface(SurfaceEntity *s, Scenery *scenery, const Object &o);
 void make_children(Frame* mother, Scenery* scenery, const Object &o);
@@ -137,6 +138,11 @@ Frame* add_SegmentedReflector(
     Scenery *scenery,
     const Object &o);
 
+Frame* add_InstanceArray(
+    Frame* mother,
+    Scenery *scenery,
+    const Object &o);
+
 
 typedef Frame* (*json_to_frame)(Frame*, Scenery*, const Object &);
 
@@ -333,6 +333,50 @@ TEST_CASE("JsonTest: Disc", "[merlict]") {
     CHECK(0u == a->get_children()->size());
 }
 
+TEST_CASE("JsonTest: InstanceArray", "[merlict]") {
+    auto j = R"(
+    {
+      "type": "InstanceArray",
+      "name": "discs",
+      "pos": [0, 0, 0],
+      "rot": [0, 0, 0],
+      "prototype": {
+        "type": "Disc",
+        "name": "disc",
+        "pos": [0, 0, 0],
+        "rot": [0, 0, 0],
+        "radius": 0.5,
+        "surface": {},
+        "children": []
+      },
+      "instances": [
+        {"pos": [0, 0, 0]},
+        {"pos": [2, 0, 0], "rot": [0, 1.57, 0]},
+        {"pos": [4, 0, 0], "rot_axis": [0, 0, 1], "rot_angle": 0.5}
+      ],
+      "children": []
+    }
+    )"_json;
+    ml::Scenery s;
+    s.root.set_name_pos_rot("root", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::json::Object o(j);
+    ml::Frame* a = ml::json::add_InstanceArray(&s.root, &s, o);
+    CHECK("discs" == a->get_name());
+    REQUIRE(1u == a->get_children()->size());
+    CHECK("disc" == a->get_children()->at(0)->get_name());
+    ml::InstanceArray* array = dynamic_cast<ml::InstanceArray*>(a);
+    REQUIRE(array != nullptr);
+    CHECK(3u == array->size());
+
+    s.root.init_tree_based_on_mother_child_relations();
+    ml::Ray ray(ml::Vec3(4.0, 0.0, -1.0), ml::VEC3_UNIT_Z);
+    ml::Intersection isec = ml::rays_first_intersection_with_frame(
+        &ray, &s.root);
+    REQUIRE(isec.does_intersect());
+    CHECK(isec.position_in_root_frame().distance_to(
+        ml::Vec3(4.0, 0.0, 0.0)) < 1e-9);
+}
+
 TEST_CASE("JsonTest: What_is_key", "[merlict]") {
     auto j = R"(
     {
@@ -355,6 +399,11 @@ TEST_CASE("JsonTest: PropagationConfig", "[merlict]") {
     ml::json::Object o(j);
     ml::PropagationConfig cfg = ml::json::to_PropagationConfig(o);
     CHECK(1337u == cfg.max_num_interactions_per_photon);
+    CHECK(!cfg.propagate_bunches_together);
+
+    j["propagate_bunches_together"] = true;
+    ml::json::Object o_bunches(j);
+    CHECK(ml::json::to_PropagationConfig(o_bunches).propagate_bunches_together);
 }
 
 TEST_CASE("JsonTest: PointSource", "[merlict]") {
@@ -0,0 +1,38 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_portal_plenoscope/EventWorkspace.h"
+namespace sp = signal_processing;
+
+
+namespace plenoscope {
+
+template<typename T>
+void clear_or_release(std::vector<T>* buffer, const uint64_t max_capacity) {
+    if (buffer->capacity() > max_capacity)
+        std::vector<T>().swap(*buffer);
+    else
+        buffer->clear();
+}
+
+EventWorkspace::EventWorkspace():
+    max_capacity_per_channel(DEFAULT_MAX_CAPACITY_PER_CHANNEL),
+    max_num_photons(DEFAULT_MAX_NUM_PHOTONS)
+{}
+
+EventWorkspace::EventWorkspace(
+    const uint64_t _max_capacity_per_channel,
+    const uint64_t _max_num_photons
+):
+    max_capacity_per_channel(_max_capacity_per_channel),
+    max_num_photons(_max_num_photons)
+{}
+
+void EventWorkspace::reset() {
+    clear_or_release(&photons, max_num_photons);
+    for (std::vector<sp::PipelinePhoton> &pipeline : photon_pipelines)
+        clear_or_release(&pipeline, max_capacity_per_channel);
+    for (std::vector<sp::ElectricPulse> &pipeline : electric_pipelines)
+        clear_or_release(&pipeline, max_capacity_per_channel);
+    clear_or_release(&extracted_pulses.pulses, max_num_photons);
+}
+
+}  // namespace plenoscope
@@ -0,0 +1,40 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef PLENOSCOPE_EVENTWORKSPACE_H_
+#define PLENOSCOPE_EVENTWORKSPACE_H_
+
+#include <stdint.h>
+#include <vector>
+#include "merlict/merlict.h"
+#include "merlict_signal_processing/signal_processing.h"
+
+namespace plenoscope {
+
+// Owns the buffers of all stages of the simulation of one event, so that
+// consecutive events reuse the memory allocated by their predecessors.
+// reset() clears the buffers, but keeps their capacity unless a buffer
+// has grown beyond its high-water-mark. Those buffers are released to keep
+// the memory of long runs stable after a few exceptionally large events.
+struct EventWorkspace {
+    std::vector<merlict::Photon> photons;
+    std::vector<std::vector<signal_processing::PipelinePhoton>>
+        photon_pipelines;
+    std::vector<std::vector<signal_processing::ElectricPulse>>
+        electric_pipelines;
+    signal_processing::PhotonStream::SparseStream extracted_pulses;
+
+    uint64_t max_capacity_per_channel;
+    uint64_t max_num_photons;
+
+    EventWorkspace();
+    EventWorkspace(
+        const uint64_t max_capacity_per_channel,
+        const uint64_t max_num_photons);
+    void reset();
+};
+
+const uint64_t DEFAULT_MAX_CAPACITY_PER_CHANNEL = 1024u;
+const uint64_t DEFAULT_MAX_NUM_PHOTONS = 4u*1024u*1024u;
+
+}  // namespace plenoscope
+
+#endif  // PLENOSCOPE_EVENTWORKSPACE_H_
@@ -0,0 +1,148 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "docopt/docopt.h"
+#include "merlict_portal_plenoscope/json_to_plenoscope.h"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+
+
+static const char USAGE[] =
+R"(Compare the culling of frames in float with the culling in double
+
+    Rays come from above the scenery, e.g. the plenoscope scenery, and are
+    reflected on every surface they hit. The hits are the same when the
+    culling in float never drops a frame the culling in double keeps.
+
+    Usage:
+      plenoscope-benchmark-precision -s=PATH [-n=NUMBER]
+      plenoscope-benchmark-precision (-h | --help)
+      plenoscope-benchmark-precision --version
+
+    Options:
+      -s --scenery=PATH             Path to the scenery.json.
+      -n --num_rays=NUMBER          Number of rays [default: 100000].
+      -h --help                     Show this screen.
+      --version                     Show version.
+)";
+
+const unsigned int MAX_NUM_BOUNCES = 5u;
+
+template<class Real>
+std::vector<ml::Intersection> trace(
+    const ml::Ray &first_ray,
+    const ml::Frame* root
+) {
+    std::vector<ml::Intersection> hits;
+    ml::Ray ray = first_ray;
+    for (unsigned int i = 0; i < MAX_NUM_BOUNCES; i++) {
+        const ml::Intersection isec =
+            ml::rays_first_intersection_with_frame<Real>(&ray, root);
+        if (!isec.does_intersect())
+            break;
+        hits.push_back(isec);
+        ray.set_support_and_direction(
+            isec.position_in_root_frame(),
+            isec.reflection_direction_in_root_frame(ray.direction()));
+    }
+    return hits;
+}
+
+template<class Real>
+double nanoseconds_per_trace(
+    const std::vector<ml::Ray> &rays,
+    const ml::Frame* root,
+    std::vector<std::vector<ml::Intersection>> *hits
+) {
+    hits->clear();
+    const auto start = std::chrono::steady_clock::now();
+    for (const ml::Ray &ray : rays)
+        hits->push_back(trace<Real>(ray, root));
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count()/
+        rays.size();
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::map<std::string, docopt::value> args = docopt::docopt(
+            USAGE,
+            { argv + 1, argv + argc },
+            true,        // show help if requested
+            "0.1");  // version string
+
+        const std::string scenery_path = args.find("--scenery")->second.
+            asString();
+        const uint64_t num_rays = ml::txt::to_int(
+            args.find("--num_rays")->second.asString());
+
+        plenoscope::PlenoscopeScenery scenery;
+        plenoscope::json::append_to_frame_in_scenery(
+            &scenery.root,
+            &scenery,
+            scenery_path);
+        scenery.root.init_tree_based_on_mother_child_relations();
+        const double radius = scenery.root.get_bounding_sphere_radius();
+
+        // From a disc above the scenery, within 5 deg to the optical axis.
+        ml::random::Mt19937 prng(0u);
+        std::vector<ml::Ray> rays;
+        for (uint64_t i = 0; i < num_rays; i++) {
+            const ml::Vec3 support =
+                prng.get_point_on_xy_disc_within_radius(radius) +
+                ml::Vec3(0.0, 0.0, radius);
+            const double theta = ml::deg2rad(5.0)*sqrt(prng.uniform());
+            const double phi = 2.0*M_PI*prng.uniform();
+            rays.push_back(ml::Ray(
+                support,
+                ml::Vec3(
+                    sin(theta)*cos(phi),
+                    sin(theta)*sin(phi),
+                    -cos(theta))));
+        }
+
+        std::vector<std::vector<ml::Intersection>> double_hits;
+        std::vector<std::vector<ml::Intersection>> float_hits;
+        const double double_ns =
+            nanoseconds_per_trace<double>(rays, &scenery.root, &double_hits);
+        const double float_ns =
+            nanoseconds_per_trace<float>(rays, &scenery.root, &float_hits);
+
+        uint64_t num_double_hits = 0u;
+        uint64_t num_float_hits = 0u;
+        uint64_t num_different_traces = 0u;
+        double max_deviation = 0.0;
+        for (uint64_t i = 0; i < rays.size(); i++) {
+            num_double_hits += double_hits[i].size();
+            num_float_hits += float_hits[i].size();
+            bool same = double_hits[i].size() == float_hits[i].size();
+            for (uint64_t j = 0; same && j < double_hits[i].size(); j++) {
+                const ml::Intersection &a = double_hits[i][j];
+                const ml::Intersection &b = float_hits[i][j];
+                same = a.object() == b.object();
+                max_deviation = std::max(
+                    max_deviation,
+                    (a.position_in_root_frame() -
+                    b.position_in_root_frame()).norm());
+            }
+            if (!same)
+                num_different_traces++;
+        }
+
+        std::cout << "rays .................... " << rays.size() << "\n";
+        std::cout << "hits in double .......... " << num_double_hits << "\n";
+        std::cout << "hits in float ........... " << num_float_hits << "\n";
+        std::cout << "different traces ........ " << num_different_traces;
+        std::cout << "\n";
+        std::cout << "max deviation of hits ... " << max_deviation << "m\n";
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "trace, double culling ... " << double_ns << " ns\n";
+        std::cout << "trace, float culling .... " << float_ns << " ns\n";
+    } catch (std::exception &error) {
+        std::cerr << error.what();
+    }
+    return 0;
+}
@@ -14,7 +14,7 @@ static const char USAGE[] =
 R"(Light-field-calibration for the Portal Cherenkov-plenoscope
 
     Usage:
-      plenoscope-calibration -s=PATH -n=NUMBER -o=PATH
+      plenoscope-calibration -s=PATH -n=NUMBER -o=PATH [--target_uncertainty=VALUE] [--quasi_random] [--symmetric]
       plenoscope-calibration (-h | --help)
       plenoscope-calibration --version
 
@@ -24,6 +24,16 @@ R"(Light-field-calibration for the Portal Cherenkov-plenoscope
                                                     of calibration photons to be
                                                     emitted.
       -o --output=PATH                              Output path.
+      --target_uncertainty=VALUE                    Adaptive calibration. Stop
+                                                    when the relative
+                                                    uncertainty of all hit
+                                                    lixels is below VALUE, or
+                                                    at num_mega_photons.
+      --quasi_random                                Draw the photons from a
+                                                    low discrepancy sequence.
+      --symmetric                                   Assume the imaging system
+                                                    to share the hexagonal
+                                                    symmetries of the sensor.
       -h --help                                     Show this screen.
       --version                                     Show version.
 )";
@@ -82,6 +92,7 @@ int main(int argc, char* argv[]) {
             &scenery,
             scenery_file_path.path);
         scenery.root.init_tree_based_on_mother_child_relations();
+        scenery.surface_tables.assign_to_surfaces_in(&scenery.root);
 
         if (scenery.plenoscopes.size() == 0)
             throw std::invalid_argument(
@@ -105,6 +116,22 @@ int main(int argc, char* argv[]) {
         plenoscope::calibration::Config calib_config;
         calib_config.num_blocks = num_mega_photons;
         calib_config.photons_per_block = static_cast<int>(1e6);
+        calib_config.quasi_random = args.find("--quasi_random")->
+            second.asBool();
+        calib_config.symmetric = args.find("--symmetric")->second.asBool();
+        if (args.find("--target_uncertainty")->second) {
+            calib_config.adaptive = true;
+            calib_config.target_relative_uncertainty = ml::txt::to_double(
+                args.find("--target_uncertainty")->second.asString());
+            if (calib_config.target_relative_uncertainty <= 0.0) {
+                std::stringstream info;
+                info << __FILE__ << ", " << __LINE__ << "\n";
+                info << "Expected '--target_uncertainty' to be > 0, ";
+                info << "but actual: ";
+                info << calib_config.target_relative_uncertainty;
+                throw std::invalid_argument(info.str());
+            }
+        }
 
         // RUN PLENOSCOPE CALIBRATION
         plenoscope::calibration::Calibrator calibrator(
@@ -114,10 +141,24 @@ int main(int argc, char* argv[]) {
 
         ml::random::Mt19937 prng(0);
 
-        plenoscope::calibration::run_calibration(
-            calibrator,
-            ml::ospath::join(out_path.path, "lixel_statistics.bin"),
-            &prng);
+        const std::vector<plenoscope::calibration::LixelStatistic>
+            lixel_statistics = plenoscope::calibration::calibrate(
+                calibrator,
+                &prng).get_lixel_statistics();
+
+        plenoscope::calibration::write(
+            lixel_statistics,
+            ml::ospath::join(
+                out_path.path,
+                plenoscope::calibration::LIXEL_STATISTICS_FILENAME));
+
+        plenoscope::calibration::write_columns(
+            lixel_statistics,
+            plenoscope::calibration::geometry_hash(
+                pis->light_field_sensor_geometry.get_info_header()),
+            ml::ospath::join(
+                out_path.path,
+                plenoscope::calibration::LIXEL_STATISTICS_COLUMNS_FILENAME));
 
     } catch (std::exception &error) {
         std::cerr << error.what();
@@ -14,7 +14,7 @@ static const char USAGE[] =
 R"(Map-and-reduce light-field-calibration for the Portal Cherenkov-plenoscope
 
     Usage:
-      plenoscope-calibration-map -s=PATH -n=NUMBER -o=PATH -r=SEED
+      plenoscope-calibration-map -s=PATH -n=NUMBER -o=PATH -r=SEED [--quasi_random] [--symmetric]
       plenoscope-calibration-map (-h | --help)
       plenoscope-calibration-map --version
 
@@ -23,6 +23,12 @@ R"(Map-and-reduce light-field-calibration for the Portal Cherenkov-plenoscope
       -n --num_photons=NUM_PHOTONS                  Num. calibration photons.
       -o --output=PATH                              Output path.
       -r --random_seed=SEED                         Unsigned integer seed.
+      --quasi_random                                Draw the photons from a
+                                                    low discrepancy sequence,
+                                                    scrambled by the seed.
+      --symmetric                                   Assume the imaging system
+                                                    to share the hexagonal
+                                                    symmetries of the sensor.
       -h --help                                     Show this screen.
       --version                                     Show version.
 )";
@@ -107,6 +113,7 @@ int main(int argc, char* argv[]) {
             &scenery,
             scenery_file_path.path);
         scenery.root.init_tree_based_on_mother_child_relations();
+        scenery.surface_tables.assign_to_surfaces_in(&scenery.root);
 
         if (scenery.plenoscopes.size() == 0)
             throw std::invalid_argument(
@@ -131,6 +138,9 @@ int main(int argc, char* argv[]) {
         plenoscope::calibration::Config calib_config;
         calib_config.num_blocks = 1u;
         calib_config.photons_per_block = num_photons;
+        calib_config.quasi_random = args.find("--quasi_random")->
+            second.asBool();
+        calib_config.symmetric = args.find("--symmetric")->second.asBool();
 
         // RUN PLENOSCOPE CALIBRATION
         plenoscope::calibration::Calibrator calibrator(
@@ -140,9 +150,9 @@ int main(int argc, char* argv[]) {
 
         ml::random::Mt19937 prng(random_seed);
 
-        plenoscope::calibration::run_calibration_raw_output(
+        plenoscope::calibration::run_calibration_partial_output(
             calibrator,
-            ml::ospath::join(out_path.path, "raw_lixel_statistics.bin"),
+            ml::ospath::join(out_path.path, "partial_lixel_statistics.bin"),
             &prng);
     } catch (std::exception &error) {
         std::cerr << error.what();
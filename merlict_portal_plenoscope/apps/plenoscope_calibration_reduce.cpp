@@ -4,6 +4,7 @@
 #include "docopt/docopt.h"
 #include "merlict_portal_plenoscope/calibration/Calibrator.h"
 #include "merlict_portal_plenoscope/calibration/LixelStatisticsFiller.h"
+#include "merlict_portal_plenoscope/calibration/PartialLixelStatistics.h"
 #include "merlict_portal_plenoscope/json_to_plenoscope.h"
 #include "merlict_corsika/corsika.h"
 #include "merlict/merlict.h"
@@ -26,11 +27,13 @@ R"(reduction light-field-calibration for the Portal Cherenkov-plenoscope
       --version                                     Show version.
 )";
 
-std::vector<plenoscope::CalibrationPhotonResult> read_calib_block(
-    const std::string path) {
-    std::vector<plenoscope::CalibrationPhotonResult> out;
+// Legacy map-jobs wrote every single photon into raw_lixel_statistics.bin.
+plenoscope::calibration::PartialLixelStatistics read_raw_calib_block(
+    const std::string path,
+    const uint64_t num_lixel
+) {
     std::ifstream fin;
-    fin.open(path, std::ios::in | std::ios::binary);
+    fin.open(path, std::ios::in | std::ios::binary | std::ios::ate);
     if (!fin.is_open()) {
         std::stringstream info;
         info << __FILE__ << " " << __LINE__ << "\n";
@@ -38,15 +41,41 @@ std::vector<plenoscope::CalibrationPhotonResult> read_calib_block(
         info << path << "'\n";
         throw std::runtime_error(info.str());
     }
-    while (fin) {
-        plenoscope::CalibrationPhotonResult res;
-        fin.read(
-            reinterpret_cast<char*>(&res),
-            sizeof(plenoscope::CalibrationPhotonResult));
-        out.push_back(res);
-    }
+    const uint64_t file_size = fin.tellg();
+    fin.seekg(0);
+    const uint64_t num_photons =
+        file_size/sizeof(plenoscope::CalibrationPhotonResult);
+    std::vector<plenoscope::CalibrationPhotonResult> block(num_photons);
+    fin.read(
+        reinterpret_cast<char*>(block.data()),
+        num_photons*sizeof(plenoscope::CalibrationPhotonResult));
     fin.close();
-    return out;
+
+    plenoscope::calibration::LixelStatisticsFiller filler(
+        num_lixel,
+        1u,
+        num_photons);
+    filler.fill_in_block(block);
+
+    plenoscope::calibration::PartialLixelStatistics partial;
+    partial.num_photons_emitted = num_photons;
+    partial.lixel_stats = filler.online_lixel_statistics();
+    return partial;
+}
+
+plenoscope::calibration::PartialLixelStatistics read_calib_block(
+    const std::string &job_path,
+    const uint64_t num_lixel
+) {
+    const std::string partial_path = ml::ospath::join(
+        job_path,
+        "partial_lixel_statistics.bin");
+    if (fs::exists(partial_path))
+        return plenoscope::calibration::read_partial(partial_path);
+    else
+        return read_raw_calib_block(
+            ml::ospath::join(job_path, "raw_lixel_statistics.bin"),
+            num_lixel);
 }
 
 
@@ -69,7 +98,7 @@ int main(int argc, char* argv[]) {
         if (paths.size() < 1) {
             std::stringstream info;
             info << __FILE__ << " " << __LINE__ << "\n";
-            info << "Expected at least one raw calibration-block in path: ";
+            info << "Expected at least one calibration-block in path: ";
             info << in_path.path << "'\n";
             throw std::runtime_error(info.str());
         }
@@ -96,22 +125,13 @@ int main(int argc, char* argv[]) {
                 out_path.path,
                 "light_field_sensor_geometry.header.bin")).at(0);
 
-        std::vector<plenoscope::CalibrationPhotonResult> ref_photons =
-            read_calib_block(
-                ml::ospath::join(
-                    ref_path,
-                    "raw_lixel_statistics.bin"));
-
-        const uint64_t num_blocks = paths.size();
-        const uint64_t num_photons_per_block = ref_photons.size();
         const uint64_t num_lixel = (
             static_cast<uint64_t>(ref_header[101 - 1])*
             static_cast<uint64_t>(ref_header[102 - 1]));
 
-        plenoscope::calibration::LixelStatisticsFiller lixel_statistics_filler(
-            num_lixel,
-            num_blocks,
-            num_photons_per_block);
+        uint64_t num_photons_emitted = 0u;
+        std::vector<plenoscope::calibration::OnlineLixelStatistics>
+            lixel_stats(num_lixel);
 
         for (std::string p : paths) {
             std::array<float, 273> header = corsika::read_273_f4_from_path(
@@ -127,15 +147,29 @@ int main(int argc, char* argv[]) {
                 throw std::runtime_error(info.str());
             }
 
-            std::vector<plenoscope::CalibrationPhotonResult> calib_block =
-                read_calib_block(
-                    ml::ospath::join(
-                        p,
-                        "raw_lixel_statistics.bin"));
+            const plenoscope::calibration::PartialLixelStatistics partial =
+                read_calib_block(p, num_lixel);
 
-            lixel_statistics_filler.fill_in_block(calib_block);
+            if (partial.lixel_stats.size() != num_lixel) {
+                std::stringstream info;
+                info << __FILE__ << " " << __LINE__ << "\n";
+                info << "Expected " << num_lixel << " lixels in '" << p;
+                info << "', but actual " << partial.lixel_stats.size();
+                info << ".\n";
+                throw std::runtime_error(info.str());
+            }
+
+            num_photons_emitted += partial.num_photons_emitted;
+            for (uint64_t i = 0; i < num_lixel; i++)
+                lixel_stats[i].merge(partial.lixel_stats[i]);
         }
 
+        plenoscope::calibration::LixelStatisticsFiller lixel_statistics_filler(
+            num_lixel,
+            1u,
+            num_photons_emitted);
+        lixel_statistics_filler.merge(lixel_stats);
+
         std::vector<plenoscope::calibration::LixelStatistic> lixel_statistics =
             lixel_statistics_filler.get_lixel_statistics();
 
@@ -143,7 +177,14 @@ int main(int argc, char* argv[]) {
             lixel_statistics,
             ml::ospath::join(
                 out_path.path,
-                "lixel_statistics.bin"));
+                plenoscope::calibration::LIXEL_STATISTICS_FILENAME));
+
+        plenoscope::calibration::write_columns(
+            lixel_statistics,
+            plenoscope::calibration::geometry_hash(ref_header),
+            ml::ospath::join(
+                out_path.path,
+                plenoscope::calibration::LIXEL_STATISTICS_COLUMNS_FILENAME));
     } catch (std::exception &error) {
         std::cerr << error.what();
     }
@@ -0,0 +1,116 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <iostream>
+#include "docopt/docopt.h"
+#include "merlict/merlict.h"
+#include "merlict_portal_plenoscope/night_sky_background/Light.h"
+#include "merlict_portal_plenoscope/night_sky_background/Injector.h"
+#include "merlict_portal_plenoscope/night_sky_background/Library.h"
+#include "merlict_portal_plenoscope/json_to_plenoscope.h"
+namespace ml = merlict;
+namespace nsb = plenoscope::night_sky_background;
+
+
+static const char USAGE[] =
+R"(Night sky background library for the Portal Cherenkov-plenoscope
+
+    Precomputes independent realizations of the night sky background in all
+    light field channels. The library can be passed to plenoscope-propagation
+    with --nsb_library.
+
+    Usage:
+      plenoscope-nsb-library -l=PATH -c=PATH -n=NUMBER -o=PATH [-r=SEED]
+      plenoscope-nsb-library (-h | --help)
+      plenoscope-nsb-library --version
+
+    Options:
+      -l --lixel=PATH           Light field calibration directory of the plenoscope.
+      -c --config=PATH          Config path.
+      -n --number=NUMBER        Number of realizations.
+      -o --output=PATH          Output path of the library.
+      -r --random_seed=SEED     Seed for pseudo random number generator.
+      -h --help                 Show this screen.
+      --version                 Show version.
+)";
+
+int main(int argc, char* argv[]) {
+    try {
+    std::map<std::string, docopt::value> args = docopt::docopt(
+        USAGE,
+        { argv + 1, argv + argc },
+        true,        // show help if requested
+        "0.1");    // version string
+
+    ml::ospath::Path config_path(args.find("--config")->second.asString());
+    ml::ospath::Path out_path(args.find("--output")->second.asString());
+    ml::ospath::Path lixel_calib_dir(args.find("--lixel")->second.asString());
+    const uint32_t num_realizations = args.find("--number")->second.asLong();
+
+    ml::ospath::Path lixel_calib_path =
+        plenoscope::calibration::lixel_statistics_path(lixel_calib_dir.path);
+    ml::ospath::Path scenery_path = ml::ospath::join(
+        lixel_calib_dir.path,
+        "input/scenery/scenery.json");
+
+    ml::random::Mt19937 prng;
+    if (args.find("--random_seed")->second)
+        prng.set_seed(args.find("--random_seed")->second.asLong());
+
+    plenoscope::PlenoscopeScenery scenery;
+    plenoscope::json::append_to_frame_in_scenery(
+        &scenery.root,
+        &scenery,
+        scenery_path.path);
+    scenery.root.init_tree_based_on_mother_child_relations();
+    scenery.surface_tables.assign_to_surfaces_in(&scenery.root);
+
+    if (scenery.plenoscopes.size() != 1)
+        throw std::invalid_argument(
+            "Expected exactly one plenoscope in the scenery");
+    plenoscope::PlenoscopeInScenery* pis = &scenery.plenoscopes.at(0);
+
+    const plenoscope::calibration::LixelEfficiencies lixel_efficiencies =
+        plenoscope::calibration::read_efficiencies(
+            lixel_calib_path.path,
+            plenoscope::calibration::geometry_hash(
+                pis->light_field_sensor_geometry.get_info_header()));
+
+    if (pis->light_field_channels->size() != lixel_efficiencies.size()) {
+        std::stringstream info;
+        info << "The light field calibration results, read from file '";
+        info << lixel_calib_path.path;
+        info << "', do no not match the plenoscope.\n";
+        info << "Expected number of light field channels: ";
+        info << pis->light_field_channels->size();
+        info << ", but actual: " << lixel_efficiencies.size();
+        info << "\n";
+        throw std::invalid_argument(info.str());
+    }
+
+    ml::json::Object plcfg = ml::json::load(config_path.path);
+    ml::json::Object nsb_obj = plcfg.obj("night_sky_background_ligth");
+    const ml::function::Func1 nsb_flux_vs_wavelength =
+        ml::json::json_to_linear_interpol_function(
+            nsb_obj.obj("flux_vs_wavelength"));
+
+    nsb::Light light(
+        &pis->light_field_sensor_geometry,
+        &nsb_flux_vs_wavelength);
+    const double nsb_exposure_time = nsb_obj.f8("exposure_time");
+
+    nsb::write_library(
+        out_path.path,
+        num_realizations,
+        nsb_exposure_time,
+        nsb::lixel_nsb_rates(&lixel_efficiencies, &light),
+        &light.wavelength_probability,
+        &prng);
+
+    nsb::Library library(out_path.path);
+    std::cout << "realizations " << library.num_realizations() << ", ";
+    std::cout << "lixel " << library.num_lixel() << ", ";
+    std::cout << "photons " << library.num_photons() << "\n";
+    } catch (std::exception &error) {
+        std::cerr << error.what();
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 // Copyright 2015 Sebastian A. Mueller
 #include <experimental/filesystem>
 #include <iostream>
+#include <memory>
 #include "docopt/docopt.h"
 #include "merlict/merlict.h"
 #include "merlict_corsika/eventio.h"
@@ -10,6 +11,7 @@
 #include "merlict_signal_processing/signal_processing.h"
 #include "merlict_portal_plenoscope/night_sky_background/Light.h"
 #include "merlict_portal_plenoscope/EventHeader.h"
+#include "merlict_portal_plenoscope/EventWorkspace.h"
 #include "merlict_portal_plenoscope/SimulationTruthHeader.h"
 #include "merlict_portal_plenoscope/night_sky_background/Injector.h"
 #include "merlict_portal_plenoscope/json_to_plenoscope.h"
@@ -22,7 +24,7 @@ static const char USAGE[] =
 R"(Propagation of air-showers for the Portal Cherenkov-plenoscope
 
     Usage:
-      plenoscope-propagation -l=PATH -c=PATH -i=PATH -o=PATH [-r=SEED] [--all_truth]
+      plenoscope-propagation -l=PATH -c=PATH -i=PATH -o=PATH [-r=SEED] [--all_truth] [--nsb_library=PATH] [--nsb_response_table=PATH] [--propagate_bunches_together]
       plenoscope-propagation (-h | --help)
       plenoscope-propagation --version
 
@@ -33,6 +35,15 @@ R"(Propagation of air-showers for the Portal Cherenkov-plenoscope
       -o --output=PATH          Output path.
       -r --random_seed=SEED     Seed for pseudo random number generator.
       --all_truth               Write all simulation truth avaiable into the output.
+      --propagate_bunches_together
+                                Trace the photons of a bunch together until
+                                their random decisions differ. Draws the
+                                random numbers in a different order.
+      --nsb_library=PATH        Draw the night sky background from a library
+                                of precomputed realizations.
+      --nsb_response_table=PATH Assign the night sky background photons to
+                                the lixels by a lookup in a response table
+                                instead of by the mean lixel efficiencies.
       -h --help                 Show this screen.
       --version                 Show version.
 )";
@@ -51,6 +62,8 @@ int main(int argc, char* argv[]) {
     ml::ospath::Path input_path(args.find("--input")->second.asString());
     const bool export_all_simulation_truth =
         args.find("--all_truth")->second.asBool();
+    const bool propagate_bunches_together =
+        args.find("--propagate_bunches_together")->second.asBool();
 
     // 1) create output directory
     fs::create_directory(out_path.path);
@@ -73,9 +86,8 @@ int main(int argc, char* argv[]) {
     config_path = ml::ospath::join(
         input_copy_path.path,
         "propagation_config.json");
-    lixel_calib_path = ml::ospath::join(
-        ml::ospath::join(input_copy_path.path, "plenoscope"),
-        "lixel_statistics.bin");
+    lixel_calib_path = plenoscope::calibration::lixel_statistics_path(
+        ml::ospath::join(input_copy_path.path, "plenoscope"));
     input_path = ml::ospath::join(input_copy_path.path, input_path.basename);
     ml::ospath::Path scenery_path = ml::ospath::join(
         ml::ospath::join(input_copy_path.path, "plenoscope"),
@@ -93,6 +105,7 @@ int main(int argc, char* argv[]) {
     // BASIC SETTINGS
     ml::PropagationConfig settings;
     settings.max_num_interactions_per_photon = 10;
+    settings.propagate_bunches_together = propagate_bunches_together;
 
     //--------------------------------------------------------------------------
     // INIT PRNG
@@ -108,6 +121,7 @@ int main(int argc, char* argv[]) {
         &scenery,
         scenery_path.path);
     scenery.root.init_tree_based_on_mother_child_relations();
+    scenery.surface_tables.assign_to_surfaces_in(&scenery.root);
 
     if (scenery.plenoscopes.size() == 0)
         throw std::invalid_argument("There is no plenoscope in the scenery");
@@ -120,8 +134,11 @@ int main(int argc, char* argv[]) {
 
     //--------------------------------------------------------------------------
     // load light field calibration result
-    std::vector<float> lixel_efficiencies =
-        plenoscope::calibration::read_efficiencies(lixel_calib_path.path);
+    const plenoscope::calibration::LixelEfficiencies lixel_efficiencies =
+        plenoscope::calibration::read_efficiencies(
+            lixel_calib_path.path,
+            plenoscope::calibration::geometry_hash(
+                pis->light_field_sensor_geometry.get_info_header()));
 
     // assert number os sub_pixel matches simulated plenoscope
     if (light_field_channels->size() != lixel_efficiencies.size()) {
@@ -149,6 +166,35 @@ int main(int argc, char* argv[]) {
         &nsb_flux_vs_wavelength);
     const double nsb_exposure_time = nsb_obj.f8("exposure_time");
 
+    std::unique_ptr<plenoscope::night_sky_background::Library> nsb_library;
+    if (args.find("--nsb_library")->second) {
+        nsb_library.reset(new plenoscope::night_sky_background::Library(
+            args.find("--nsb_library")->second.asString()));
+        if (nsb_library->num_lixel() != lixel_efficiencies.size() ||
+            nsb_library->exposure_time() != nsb_exposure_time
+        ) {
+            std::stringstream info;
+            info << "The night sky background library, read from file '";
+            info << args.find("--nsb_library")->second.asString();
+            info << "', does not match the plenoscope simulated here.\n";
+            info << "Expected " << lixel_efficiencies.size();
+            info << " light field channels and exposure time ";
+            info << nsb_exposure_time << "s, but actual: ";
+            info << nsb_library->num_lixel() << " channels and ";
+            info << nsb_library->exposure_time() << "s.\n";
+            throw std::invalid_argument(info.str());
+        }
+    }
+
+    std::unique_ptr<plenoscope::calibration::ResponseTable> nsb_response_table;
+    if (args.find("--nsb_response_table")->second) {
+        nsb_response_table.reset(new plenoscope::calibration::ResponseTable(
+            plenoscope::calibration::read_response_table(
+                args.find("--nsb_response_table")->second.asString(),
+                plenoscope::calibration::geometry_hash(
+                    pis->light_field_sensor_geometry.get_info_header()))));
+    }
+
     //--------------------------------------------------------------------------
     // SET UP PhotoElectricConverter
     ml::json::Object pec_obj = plcfg.obj("photo_electric_converter");
@@ -187,66 +233,87 @@ int main(int argc, char* argv[]) {
 
     //--------------------------------------------------------------------------
     // propagate each event
+    plenoscope::EventWorkspace workspace;
     unsigned int event_counter = 1;
     while (corsika_run.has_still_events_left()) {
+        workspace.reset();
         //------------------
         // Cherenkov photons
         event_tape::Event event = corsika_run.next_event();
 
-        std::vector<ml::Photon> photons;
         unsigned int photon_id = 0;
 
         for (const std::array<float, 8> &corsika_photon : event.photons) {
             ml::EventIoPhotonFactory cpf(corsika_photon, photon_id++, &prng);
             while (cpf.has_still_photons_to_be_made()) {
-                photons.push_back(cpf.make_photon());
+                workspace.photons.push_back(cpf.make_photon());
             }
         }
 
         ml::propagate_photons_in_frame_with_config(
-            &photons, &scenery.root, &settings, &prng);
+            &workspace.photons, &scenery.root, &settings, &prng);
 
-        light_field_channels->clear_history();
-        light_field_channels->assign_photons(&photons);
+        light_field_channels->clear_history(
+            workspace.max_capacity_per_channel);
+        light_field_channels->assign_photons(&workspace.photons);
 
-        std::vector<std::vector<sp::PipelinePhoton>> photon_pipelines =
-            sp::get_photon_pipelines(light_field_channels);
+        sp::get_photon_pipelines(
+            light_field_channels,
+            &workspace.photon_pipelines);
 
         //-----------------------------
         // Night Sky Background photons
         double nsb_exposure_start_time = 0.0;
-        plenoscope::night_sky_background::inject_nsb_into_photon_pipeline(
-            &photon_pipelines,
-            nsb_exposure_time,
-            &lixel_efficiencies,
-            &nsb,
-            &nsb_exposure_start_time,
-            &prng);
+        if (nsb_library) {
+            plenoscope::night_sky_background::
+                inject_nsb_from_library_into_photon_pipeline(
+                    &workspace.photon_pipelines,
+                    nsb_library.get(),
+                    &nsb_exposure_start_time,
+                    &prng);
+        } else if (nsb_response_table) {
+            plenoscope::night_sky_background::
+                inject_nsb_by_response_table_into_photon_pipeline(
+                    &workspace.photon_pipelines,
+                    nsb_exposure_time,
+                    nsb_response_table.get(),
+                    &nsb,
+                    &nsb_exposure_start_time,
+                    &prng);
+        } else {
+            plenoscope::night_sky_background::inject_nsb_into_photon_pipeline(
+                &workspace.photon_pipelines,
+                nsb_exposure_time,
+                &lixel_efficiencies,
+                &nsb,
+                &nsb_exposure_start_time,
+                &prng);
+        }
 
         //--------------------------
         // Photo Electric conversion
-        std::vector<std::vector<sp::ElectricPulse>> electric_pipelines;
-        electric_pipelines.reserve(photon_pipelines.size());
+        workspace.electric_pipelines.resize(
+            workspace.photon_pipelines.size());
         for (
-            std::vector<sp::PipelinePhoton> ph_pipe :
-            photon_pipelines
+            unsigned int ch = 0;
+            ch < workspace.photon_pipelines.size();
+            ch++
         ) {
-            electric_pipelines.push_back(
-                sipm_converter.get_pulse_pipeline_for_photon_pipeline(
-                    ph_pipe,
-                    nsb_exposure_time,
-                    &prng));
+            sipm_converter.get_pulse_pipeline_for_photon_pipeline(
+                workspace.photon_pipelines.at(ch),
+                nsb_exposure_time,
+                &prng,
+                &workspace.electric_pipelines.at(ch));
         }
 
         //-------------------------
         // Single-photon-extraction
-        sp::PhotonStream::Stream record;
-        record.time_slice_duration = time_slice_duration;
-        record.photon_stream = sp::extract_pulses(
-            electric_pipelines,
+        sp::extract_pulses(
+            workspace.electric_pipelines,
             time_slice_duration,
             arrival_time_std,
-            &prng);
+            &prng,
+            &workspace.extracted_pulses);
 
         //-------------
         // export event
@@ -256,8 +323,7 @@ int main(int argc, char* argv[]) {
         fs::create_directory(event_output_path.path);
 
         sp::PhotonStream::write(
-            record.photon_stream,
-            record.time_slice_duration,
+            workspace.extracted_pulses,
             ml::ospath::join(
                 event_output_path.path,
                 "raw_light_field_sensor_response.phs"));
@@ -300,7 +366,7 @@ plenoscope::TriggerType::EXTERNAL_TRIGGER_BASED_ON_AIR_SHOWER_SIMULATION_TRUTH);
 
         if (export_all_simulation_truth) {
             sp::PhotonStream::write_simulation_truth(
-                record.photon_stream,
+                workspace.extracted_pulses,
                 ml::ospath::join(
                     event_mc_truth_path.path,
                     "detector_pulse_origins.bin"));
@@ -21,7 +21,7 @@ static const char USAGE[] =
 R"(Propagation of raw photons for the Portal Cherenkov-plenoscope
 
     Usage:
-      plenoscope-raw-photon-propagation -l=PATH -c=PATH -i=PATH -o=PATH [-r=SEED] [--all_truth]
+      plenoscope-raw-photon-propagation -l=PATH -c=PATH -i=PATH -o=PATH [-r=SEED] [--all_truth] [--propagate_bunches_together]
       plenoscope-raw-photon-propagation (-h | --help)
       plenoscope-raw-photon-propagation --version
 
@@ -32,6 +32,10 @@ R"(Propagation of raw photons for the Portal Cherenkov-plenoscope
       -o --output=PATH          Output path.
       -r --random_seed=SEED     Seed for pseudo random number generator.
       --all_truth               Write all simulation truth avaiable into the output.
+      --propagate_bunches_together
+                                Trace the photons of a bunch together until
+                                their random decisions differ. Draws the
+                                random numbers in a different order.
       -h --help                 Show this screen.
       --version                 Show version.
 )";
@@ -50,6 +54,8 @@ int main(int argc, char* argv[]) {
     ml::ospath::Path output_path(args.find("--output")->second.asString());
     const bool export_all_simulation_truth =
         args.find("--all_truth")->second.asBool();
+    const bool propagate_bunches_together =
+        args.find("--propagate_bunches_together")->second.asBool();
 
     // 1) create output directory
     fs::create_directory(output_path.path);
@@ -71,9 +77,8 @@ int main(int argc, char* argv[]) {
 
     config_path = ml::ospath::join(
         input_copy_path.path, "propagation_config.json");
-    lixel_calib_path = ml::ospath::join(
-        ml::ospath::join(input_copy_path.path, "plenoscope"),
-        "lixel_statistics.bin");
+    lixel_calib_path = plenoscope::calibration::lixel_statistics_path(
+        ml::ospath::join(input_copy_path.path, "plenoscope"));
     input_path = ml::ospath::join(input_copy_path.path, input_path.basename);
     ml::ospath::Path scenery_path = ml::ospath::join(
         ml::ospath::join(input_copy_path.path, "plenoscope"),
@@ -93,6 +98,7 @@ int main(int argc, char* argv[]) {
     // BASIC SETTINGS
     ml::PropagationConfig settings;
     settings.max_num_interactions_per_photon = 10;
+    settings.propagate_bunches_together = propagate_bunches_together;
 
     //--------------------------------------------------------------------------
     // INIT PRNG
@@ -108,6 +114,7 @@ int main(int argc, char* argv[]) {
         &scenery,
         scenery_path.path);
     scenery.root.init_tree_based_on_mother_child_relations();
+    scenery.surface_tables.assign_to_surfaces_in(&scenery.root);
 
     if (scenery.plenoscopes.size() == 0)
         throw std::invalid_argument("There is no plenoscope in the scenery");
@@ -120,8 +127,11 @@ int main(int argc, char* argv[]) {
 
     //--------------------------------------------------------------------------
     // load light field calibration result
-    std::vector<float> lixel_efficiencies =
-        plenoscope::calibration::read_efficiencies(lixel_calib_path.path);
+    const plenoscope::calibration::LixelEfficiencies lixel_efficiencies =
+        plenoscope::calibration::read_efficiencies(
+            lixel_calib_path.path,
+            plenoscope::calibration::geometry_hash(
+                pis->light_field_sensor_geometry.get_info_header()));
 
 
     // assert number os sub_pixel matches simulated plenoscope
@@ -228,13 +238,13 @@ int main(int argc, char* argv[]) {
 
     //-------------------------
     // Single-photon-extraction
-    sp::PhotonStream::Stream record;
-    record.time_slice_duration = time_slice_duration;
-    record.photon_stream = sp::extract_pulses(
+    sp::PhotonStream::SparseStream record;
+    sp::extract_pulses(
         electric_pipelines,
         time_slice_duration,
         arrival_time_std,
-        &prng);
+        &prng,
+        &record);
 
     //-------------
     // export event
@@ -244,8 +254,7 @@ int main(int argc, char* argv[]) {
     fs::create_directory(event_output_path.path);
 
     sp::PhotonStream::write(
-        record.photon_stream,
-        record.time_slice_duration,
+        record,
         ml::ospath::join(
             event_output_path.path,
             "raw_light_field_sensor_response.phs"));
@@ -316,7 +325,7 @@ int main(int argc, char* argv[]) {
 
     if (export_all_simulation_truth) {
         sp::PhotonStream::write_simulation_truth(
-            record.photon_stream,
+            record,
             ml::ospath::join(
                 event_mc_truth_path.path,
                 "detector_pulse_origins.bin"));
@@ -0,0 +1,125 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <experimental/filesystem>
+#include <iostream>
+#include "docopt/docopt.h"
+#include "merlict_portal_plenoscope/calibration/Calibrator.h"
+#include "merlict_portal_plenoscope/json_to_plenoscope.h"
+#include "merlict/merlict.h"
+namespace fs = std::experimental::filesystem;
+namespace ml = merlict;
+
+
+static const char USAGE[] =
+R"(Response table of the Portal Cherenkov-plenoscope
+
+    Usage:
+      plenoscope-response-table -s=PATH -o=PATH [--num_bins_xy=NUMBER] [--num_bins_c=NUMBER] [--photons_per_bin=NUMBER] [-r=SEED]
+      plenoscope-response-table (-h | --help)
+      plenoscope-response-table --version
+
+    Options:
+      -s --scenery=PATH                             Scenery directory path.
+      -o --output=PATH                              Output path of the table.
+      --num_bins_xy=NUMBER                          Number of bins along x
+                                                    and y on the aperture
+                                                    [default: 16].
+      --num_bins_c=NUMBER                           Number of bins along cx
+                                                    and cy of the incident
+                                                    direction [default: 32].
+      --photons_per_bin=NUMBER                      Number of photons thrown
+                                                    into each bin
+                                                    [default: 100].
+      -r --random_seed=SEED                         Seed for pseudo random
+                                                    number generator.
+      -h --help                                     Show this screen.
+      --version                                     Show version.
+)";
+
+int positive_int(
+    const std::map<std::string, docopt::value> &args,
+    const std::string &key
+) {
+    int value = 0;
+    try {
+        value = ml::txt::to_int(args.find(key)->second.asString());
+    } catch (std::invalid_argument &error) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "Expected '" << key << "' to be an integer number, ";
+        info << "but actual: " << args.find(key)->second.asString();
+        throw std::invalid_argument(info.str());
+    }
+    if (value <= 0) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "Expected '" << key << "' to be > 0, but actual: " << value;
+        throw std::invalid_argument(info.str());
+    }
+    return value;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::map<std::string, docopt::value> args = docopt::docopt(
+            USAGE,
+            { argv + 1, argv + argc },
+            true,        // show help if requested
+            "0.1");  // version string
+
+        const int num_bins_xy = positive_int(args, "--num_bins_xy");
+        const int num_bins_c = positive_int(args, "--num_bins_c");
+        const int photons_per_bin = positive_int(args, "--photons_per_bin");
+
+        ml::ospath::Path out_path(args.find("--output")->second.asString());
+        ml::ospath::Path scenery_path(args.find("--scenery")->second.asString());
+        ml::ospath::Path scenery_file_path = ml::ospath::join(
+            scenery_path.path,
+            "scenery.json");
+
+        // SET UP SCENERY
+        plenoscope::PlenoscopeScenery scenery;
+        plenoscope::json::append_to_frame_in_scenery(
+            &scenery.root,
+            &scenery,
+            scenery_file_path.path);
+        scenery.root.init_tree_based_on_mother_child_relations();
+        scenery.surface_tables.assign_to_surfaces_in(&scenery.root);
+
+        if (scenery.plenoscopes.size() == 0)
+            throw std::invalid_argument(
+                "There is no plenoscope in the scenery");
+        else if (scenery.plenoscopes.size() > 1)
+            throw std::invalid_argument(
+                "There is more than one plenoscope in the scenery");
+        plenoscope::PlenoscopeInScenery* pis = &scenery.plenoscopes.at(0);
+
+        // TABULATE RESPONSE
+        plenoscope::calibration::Config calib_config;
+        plenoscope::calibration::Calibrator calibrator(
+            calib_config,
+            pis,
+            &scenery.root);
+
+        const plenoscope::calibration::ResponseTableBinning binning(
+            num_bins_xy,
+            num_bins_c,
+            calibrator.MAX_APERTURE_PLANE_RADIUS,
+            calibrator.MAX_INCIDENT_ANGLE);
+
+        ml::random::Mt19937 prng(0);
+        if (args.find("--random_seed")->second)
+            prng.set_seed(args.find("--random_seed")->second.asLong());
+
+        plenoscope::calibration::write_response_table(
+            plenoscope::calibration::tabulate_response(
+                calibrator,
+                binning,
+                photons_per_bin,
+                &prng),
+            out_path.path);
+
+    } catch (std::exception &error) {
+        std::cerr << error.what();
+    }
+    return 0;
+}
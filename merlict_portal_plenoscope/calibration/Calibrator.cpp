@@ -1,12 +1,17 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict_portal_plenoscope/calibration/Calibrator.h"
+#include <math.h>
+#include <algorithm>
+#include <functional>
 #include <future>
 #include <fstream>
 #include <sstream>
 #include <thread>
 #include <iomanip>
+#include <map>
 #include <random>
 #include <iostream>
+#include <memory>
 #include "merlict/merlict.h"
 #include "merlict_portal_plenoscope/night_sky_background/NightSkyBackground.h"
 #include "merlict_multi_thread/vitaliy_vitsentiy_thread_pool.h"
@@ -47,25 +52,12 @@ ml::Photon create_photon(
 }
 
 
-CalibrationPhotonResult one_photon(
-    int id,
-    const uint64_t seed,
+CalibrationPhotonResult propagate_photon(
     const Calibrator &cal,
-    const ml::random::ZenithDistancePicker &zenith_picker,
-    const ml::random::UniformPicker &azimuth_picker)
+    const ml::Vec3 &support_on_aperture,
+    const ml::Vec3 &incident_direction,
+    ml::random::Generator *prng)
 {
-    (void)id;
-    ml::random::Mt19937 prng(seed);
-
-    // create photon
-    const ml::Vec3 support_on_aperture = prng.get_point_on_xy_disc_within_radius(
-        cal.MAX_APERTURE_PLANE_RADIUS);
-
-    const ml::Vec3 incident_direction = ml::random::draw_point_on_sphere(
-        &prng,
-        zenith_picker,
-        azimuth_picker);
-
     ml::Photon ph = create_photon(support_on_aperture, incident_direction);
     const double TIME_OF_FLIGHT_TO_REACH_APERTURE_PLANE = (
         DISTANCE_TO_APERTURE_PLANE / merlict::VACUUM_SPPED_OF_LIGHT
@@ -74,7 +66,7 @@ CalibrationPhotonResult one_photon(
     // propagate photon
     ml::PropagationEnvironment env;
     env.root_frame = cal.world;
-    env.prng = &prng;
+    env.prng = prng;
     ml::Propagator(&ph, env);
 
     ml::sensor::FindSensorByFrame sensor_finder(
@@ -102,14 +94,143 @@ CalibrationPhotonResult one_photon(
 }
 
 
+// With a quasi random sequence, the photon with index id is always the
+// point id of the sequence. The support and the direction take its four
+// dimensions, the propagation continues pseudo randomly from seed.
+CalibrationPhotonResult one_photon(
+    const uint64_t id,
+    const uint64_t seed,
+    const Calibrator &cal,
+    const ml::random::ZenithDistancePicker &zenith_picker,
+    const ml::random::UniformPicker &azimuth_picker,
+    const ml::random::ScrambledHalton *quasi_random = nullptr)
+{
+    if (quasi_random != nullptr) {
+        ml::random::QuasiRandom qrng(quasi_random, id, seed);
+        // The rejection sampling of get_point_on_xy_disc_within_radius()
+        // would take a varying number of dimensions.
+        const ml::Vec3 support_on_aperture =
+            qrng.get_point_on_xy_disc_within_radius_slow(
+                cal.MAX_APERTURE_PLANE_RADIUS);
+        const ml::Vec3 incident_direction = ml::random::draw_point_on_sphere(
+            &qrng,
+            zenith_picker,
+            azimuth_picker);
+        return propagate_photon(
+            cal,
+            support_on_aperture,
+            incident_direction,
+            &qrng);
+    }
+
+    ml::random::Mt19937 prng(seed);
+
+    // create photon
+    const ml::Vec3 support_on_aperture = prng.get_point_on_xy_disc_within_radius(
+        cal.MAX_APERTURE_PLANE_RADIUS);
+
+    const ml::Vec3 incident_direction = ml::random::draw_point_on_sphere(
+        &prng,
+        zenith_picker,
+        azimuth_picker);
+
+    return propagate_photon(
+        cal,
+        support_on_aperture,
+        incident_direction,
+        &prng);
+}
+
+CalibrationPhotonResult one_stratified_photon(
+    const uint64_t id,
+    const uint64_t seed,
+    const Calibrator &cal,
+    const Strata &strata,
+    const uint64_t stratum,
+    const ml::random::ScrambledHalton *quasi_random)
+{
+    if (quasi_random != nullptr) {
+        ml::random::QuasiRandom qrng(quasi_random, id, seed);
+        const ml::Vec3 support = strata.draw_support_on_aperture(
+            stratum,
+            &qrng);
+        const ml::Vec3 direction = strata.draw_incident_direction(
+            stratum,
+            &qrng);
+        return propagate_photon(cal, support, direction, &qrng);
+    }
+
+    ml::random::Mt19937 prng(seed);
+    const ml::Vec3 support = strata.draw_support_on_aperture(stratum, &prng);
+    const ml::Vec3 direction = strata.draw_incident_direction(stratum, &prng);
+    return propagate_photon(cal, support, direction, &prng);
+}
+
+
+// With symmetries, the result is filled into all its images, each with
+// an equal share of the weight. A lixel thus collects the photons of all
+// the lixels in its orbit, transformed into its own frame.
+void fill_symmetric(
+    LixelStatisticsFiller *filler,
+    const CalibrationPhotonResult &result,
+    const double weight,
+    const LixelSymmetries *symmetries)
+{
+    if (symmetries == nullptr || !result.reached_sensor) {
+        filler->fill(result, weight);
+        return;
+    }
+    const double image_weight = weight/symmetries->size();
+    for (uint64_t s = 0; s < symmetries->size(); s++)
+        filler->fill(symmetries->image(s, result), image_weight);
+}
+
+std::unique_ptr<LixelSymmetries> make_symmetries(const Calibrator &cal) {
+    std::unique_ptr<LixelSymmetries> symmetries;
+    if (cal.config.symmetric) {
+        symmetries.reset(new LixelSymmetries(
+            cal.plenoscope->light_field_sensor_geometry));
+        std::cout << "Plenoscope Calibrator: ";
+        std::cout << symmetries->size() << " symmetries\n";
+    }
+    return symmetries;
+}
+
+
+// Each filler is filled by one task of the pool, which works through its
+// chunks in their order, see NUM_FILLERS. So no photon results are stored
+// and no locking is needed.
+void fill_chunks_in_order(
+    const uint64_t num_chunks,
+    const uint64_t num_fillers,
+    const std::function<void(uint64_t chunk, uint64_t filler)> &fill_chunk,
+    ml::ctpl::thread_pool *pool)
+{
+    std::vector<std::future<void>> futs;
+    futs.reserve(num_fillers);
+    for (uint64_t f = 0; f < num_fillers && f < num_chunks; f++) {
+        futs.push_back(pool->push(
+            [&, f](int thread_id) {
+                (void)thread_id;
+                for (uint64_t c = f; c < num_chunks; c += num_fillers)
+                    fill_chunk(c, f);
+            }));
+    }
+
+    for (uint64_t i = 0; i < futs.size(); i ++) {
+        futs[i].get();
+    }
+}
+
 void fill_another_block(
     const Calibrator &cal,
-    LixelStatisticsFiller *lixel_statistics_filler,
+    const uint64_t block,
+    const ml::random::ScrambledHalton *quasi_random,
+    const LixelSymmetries *symmetries,
+    std::vector<LixelStatisticsFiller> *fillers,
+    ml::ctpl::thread_pool *pool,
     ml::random::Generator *prng)
 {
-    std::vector<CalibrationPhotonResult> photon_results(
-        cal.config.photons_per_block);
-
     const ml::random::ZenithDistancePicker zenith_picker(
         0.0,
         cal.MAX_INCIDENT_ANGLE);
@@ -117,40 +238,312 @@ void fill_another_block(
         0.0,
         2*M_PI);
 
-    std::vector<uint64_t> prng_seeds(photon_results.size());
-    for (uint64_t i = 0; i < photon_results.size(); i ++) {
-        prng_seeds[i] = prng->create_seed();
-    }
+    const uint64_t num_photons = cal.config.photons_per_block;
+    std::vector<uint64_t> chunk_seeds;
+    for (
+        uint64_t chunk_begin = 0;
+        chunk_begin < num_photons;
+        chunk_begin += PHOTONS_PER_CHUNK
+    )
+        chunk_seeds.push_back(prng->create_seed());
+
+    fill_chunks_in_order(
+        chunk_seeds.size(),
+        fillers->size(),
+        [&](const uint64_t chunk, const uint64_t f) {
+            const uint64_t chunk_begin = chunk*PHOTONS_PER_CHUNK;
+            const uint64_t chunk_end = std::min(
+                chunk_begin + PHOTONS_PER_CHUNK,
+                num_photons);
+            ml::random::Mt19937 chunk_prng(chunk_seeds[chunk]);
+            LixelStatisticsFiller &filler = fillers->at(f);
+            for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+                fill_symmetric(
+                    &filler,
+                    one_photon(
+                        block*num_photons + i,
+                        chunk_prng.create_seed(),
+                        cal,
+                        zenith_picker,
+                        azimuth_picker,
+                        quasi_random),
+                    1.0,
+                    symmetries);
+            }
+        },
+        pool);
+}
 
-    uint64_t num_threads = std::thread::hardware_concurrency();
-    merlict::ctpl::thread_pool pool(num_threads);
-    std::vector<std::future<CalibrationPhotonResult>> futs(
-        photon_results.size());
-    for (uint64_t i = 0; i < futs.size(); ++i) {
-        futs[i] = pool.push(
-            one_photon,
-            prng_seeds[i],
-            cal,
-            zenith_picker,
-            azimuth_picker);
+// Merges all fillers into fillers->at(0). The lixels are split into
+// ranges which are merged in parallel.
+void merge_fillers(
+    std::vector<LixelStatisticsFiller> *fillers,
+    ml::ctpl::thread_pool *pool)
+{
+    const uint64_t num_lixel = fillers->at(0).num_lixel();
+    const uint64_t num_ranges = fillers->size();
+    const uint64_t lixel_per_range = num_lixel/num_ranges + 1u;
+
+    std::vector<std::future<void>> futs;
+    for (
+        uint64_t lixel_begin = 0;
+        lixel_begin < num_lixel;
+        lixel_begin += lixel_per_range
+    ) {
+        const uint64_t lixel_end = std::min(
+            lixel_begin + lixel_per_range,
+            num_lixel);
+        futs.push_back(pool->push(
+            [fillers, lixel_begin, lixel_end](int thread_id) {
+                (void)thread_id;
+                for (uint64_t f = 1; f < fillers->size(); f++)
+                    fillers->at(0).merge(
+                        fillers->at(f),
+                        lixel_begin,
+                        lixel_end);
+            }));
     }
 
     for (uint64_t i = 0; i < futs.size(); i ++) {
-        photon_results[i] = futs[i].get();
+        futs[i].get();
     }
+}
 
-    lixel_statistics_filler->fill_in_block(photon_results);
+std::vector<uint64_t> distribute_photons_to_strata(
+    const uint64_t num_photons,
+    const double uniform_fraction,
+    const std::vector<uint64_t> &need
+) {
+    const uint64_t num_strata = need.size();
+    uint64_t total_need = 0u;
+    for (const uint64_t n : need)
+        total_need += n;
+
+    std::vector<uint64_t> photons_in_stratum(num_strata);
+    for (uint64_t s = 0; s < num_strata; s++) {
+        double share = 1.0/num_strata;
+        if (total_need > 0u)
+            share = uniform_fraction/num_strata +
+                (1.0 - uniform_fraction)*
+                static_cast<double>(need[s])/
+                static_cast<double>(total_need);
+        photons_in_stratum[s] = std::max(
+            static_cast<uint64_t>(1u),
+            static_cast<uint64_t>(llround(share*num_photons)));
+    }
+    return photons_in_stratum;
 }
 
-void run_calibration(
+// The strata have equal measure. Weighting the photons in stratum s with
+// photons_per_block/(num_strata*photons_in_stratum[s]) makes the block
+// estimate the same statistics as a block with uniformly drawn photons.
+// Hits in lixels which are not converged yet are counted in
+// needs->at(f) for each stratum, next to fillers->at(f). The photons of a
+// stratum are indexed from first_id_in_stratum[s] on, to continue its
+// quasi random sequence in the next block.
+void fill_another_stratified_block(
+    const Calibrator &cal,
+    const Strata &strata,
+    const std::vector<uint64_t> &photons_in_stratum,
+    const std::vector<uint64_t> &first_id_in_stratum,
+    const ml::random::ScrambledHalton *quasi_random,
+    const LixelSymmetries *symmetries,
+    const std::vector<uint8_t> &converged,
+    std::vector<LixelStatisticsFiller> *fillers,
+    std::vector<std::vector<uint64_t>> *needs,
+    ml::ctpl::thread_pool *pool,
+    ml::random::Generator *prng)
+{
+    struct Chunk {
+        uint64_t stratum;
+        uint64_t begin;
+        uint64_t end;
+        uint64_t seed;
+    };
+    std::vector<Chunk> chunks;
+    for (uint64_t s = 0; s < strata.size(); s++) {
+        for (
+            uint64_t chunk_begin = 0;
+            chunk_begin < photons_in_stratum[s];
+            chunk_begin += PHOTONS_PER_CHUNK
+        ) {
+            Chunk chunk;
+            chunk.stratum = s;
+            chunk.begin = chunk_begin;
+            chunk.end = std::min(
+                chunk_begin + PHOTONS_PER_CHUNK,
+                photons_in_stratum[s]);
+            chunk.seed = prng->create_seed();
+            chunks.push_back(chunk);
+        }
+    }
+
+    fill_chunks_in_order(
+        chunks.size(),
+        fillers->size(),
+        [&](const uint64_t c, const uint64_t f) {
+            const Chunk &chunk = chunks[c];
+            const uint64_t s = chunk.stratum;
+            const double weight =
+                static_cast<double>(cal.config.photons_per_block)/
+                static_cast<double>(strata.size()*photons_in_stratum[s]);
+            ml::random::Mt19937 chunk_prng(chunk.seed);
+            LixelStatisticsFiller &filler = fillers->at(f);
+            std::vector<uint64_t> &need = needs->at(f);
+            for (uint64_t i = chunk.begin; i < chunk.end; i++) {
+                const CalibrationPhotonResult result =
+                    one_stratified_photon(
+                        first_id_in_stratum[s] + i,
+                        chunk_prng.create_seed(),
+                        cal,
+                        strata,
+                        s,
+                        quasi_random);
+                fill_symmetric(&filler, result, weight, symmetries);
+                if (
+                    result.reached_sensor &&
+                    !converged[result.lixel_id]
+                )
+                    need[s]++;
+            }
+        },
+        pool);
+}
+
+// The aperture and the direction take two dimensions each.
+const uint32_t NUM_QUASI_RANDOM_DIMENSIONS = 4u;
+
+std::unique_ptr<ml::random::ScrambledHalton> make_quasi_random(
     const Calibrator &cal,
-    const std::string &path,
     ml::random::Generator *prng
 ) {
-    LixelStatisticsFiller lixel_statistics_filler(
-        cal.plenoscope->light_field_sensor_geometry.num_lixel(),
-        cal.config.num_blocks,
+    std::unique_ptr<ml::random::ScrambledHalton> quasi_random;
+    if (cal.config.quasi_random)
+        quasi_random.reset(new ml::random::ScrambledHalton(
+            NUM_QUASI_RANDOM_DIMENSIONS,
+            prng->create_seed()));
+    return quasi_random;
+}
+
+LixelStatisticsFiller calibrate_adaptive(
+    const Calibrator &cal,
+    ml::random::Generator *prng
+) {
+    const uint64_t num_threads = std::max(
+        1u,
+        std::thread::hardware_concurrency());
+    ml::ctpl::thread_pool pool(num_threads);
+
+    const uint64_t num_lixel =
+        cal.plenoscope->light_field_sensor_geometry.num_lixel();
+    const Strata strata(
+        cal.MAX_APERTURE_PLANE_RADIUS,
+        cal.MAX_INCIDENT_ANGLE,
+        cal.config.num_aperture_rings,
+        cal.config.num_aperture_sectors,
+        cal.config.num_zenith_rings,
+        cal.config.num_azimuth_sectors);
+
+    std::vector<LixelStatisticsFiller> fillers(
+        NUM_FILLERS,
+        LixelStatisticsFiller(
+            num_lixel,
+            cal.config.num_blocks,
+            cal.config.photons_per_block));
+    std::vector<uint8_t> converged(num_lixel, 0u);
+    std::vector<uint64_t> need(strata.size(), 0u);
+    std::vector<uint64_t> first_id_in_stratum(strata.size(), 0u);
+    const std::unique_ptr<ml::random::ScrambledHalton> quasi_random =
+        make_quasi_random(cal, prng);
+    const std::unique_ptr<LixelSymmetries> symmetries = make_symmetries(cal);
+
+    std::cout << "Plenoscope Calibrator: adaptive, at most ";
+    std::cout << double(cal.num_photons)/1.0e6 << "e6 photons in ";
+    std::cout << strata.size() << " strata\n";
+
+    uint64_t num_blocks = 0u;
+    while (num_blocks < cal.config.num_blocks) {
+        const std::vector<uint64_t> photons_in_stratum =
+            distribute_photons_to_strata(
+                cal.config.photons_per_block,
+                cal.config.uniform_fraction,
+                need);
+        std::vector<std::vector<uint64_t>> needs(
+            NUM_FILLERS,
+            std::vector<uint64_t>(strata.size(), 0u));
+        fill_another_stratified_block(
+            cal,
+            strata,
+            photons_in_stratum,
+            first_id_in_stratum,
+            quasi_random.get(),
+            symmetries.get(),
+            converged,
+            &fillers,
+            &needs,
+            &pool,
+            prng);
+        num_blocks++;
+        for (uint64_t s = 0; s < strata.size(); s++)
+            first_id_in_stratum[s] += photons_in_stratum[s];
+
+        merge_fillers(&fillers, &pool);
+        for (uint64_t f = 1; f < fillers.size(); f++)
+            fillers.at(f).clear();
+
+        uint64_t num_hit = 0u;
+        uint64_t num_converged = 0u;
+        const std::vector<OnlineLixelStatistics> &lixel_stats =
+            fillers.at(0).online_lixel_statistics();
+        for (uint64_t i = 0; i < num_lixel; i++) {
+            converged[i] = lixel_stats[i].relative_uncertainty() <=
+                cal.config.target_relative_uncertainty;
+            num_hit += lixel_stats[i].count > 0u;
+            num_converged += converged[i];
+        }
+        std::cout << num_blocks << " of " << cal.config.num_blocks << ", ";
+        std::cout << num_converged << " of " << num_hit;
+        std::cout << " hit lixels converged\n";
+        if (num_converged == num_hit)
+            break;
+
+        for (uint64_t s = 0; s < strata.size(); s++) {
+            need[s] = 0u;
+            for (uint64_t f = 0; f < NUM_FILLERS; f++)
+                need[s] += needs[f][s];
+        }
+    }
+
+    LixelStatisticsFiller result(
+        num_lixel,
+        num_blocks,
         cal.config.photons_per_block);
+    result.merge(fillers.at(0).online_lixel_statistics());
+    return result;
+}
+
+LixelStatisticsFiller calibrate(
+    const Calibrator &cal,
+    ml::random::Generator *prng
+) {
+    if (cal.config.adaptive)
+        return calibrate_adaptive(cal, prng);
+
+    const uint64_t num_threads = std::max(
+        1u,
+        std::thread::hardware_concurrency());
+    ml::ctpl::thread_pool pool(num_threads);
+
+    std::vector<LixelStatisticsFiller> fillers(
+        NUM_FILLERS,
+        LixelStatisticsFiller(
+            cal.plenoscope->light_field_sensor_geometry.num_lixel(),
+            cal.config.num_blocks,
+            cal.config.photons_per_block));
+
+    const std::unique_ptr<ml::random::ScrambledHalton> quasi_random =
+        make_quasi_random(cal, prng);
+    const std::unique_ptr<LixelSymmetries> symmetries = make_symmetries(cal);
 
     std::cout << "Plenoscope Calibrator: propagating ";
     std::cout << double(cal.num_photons)/1.0e6 << "e6 photons\n";
@@ -159,12 +552,165 @@ void run_calibration(
         std::cout << block + 1 << " of " << cal.config.num_blocks << "\n";
         fill_another_block(
             cal,
-            &lixel_statistics_filler,
+            block,
+            quasi_random.get(),
+            symmetries.get(),
+            &fillers,
+            &pool,
             prng);
     }
-    std::vector<LixelStatistic> lixel_statistics =
-        lixel_statistics_filler.get_lixel_statistics();
-    write(lixel_statistics, path);
+    merge_fillers(&fillers, &pool);
+    return fillers.at(0);
+}
+
+// The photons are drawn by rejection within the bin. A direction within
+// the field of view is accepted with probability min_cz/cz, which makes
+// the directions uniform in solid angle instead of uniform in cx, cy.
+std::vector<ResponseEntry> tabulate_bin(
+    const Calibrator &cal,
+    const ResponseTableBinning &binning,
+    const uint64_t bin,
+    const uint64_t num_photons_per_bin,
+    ml::random::Generator *prng)
+{
+    std::vector<ResponseEntry> entries;
+    if (!binning.overlaps_aperture_and_field_of_view(bin))
+        return entries;
+
+    double x_begin, y_begin, cx_begin, cy_begin;
+    binning.lower_edges(bin, &x_begin, &y_begin, &cx_begin, &cy_begin);
+    const double xy_width = binning.xy_bin_width();
+    const double c_width = binning.c_bin_width();
+    const double max_r_square =
+        binning.aperture_radius*binning.aperture_radius;
+    const double max_c_square = binning.max_c()*binning.max_c();
+    const double min_cz = cos(binning.max_incident_angle);
+
+    // lixel -> (count, sum of time delays)
+    std::map<uint32_t, std::pair<uint64_t, double>> hits;
+    for (uint64_t i = 0; i < num_photons_per_bin; i++) {
+        double x, y;
+        do {
+            x = x_begin + prng->uniform()*xy_width;
+            y = y_begin + prng->uniform()*xy_width;
+        } while (x*x + y*y >= max_r_square);
+
+        double cx, cy, cz;
+        do {
+            cx = cx_begin + prng->uniform()*c_width;
+            cy = cy_begin + prng->uniform()*c_width;
+            cz = sqrt(std::max(0.0, 1.0 - cx*cx - cy*cy));
+        } while (cx*cx + cy*cy >= max_c_square || prng->uniform()*cz >= min_cz);
+
+        const CalibrationPhotonResult result = propagate_photon(
+            cal,
+            ml::Vec3(x, y, 0.0),
+            ml::Vec3(cx, cy, cz),
+            prng);
+        if (result.reached_sensor) {
+            std::pair<uint64_t, double> &hit = hits[result.lixel_id];
+            hit.first++;
+            hit.second += result.time_of_flight;
+        }
+    }
+
+    entries.reserve(hits.size());
+    for (const std::pair<const uint32_t, std::pair<uint64_t, double>> &hit :
+        hits
+    ) {
+        ResponseEntry entry;
+        entry.lixel = hit.first;
+        entry.probability = static_cast<double>(hit.second.first)/
+            static_cast<double>(num_photons_per_bin);
+        entry.time_delay = hit.second.second/hit.second.first;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+// Each chunk of the pool owns a range of bins, so the entries of the bins
+// can be written without locking.
+ResponseTable tabulate_response(
+    const Calibrator &cal,
+    const ResponseTableBinning &binning,
+    const uint64_t num_photons_per_bin,
+    ml::random::Generator *prng
+) {
+    const uint64_t num_threads = std::max(
+        1u,
+        std::thread::hardware_concurrency());
+    ml::ctpl::thread_pool pool(num_threads);
+
+    const uint64_t num_bins = binning.size();
+    std::cout << "Plenoscope Calibrator: tabulating the response in ";
+    std::cout << num_bins << " bins with " << num_photons_per_bin;
+    std::cout << " photons each\n";
+
+    std::vector<std::vector<ResponseEntry>> bin_entries(num_bins);
+    const uint64_t bins_per_chunk = std::max(
+        static_cast<uint64_t>(1u),
+        PHOTONS_PER_CHUNK/std::max(
+            static_cast<uint64_t>(1u),
+            num_photons_per_bin));
+    std::vector<std::future<void>> futs;
+    futs.reserve(num_bins/bins_per_chunk + 1u);
+    for (
+        uint64_t chunk_begin = 0;
+        chunk_begin < num_bins;
+        chunk_begin += bins_per_chunk
+    ) {
+        const uint64_t chunk_end = std::min(
+            chunk_begin + bins_per_chunk,
+            num_bins);
+        const uint64_t chunk_seed = prng->create_seed();
+        futs.push_back(pool.push(
+            [&, chunk_begin, chunk_end, chunk_seed](int thread_id) {
+                (void)thread_id;
+                ml::random::Mt19937 chunk_prng(chunk_seed);
+                for (uint64_t b = chunk_begin; b < chunk_end; b++)
+                    bin_entries[b] = tabulate_bin(
+                        cal,
+                        binning,
+                        b,
+                        num_photons_per_bin,
+                        &chunk_prng);
+            }));
+    }
+
+    for (uint64_t i = 0; i < futs.size(); i ++) {
+        futs[i].get();
+    }
+
+    ResponseTable table(
+        binning,
+        geometry_hash(
+            cal.plenoscope->light_field_sensor_geometry.get_info_header()),
+        cal.plenoscope->light_field_sensor_geometry.num_lixel(),
+        num_photons_per_bin);
+    for (uint64_t b = 0; b < num_bins; b++)
+        table.append_bin(bin_entries[b]);
+    return table;
+}
+
+void run_calibration(
+    const Calibrator &cal,
+    const std::string &path,
+    ml::random::Generator *prng
+) {
+    const LixelStatisticsFiller filler = calibrate(cal, prng);
+    write(filler.get_lixel_statistics(), path);
+}
+
+void run_calibration_partial_output(
+    const Calibrator &cal,
+    const std::string &path,
+    ml::random::Generator *prng
+) {
+    const LixelStatisticsFiller filler = calibrate(cal, prng);
+    write_partial(
+        filler.online_lixel_statistics(),
+        filler.num_photons_emitted,
+        path);
 }
 
 
@@ -8,6 +8,10 @@
 #include "merlict_portal_plenoscope/calibration/Config.h"
 #include "merlict_portal_plenoscope/calibration/CalibrationPhotonResult.h"
 #include "merlict_portal_plenoscope/calibration/LixelStatisticsFiller.h"
+#include "merlict_portal_plenoscope/calibration/LixelSymmetries.h"
+#include "merlict_portal_plenoscope/calibration/PartialLixelStatistics.h"
+#include "merlict_portal_plenoscope/calibration/ResponseTable.h"
+#include "merlict_portal_plenoscope/calibration/Strata.h"
 #include "merlict/merlict.h"
 
 namespace plenoscope {
@@ -29,12 +33,49 @@ struct Calibrator {
 
 const double WAVELENGTH = 433e-9;
 const double DISTANCE_TO_APERTURE_PLANE = 1e4;
+const uint64_t PHOTONS_PER_CHUNK = 4096u;
+// The chunks of photons are accumulated into this many fillers, chunk c
+// into filler c % NUM_FILLERS in the order of the chunks. The fillers are
+// merged in their order. So the statistics are reproducible for a seed,
+// no matter the number of threads or their scheduling.
+const uint64_t NUM_FILLERS = 16u;
+
+// Distributes num_photons to the strata. A uniform_fraction is distributed
+// uniformly, the rest in proportion to need. Each stratum gets at least one
+// photon so that the weighted statistics stay unbiased.
+std::vector<uint64_t> distribute_photons_to_strata(
+    const uint64_t num_photons,
+    const double uniform_fraction,
+    const std::vector<uint64_t> &need);
+
+// Propagates all calibration photons and returns the merged statistics.
+// See Config for the adaptive mode.
+LixelStatisticsFiller calibrate(
+    const Calibrator &cal,
+    merlict::random::Generator *prng);
+
+// Tabulates the response of the plenoscope for each bin of the binning,
+// see ResponseTable.h. In each bin which overlaps the aperture disc and the
+// field of view, num_photons_per_bin photons are drawn uniformly on the
+// aperture and uniformly in solid angle, as the night sky background is.
+ResponseTable tabulate_response(
+    const Calibrator &cal,
+    const ResponseTableBinning &binning,
+    const uint64_t num_photons_per_bin,
+    merlict::random::Generator *prng);
 
 void run_calibration(
     const Calibrator &cal,
     const std::string &path,
     merlict::random::Generator *prng);
 
+// Writes the mergeable partial statistics of a map-job, see
+// PartialLixelStatistics.h.
+void run_calibration_partial_output(
+    const Calibrator &cal,
+    const std::string &path,
+    merlict::random::Generator *prng);
+
 void run_calibration_raw_output(
     const Calibrator &cal,
     const std::string &path,
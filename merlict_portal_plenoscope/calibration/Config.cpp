@@ -7,6 +7,15 @@ namespace calibration {
 Config::Config() {
     num_blocks = 8;
     photons_per_block = 1e6;
+    quasi_random = false;
+    symmetric = false;
+    adaptive = false;
+    target_relative_uncertainty = 0.05;
+    uniform_fraction = 0.25;
+    num_aperture_rings = 3;
+    num_aperture_sectors = 6;
+    num_zenith_rings = 8;
+    num_azimuth_sectors = 12;
 }
 
 }  // namespace calibration
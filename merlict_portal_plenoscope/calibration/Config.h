@@ -10,6 +10,32 @@ namespace calibration {
 struct Config {
     uint32_t num_blocks;
     uint32_t photons_per_block;
+
+    // Draw the support on the aperture and the incident direction of the
+    // photon with index i from the point i of a scrambled Halton sequence
+    // instead of pseudo randomly. The points are well spread across blocks
+    // and threads, which lowers the uncertainty for the same num. photons.
+    bool quasi_random;
+
+    // Assume that the imaging system is symmetric under the symmetries of
+    // the light field sensor's hexagonal grids, see LixelSymmetries.
+    // Each photon then contributes to all lixels in its lixel's orbit, and
+    // up to 12 times less photons give the same uncertainty.
+    bool symmetric;
+
+    // In the adaptive mode, num_blocks is the maximum number of blocks.
+    // After each block, the photons of the next block are distributed to
+    // the strata in proportion to their hits in lixels which did not reach
+    // the target_relative_uncertainty yet. A uniform_fraction of each block
+    // is always distributed uniformly. The calibration stops early when all
+    // lixels which were hit reached the target_relative_uncertainty.
+    bool adaptive;
+    double target_relative_uncertainty;
+    double uniform_fraction;
+    uint32_t num_aperture_rings;
+    uint32_t num_aperture_sectors;
+    uint32_t num_zenith_rings;
+    uint32_t num_azimuth_sectors;
     Config();
 };
 
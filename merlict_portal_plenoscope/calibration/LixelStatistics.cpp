@@ -1,7 +1,9 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict_portal_plenoscope/calibration/LixelStatistics.h"
+#include <string.h>
 #include <sstream>
 #include <fstream>
+#include "merlict/ospath.h"
 
 
 namespace plenoscope {
@@ -34,30 +36,141 @@ void write(
     file.close();
 }
 
-std::vector<LixelStatistic> read(const std::string &path) {
+namespace {
+
+const uint64_t HEADER_SIZE = 2*sizeof(uint32_t) + 5*sizeof(uint64_t);
+
+std::vector<LixelStatistic> read_legacy(const std::string &path) {
     std::ifstream file;
-    file.open(path, std::ios::binary);
+    file.open(path, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
         std::stringstream info;
         info << __FILE__ << " " << __LINE__ << "\n";
         info << "LixelStatistics: Unable to read file: '" << path << "'\n";
         throw std::runtime_error(info.str());
     }
+    const uint64_t file_size = file.tellg();
+    file.seekg(0);
+    std::vector<LixelStatistic> lixel_statistics(
+        file_size/sizeof(LixelStatistic));
+    file.read(
+        reinterpret_cast<char*>(lixel_statistics.data()),
+        lixel_statistics.size()*sizeof(LixelStatistic));
+    file.close();
+    return lixel_statistics;
+}
+
+uint64_t round_up_to_page(const uint64_t num_bytes) {
+    return ((num_bytes + LIXEL_STATISTICS_PAGE_SIZE - 1u)/
+        LIXEL_STATISTICS_PAGE_SIZE)*LIXEL_STATISTICS_PAGE_SIZE;
+}
+
+template<typename T>
+T take(const uint8_t* data, uint64_t *pos) {
+    T value;
+    memcpy(&value, data + *pos, sizeof(T));
+    *pos += sizeof(T);
+    return value;
+}
+
+template<typename T>
+void put(std::vector<char> *buffer, uint64_t *pos, const T value) {
+    memcpy(buffer->data() + *pos, &value, sizeof(T));
+    *pos += sizeof(T);
+}
+
+}  // namespace
+
+std::vector<LixelStatistic> read(const std::string &path) {
+    if (!is_columnar(path))
+        return read_legacy(path);
+    const MappedLixelStatistics mapped(path);
+    std::vector<LixelStatistic> lixel_statistics(mapped.num_lixel());
+    for (uint64_t i = 0; i < mapped.num_lixel(); i++)
+        lixel_statistics[i] = mapped.at(i);
+    return lixel_statistics;
+}
+
+LixelEfficiencies read_efficiencies(const std::string &path) {
+    return LixelEfficiencies(path);
+}
+
+LixelEfficiencies read_efficiencies(
+    const std::string &path,
+    const uint64_t expected_geometry_hash
+) {
+    LixelEfficiencies efficiencies(path);
+    if (
+        efficiencies.is_mapped() &&
+        efficiencies.geometry_hash() != expected_geometry_hash
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "LixelStatistics: The calibration in '" << path << "' ";
+        info << "belongs to a different light field sensor geometry. ";
+        info << "Expected geometry_hash " << expected_geometry_hash;
+        info << ", but actual " << efficiencies.geometry_hash() << ".\n";
+        throw std::invalid_argument(info.str());
+    }
+    return efficiencies;
+}
+
+uint64_t geometry_hash(const std::array<float, 273> &info_header) {
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(
+        info_header.data());
+    for (uint64_t i = 0; i < sizeof(float)*info_header.size(); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
 
-    std::vector<LixelStatistic> lixel_statistics;
-    while (true) {
-        LixelStatistic lixel;
-        file.read((char*)&lixel, sizeof(LixelStatistic));
-        if (!file.eof())
-            lixel_statistics.push_back(lixel);
-        else
-            break;
+void write_columns(
+    const std::vector<LixelStatistic> &lixel_statistics,
+    const uint64_t geometry_hash,
+    const std::string &path
+) {
+    const uint64_t num_lixel = lixel_statistics.size();
+    const uint64_t first_column_offset = round_up_to_page(HEADER_SIZE);
+    const uint64_t column_stride = round_up_to_page(num_lixel*sizeof(float));
+    std::vector<char> buffer(
+        first_column_offset +
+        NUM_LIXEL_STATISTIC_COLUMNS*column_stride,
+        0);
+
+    uint64_t pos = 0u;
+    put<uint32_t>(&buffer, &pos, LIXEL_STATISTICS_MAGIC);
+    put<uint32_t>(&buffer, &pos, LIXEL_STATISTICS_VERSION);
+    put<uint64_t>(&buffer, &pos, num_lixel);
+    put<uint64_t>(&buffer, &pos, geometry_hash);
+    put<uint64_t>(&buffer, &pos, NUM_LIXEL_STATISTIC_COLUMNS);
+    put<uint64_t>(&buffer, &pos, first_column_offset);
+    put<uint64_t>(&buffer, &pos, column_stride);
+
+    // LixelStatistic is a plain struct of NUM_LIXEL_STATISTIC_COLUMNS floats
+    // in the order of the columns.
+    for (uint64_t c = 0; c < NUM_LIXEL_STATISTIC_COLUMNS; c++) {
+        float* column = reinterpret_cast<float*>(
+            buffer.data() + first_column_offset + c*column_stride);
+        for (uint64_t i = 0; i < num_lixel; i++)
+            column[i] = reinterpret_cast<const float*>(
+                &lixel_statistics[i])[c];
     }
+
+    std::ofstream file;
+    file.open(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "LixelStatistics: Unable to write file: '" << path << "'\n";
+        throw std::runtime_error(info.str());
+    }
+    file.write(buffer.data(), buffer.size());
     file.close();
-    return lixel_statistics;
 }
 
-std::vector<float> read_efficiencies(const std::string &path) {
+bool is_columnar(const std::string &path) {
     std::ifstream file;
     file.open(path, std::ios::binary);
     if (!file.is_open()) {
@@ -66,21 +179,117 @@ std::vector<float> read_efficiencies(const std::string &path) {
         info << "LixelStatistics: Unable to read file: '" << path << "'\n";
         throw std::runtime_error(info.str());
     }
+    uint32_t magic = 0u;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return file.gcount() == sizeof(magic) && magic == LIXEL_STATISTICS_MAGIC;
+}
+
+std::string lixel_statistics_path(const std::string &calibration_dir) {
+    const std::string columns_path = merlict::ospath::join(
+        calibration_dir,
+        LIXEL_STATISTICS_COLUMNS_FILENAME);
+    std::ifstream file(columns_path);
+    if (file.good())
+        return columns_path;
+    return merlict::ospath::join(calibration_dir, LIXEL_STATISTICS_FILENAME);
+}
 
-    std::vector<float> efficiencies;
+MappedLixelStatistics::MappedLixelStatistics(const std::string &path):
+    map(path) {
+    if (map.size() < HEADER_SIZE) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "LixelStatistics: File '" << path << "' is too small ";
+        info << "for the header of the columnar layout.\n";
+        throw std::runtime_error(info.str());
+    }
+    uint64_t pos = 0u;
+    const uint32_t magic = take<uint32_t>(map.data(), &pos);
+    const uint32_t version = take<uint32_t>(map.data(), &pos);
+    num_lixel_ = take<uint64_t>(map.data(), &pos);
+    geometry_hash_ = take<uint64_t>(map.data(), &pos);
+    const uint64_t num_columns = take<uint64_t>(map.data(), &pos);
+    first_column_offset = take<uint64_t>(map.data(), &pos);
+    column_stride = take<uint64_t>(map.data(), &pos);
 
-    while (true) {
-        LixelStatistic lixel;
-        file.read((char*)&lixel, sizeof(LixelStatistic));
-        if (!file.eof())
-            efficiencies.push_back(lixel.efficiency);
-        else
-            break;
+    if (
+        magic != LIXEL_STATISTICS_MAGIC ||
+        version != LIXEL_STATISTICS_VERSION ||
+        num_columns != NUM_LIXEL_STATISTIC_COLUMNS ||
+        column_stride < num_lixel_*sizeof(float) ||
+        map.size() < first_column_offset + num_columns*column_stride
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "LixelStatistics: File '" << path << "' is not a valid ";
+        info << "columnar lixel statistics of version ";
+        info << LIXEL_STATISTICS_VERSION << ".\n";
+        throw std::runtime_error(info.str());
     }
-    file.close();
+}
 
+uint64_t MappedLixelStatistics::num_lixel()const {
+    return num_lixel_;
+}
+
+uint64_t MappedLixelStatistics::geometry_hash()const {
+    return geometry_hash_;
+}
+
+const float* MappedLixelStatistics::column(
+    const LixelStatisticColumn column
+)const {
+    return reinterpret_cast<const float*>(
+        map.data() + first_column_offset + column*column_stride);
+}
+
+LixelStatistic MappedLixelStatistics::at(const uint64_t lixel)const {
+    LixelStatistic stat;
+    float* fields = reinterpret_cast<float*>(&stat);
+    for (uint64_t c = 0; c < NUM_LIXEL_STATISTIC_COLUMNS; c++)
+        fields[c] = column(static_cast<LixelStatisticColumn>(c))[lixel];
+    return stat;
+}
+
+LixelEfficiencies::LixelEfficiencies(const std::string &path) {
+    if (is_columnar(path)) {
+        mapped.reset(new MappedLixelStatistics(path));
+        efficiencies = mapped->column(EFFICIENCY);
+        num_lixel = mapped->num_lixel();
+    } else {
+        for (const LixelStatistic &lixel : read(path))
+            legacy.push_back(lixel.efficiency);
+        efficiencies = legacy.data();
+        num_lixel = legacy.size();
+    }
+}
+
+uint64_t LixelEfficiencies::size()const {
+    return num_lixel;
+}
+
+float LixelEfficiencies::at(const uint64_t lixel)const {
+    if (lixel >= num_lixel) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "LixelEfficiencies: Expected lixel < " << num_lixel;
+        info << ", but actual lixel = " << lixel << ".\n";
+        throw std::out_of_range(info.str());
+    }
+    return efficiencies[lixel];
+}
+
+const float* LixelEfficiencies::data()const {
     return efficiencies;
 }
 
+bool LixelEfficiencies::is_mapped()const {
+    return mapped != nullptr;
+}
+
+uint64_t LixelEfficiencies::geometry_hash()const {
+    return mapped->geometry_hash();
+}
+
 }  // namespace calibration
 }  // namespace plenoscope
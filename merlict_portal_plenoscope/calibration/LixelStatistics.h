@@ -2,8 +2,12 @@
 #ifndef PLENOSCOPE_CALIBRATION_LIXELSTATISTICS_H_
 #define PLENOSCOPE_CALIBRATION_LIXELSTATISTICS_H_
 
+#include <stdint.h>
+#include <array>
+#include <memory>
 #include <string>
 #include <vector>
+#include "merlict/MemoryMap.h"
 #include "merlict_portal_plenoscope/calibration/CalibrationPhotonResult.h"
 #include "merlict_portal_plenoscope/calibration/Config.h"
 #include "merlict_portal_plenoscope/light_field_sensor/Geometry.h"
@@ -24,11 +28,106 @@ struct LixelStatistic {
 };
 //--lixel_statistics_e--
 
+// The legacy layout is a plain array of LixelStatistic.
 void write(
     const std::vector<LixelStatistic> &lixel_statistics,
     const std::string &path);
+// Both read() and read_efficiencies() accept the legacy and the columnar
+// layout.
 std::vector<LixelStatistic> read(const std::string &path);
-std::vector<float> read_efficiencies(const std::string &path);
+
+// The columnar layout stores each of the LixelStatistic's fields in its own
+// column of num_lixel float32. The columns are aligned to pages so that
+// a reader which maps the file only loads the pages of the columns it
+// touches, and processes on the same node share the pages.
+//
+// header, padded to LIXEL_STATISTICS_PAGE_SIZE:
+//      uint32 LIXEL_STATISTICS_MAGIC
+//      uint32 LIXEL_STATISTICS_VERSION
+//      uint64 num_lixel
+//      uint64 geometry_hash
+//      uint64 num_columns
+//      uint64 first_column_offset
+//      uint64 column_stride
+// columns:
+//      float32[num_lixel] at first_column_offset + column*column_stride
+enum LixelStatisticColumn {
+    EFFICIENCY = 0,
+    EFFICIENCY_STD = 1,
+    CX_MEAN = 2,
+    CX_STD = 3,
+    CY_MEAN = 4,
+    CY_STD = 5,
+    X_MEAN = 6,
+    X_STD = 7,
+    Y_MEAN = 8,
+    Y_STD = 9,
+    TIME_DELAY_MEAN = 10,
+    TIME_DELAY_STD = 11,
+    NUM_LIXEL_STATISTIC_COLUMNS = 12
+};
+
+const uint32_t LIXEL_STATISTICS_MAGIC = 0x5453584c;  // 'LXST'
+const uint32_t LIXEL_STATISTICS_VERSION = 1u;
+const uint64_t LIXEL_STATISTICS_PAGE_SIZE = 4096u;
+const char LIXEL_STATISTICS_FILENAME[] = "lixel_statistics.bin";
+const char LIXEL_STATISTICS_COLUMNS_FILENAME[] =
+    "lixel_statistics.columns.bin";
+
+// FNV-1a of the light field sensor's info header, to tell whether a
+// calibration belongs to a geometry.
+uint64_t geometry_hash(const std::array<float, 273> &info_header);
+
+void write_columns(
+    const std::vector<LixelStatistic> &lixel_statistics,
+    const uint64_t geometry_hash,
+    const std::string &path);
+
+bool is_columnar(const std::string &path);
+
+// Prefers the columnar file in the calibration directory and falls back
+// to the legacy one.
+std::string lixel_statistics_path(const std::string &calibration_dir);
+
+class MappedLixelStatistics {
+    merlict::MemoryMap map;
+    uint64_t num_lixel_;
+    uint64_t geometry_hash_;
+    uint64_t first_column_offset;
+    uint64_t column_stride;
+
+ public:
+    explicit MappedLixelStatistics(const std::string &path);
+    uint64_t num_lixel()const;
+    uint64_t geometry_hash()const;
+    const float* column(const LixelStatisticColumn column)const;
+    LixelStatistic at(const uint64_t lixel)const;
+};
+
+// The efficiencies of the lixels. For the columnar layout this is a view
+// into the mapped efficiency column, so the processes on a node share its
+// pages. Only the legacy layout is copied.
+class LixelEfficiencies {
+    std::unique_ptr<MappedLixelStatistics> mapped;
+    std::vector<float> legacy;
+    const float* efficiencies;
+    uint64_t num_lixel;
+
+ public:
+    explicit LixelEfficiencies(const std::string &path);
+    uint64_t size()const;
+    float at(const uint64_t lixel)const;
+    const float* data()const;
+    bool is_mapped()const;
+    // Only the columnar layout knows its geometry.
+    uint64_t geometry_hash()const;
+};
+
+LixelEfficiencies read_efficiencies(const std::string &path);
+// Throws when a columnar file belongs to a different geometry.
+LixelEfficiencies read_efficiencies(
+    const std::string &path,
+    const uint64_t expected_geometry_hash);
 
 }  // namespace calibration
 }  // namespace plenoscope
@@ -1,6 +1,8 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict_portal_plenoscope/calibration/LixelStatisticsFiller.h"
 #include <math.h>
+#include <sstream>
+#include <stdexcept>
 
 
 namespace plenoscope {
@@ -10,6 +12,7 @@ LixelStatisticsFiller::LixelStatisticsFiller(
     const uint64_t num_lixel,
     const uint64_t num_blocks,
     const uint64_t num_photons_per_block):
+    num_photons_emitted(num_blocks*num_photons_per_block),
     photons_emitted_per_lixel(
         static_cast<double>(num_blocks)*
         static_cast<double>(num_photons_per_block)/
@@ -17,24 +20,69 @@ LixelStatisticsFiller::LixelStatisticsFiller(
     lixel_stats.resize(num_lixel);
 }
 
+void LixelStatisticsFiller::fill(const CalibrationPhotonResult &result) {
+    fill(result, 1.0);
+}
+
+void LixelStatisticsFiller::fill(
+    const CalibrationPhotonResult &result,
+    const double weight
+) {
+    if (result.reached_sensor == true) {
+        OnlineLixelStatistics &lixel = lixel_stats[result.lixel_id];
+        lixel.count++;
+        lixel.sum_weights += weight;
+        lixel.sum_squared_weights += weight*weight;
+        lixel.cx.add(result.x_tilt_vs_optical_axis, weight);
+        lixel.cy.add(result.y_tilt_vs_optical_axis, weight);
+        lixel.x.add(result.x_pos_on_principal_aperture, weight);
+        lixel.y.add(result.y_pos_on_principal_aperture, weight);
+        lixel.timed_delay.add(result.time_of_flight, weight);
+    }
+}
+
 void LixelStatisticsFiller::fill_in_block(
     const std::vector<CalibrationPhotonResult> &calib_block
 ) {
-    for (CalibrationPhotonResult result : calib_block) {
-        if (result.reached_sensor == true) {
-            lixel_stats[result.lixel_id].count++;
-            lixel_stats[result.lixel_id].cx.add(
-                result.x_tilt_vs_optical_axis);
-            lixel_stats[result.lixel_id].cy.add(
-                result.y_tilt_vs_optical_axis);
-            lixel_stats[result.lixel_id].x.add(
-                result.x_pos_on_principal_aperture);
-            lixel_stats[result.lixel_id].y.add(
-                result.y_pos_on_principal_aperture);
-            lixel_stats[result.lixel_id].timed_delay.add(
-                result.time_of_flight);
-        }
+    for (const CalibrationPhotonResult &result : calib_block)
+        fill(result);
+}
+
+void LixelStatisticsFiller::merge(
+    const LixelStatisticsFiller &other,
+    const uint64_t lixel_begin,
+    const uint64_t lixel_end
+) {
+    for (uint64_t i = lixel_begin; i < lixel_end; i++)
+        lixel_stats[i].merge(other.lixel_stats[i]);
+}
+
+void LixelStatisticsFiller::merge(
+    const std::vector<OnlineLixelStatistics> &other_lixel_stats
+) {
+    if (other_lixel_stats.size() != lixel_stats.size()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "LixelStatisticsFiller: Expected " << lixel_stats.size();
+        info << " lixel statistics to merge, but actual ";
+        info << other_lixel_stats.size() << ".\n";
+        throw std::invalid_argument(info.str());
     }
+    for (uint64_t i = 0; i < lixel_stats.size(); i++)
+        lixel_stats[i].merge(other_lixel_stats[i]);
+}
+
+const std::vector<OnlineLixelStatistics>& LixelStatisticsFiller::
+    online_lixel_statistics()const {
+    return lixel_stats;
+}
+
+uint64_t LixelStatisticsFiller::num_lixel()const {
+    return lixel_stats.size();
+}
+
+void LixelStatisticsFiller::clear() {
+    lixel_stats.assign(lixel_stats.size(), OnlineLixelStatistics());
 }
 
 std::vector<LixelStatistic> LixelStatisticsFiller::get_lixel_statistics()const {
@@ -43,9 +91,9 @@ std::vector<LixelStatistic> LixelStatisticsFiller::get_lixel_statistics()const {
 
     for (const OnlineLixelStatistics &lixel : lixel_stats) {
         LixelStatistic stat;
-        stat.efficiency     = lixel.count/photons_emitted_per_lixel;
+        stat.efficiency     = lixel.sum_weights/photons_emitted_per_lixel;
         stat.efficiency_std = sqrt(
-            static_cast<float>(lixel.count))/photons_emitted_per_lixel;
+            lixel.sum_squared_weights)/photons_emitted_per_lixel;
         stat.cx_mean    = lixel.cx.mean();
         stat.cx_std     = lixel.cx.stddev();
         stat.cy_mean    = lixel.cy.mean();
@@ -15,13 +15,28 @@ namespace calibration {
 class LixelStatisticsFiller {
     std::vector<OnlineLixelStatistics> lixel_stats;
  public:
+    const uint64_t num_photons_emitted;
     const double photons_emitted_per_lixel;
     LixelStatisticsFiller(
         const uint64_t num_lixel,
         const uint64_t num_blocks,
         const uint64_t num_photons_per_block);
     std::vector<LixelStatistic> get_lixel_statistics()const;
+    void fill(const CalibrationPhotonResult &result);
+    void fill(const CalibrationPhotonResult &result, const double weight);
     void fill_in_block(const std::vector<CalibrationPhotonResult> &calib_block);
+    // Merges the statistics of the lixels in [lixel_begin, lixel_end) of
+    // other into this. Disjoint ranges can be merged in parallel.
+    void merge(
+        const LixelStatisticsFiller &other,
+        const uint64_t lixel_begin,
+        const uint64_t lixel_end);
+    // Merges the statistics of all lixels in other_lixel_stats into this,
+    // e.g. read from a partial statistics file of a map job.
+    void merge(const std::vector<OnlineLixelStatistics> &other_lixel_stats);
+    const std::vector<OnlineLixelStatistics>& online_lixel_statistics()const;
+    uint64_t num_lixel()const;
+    void clear();
 };
 
 }  // namespace calibration
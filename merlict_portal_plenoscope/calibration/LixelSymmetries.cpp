@@ -0,0 +1,197 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_portal_plenoscope/calibration/LixelSymmetries.h"
+#include <math.h>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+namespace ml = merlict;
+
+
+namespace plenoscope {
+namespace calibration {
+
+HexSymmetry::HexSymmetry(const uint32_t _rotation, const bool _mirrored):
+    rotation(_rotation%6u),
+    mirrored(_mirrored)
+{}
+
+void HexSymmetry::apply(double *x, double *y)const {
+    if (mirrored)
+        *y = -*y;
+    const double phi = rotation*M_PI/3.0;
+    const double c = cos(phi);
+    const double s = sin(phi);
+    const double xr = c*(*x) - s*(*y);
+    const double yr = s*(*x) + c*(*y);
+    *x = xr;
+    *y = yr;
+}
+
+namespace {
+
+// Finds points in the x-y-plane within a tolerance using cells of the
+// size of the points' spacing.
+class PointLookup {
+    const std::vector<ml::Vec3>* points;
+    double cell_size;
+    double tolerance;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+
+    int64_t cell(const double v)const {
+        return static_cast<int64_t>(floor(v/cell_size));
+    }
+
+    uint64_t key(const int64_t ix, const int64_t iy)const {
+        return (static_cast<uint64_t>(ix) << 32) ^
+            (static_cast<uint64_t>(iy) & 0xFFFFFFFFull);
+    }
+
+ public:
+    PointLookup(const std::vector<ml::Vec3>* _points, const double spacing):
+        points(_points),
+        cell_size(spacing),
+        tolerance(1e-3*spacing) {
+        for (uint32_t i = 0; i < points->size(); i++)
+            cells[key(cell(points->at(i).x), cell(points->at(i).y))].
+                push_back(i);
+    }
+
+    // Returns false if there is no point at x, y.
+    bool find(const double x, const double y, uint32_t *index)const {
+        const int64_t ix = cell(x);
+        const int64_t iy = cell(y);
+        for (int64_t dx = -1; dx <= 1; dx++) {
+            for (int64_t dy = -1; dy <= 1; dy++) {
+                auto c = cells.find(key(ix + dx, iy + dy));
+                if (c == cells.end())
+                    continue;
+                for (const uint32_t i : c->second) {
+                    if (
+                        fabs(points->at(i).x - x) < tolerance &&
+                        fabs(points->at(i).y - y) < tolerance
+                    ) {
+                        *index = i;
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+bool find_images(
+    const std::vector<ml::Vec3> &points,
+    const PointLookup &lookup,
+    const HexSymmetry &symmetry,
+    std::vector<uint32_t> *images
+) {
+    images->resize(points.size());
+    for (uint32_t i = 0; i < points.size(); i++) {
+        double x = points[i].x;
+        double y = points[i].y;
+        symmetry.apply(&x, &y);
+        if (!lookup.find(x, y, &images->at(i)))
+            return false;
+    }
+    return true;
+}
+
+void assert_sensor_is_on_optical_axis(
+    const light_field_sensor::Geometry &geometry
+) {
+    const ml::HomTra3 &t = geometry.config.sensor_plane2imaging_system;
+    const double length_tolerance =
+        1e-6*geometry.expected_imaging_system_focal_length();
+    if (
+        fabs(t.rot_x().x - 1.0) > 1e-6 ||
+        fabs(t.rot_y().y - 1.0) > 1e-6 ||
+        fabs(t.translation().x) > length_tolerance ||
+        fabs(t.translation().y) > length_tolerance
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "LixelSymmetries: Expected the light field sensor to be ";
+        info << "centered on, and aligned with, the optical axis of the ";
+        info << "imaging system, but it is not.\n";
+        throw std::invalid_argument(info.str());
+    }
+}
+
+}  // namespace
+
+LixelSymmetries::LixelSymmetries(
+    const light_field_sensor::Geometry &geometry
+): num_lixel(geometry.num_lixel()) {
+    assert_sensor_is_on_optical_axis(geometry);
+    const uint64_t num_paxel = geometry.paxel_per_pixel_template_grid.size();
+    const PointLookup pixel_lookup(
+        &geometry.pixel_grid,
+        geometry.pixel_spacing());
+    const PointLookup paxel_lookup(
+        &geometry.paxel_per_pixel_template_grid,
+        geometry.lixel_spacing());
+
+    std::vector<uint32_t> pixel_images;
+    std::vector<uint32_t> paxel_images;
+    for (uint32_t s = 0; s < NUM_HEX_SYMMETRIES; s++) {
+        const HexSymmetry symmetry(s%6u, s >= 6u);
+        if (!find_images(
+                geometry.pixel_grid,
+                pixel_lookup,
+                symmetry,
+                &pixel_images))
+            continue;
+        if (!find_images(
+                geometry.paxel_per_pixel_template_grid,
+                paxel_lookup,
+                symmetry,
+                &paxel_images))
+            continue;
+
+        symmetries.push_back(symmetry);
+        for (uint64_t pixel = 0; pixel < pixel_images.size(); pixel++)
+            for (uint64_t paxel = 0; paxel < num_paxel; paxel++)
+                lixel_images.push_back(
+                    pixel_images[pixel]*num_paxel + paxel_images[paxel]);
+    }
+}
+
+uint64_t LixelSymmetries::size()const {
+    return symmetries.size();
+}
+
+const HexSymmetry& LixelSymmetries::at(const uint64_t symmetry)const {
+    return symmetries.at(symmetry);
+}
+
+uint32_t LixelSymmetries::image(
+    const uint64_t symmetry,
+    const uint32_t lixel
+)const {
+    return lixel_images[symmetry*num_lixel + lixel];
+}
+
+CalibrationPhotonResult LixelSymmetries::image(
+    const uint64_t symmetry,
+    const CalibrationPhotonResult &result
+)const {
+    CalibrationPhotonResult img = result;
+    img.lixel_id = image(symmetry, result.lixel_id);
+
+    double x = result.x_pos_on_principal_aperture;
+    double y = result.y_pos_on_principal_aperture;
+    symmetries[symmetry].apply(&x, &y);
+    img.x_pos_on_principal_aperture = x;
+    img.y_pos_on_principal_aperture = y;
+
+    double cx = result.x_tilt_vs_optical_axis;
+    double cy = result.y_tilt_vs_optical_axis;
+    symmetries[symmetry].apply(&cx, &cy);
+    img.x_tilt_vs_optical_axis = cx;
+    img.y_tilt_vs_optical_axis = cy;
+    return img;
+}
+
+}  // namespace calibration
+}  // namespace plenoscope
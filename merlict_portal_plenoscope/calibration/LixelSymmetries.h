@@ -0,0 +1,49 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef PLENOSCOPE_CALIBRATION_LIXELSYMMETRIES_H_
+#define PLENOSCOPE_CALIBRATION_LIXELSYMMETRIES_H_
+
+#include <stdint.h>
+#include <vector>
+#include "merlict_portal_plenoscope/calibration/CalibrationPhotonResult.h"
+#include "merlict_portal_plenoscope/light_field_sensor/Geometry.h"
+
+namespace plenoscope {
+namespace calibration {
+
+// An element of the dihedral group D6 acting on the x-y-plane.
+// If mirrored, y is mirrored to -y first. Then x, y are rotated by
+// rotation*60deg around z.
+struct HexSymmetry {
+    uint32_t rotation;
+    bool mirrored;
+    HexSymmetry(const uint32_t _rotation, const bool _mirrored);
+    void apply(double *x, double *y)const;
+};
+
+const uint32_t NUM_HEX_SYMMETRIES = 12u;
+
+// The symmetries of D6 which map both the pixel grid and the paxel
+// template grid of a light field sensor onto themselves, and thus every
+// lixel onto a lixel. The identity is always among them.
+// When also the imaging system is symmetric, the statistics of a lixel
+// are the statistics of its images with cx, cy, x, y transformed.
+class LixelSymmetries {
+    uint64_t num_lixel;
+    std::vector<HexSymmetry> symmetries;
+    // lixel_images[s*num_lixel + lixel]
+    std::vector<uint32_t> lixel_images;
+
+ public:
+    explicit LixelSymmetries(const light_field_sensor::Geometry &geometry);
+    uint64_t size()const;
+    const HexSymmetry& at(const uint64_t symmetry)const;
+    uint32_t image(const uint64_t symmetry, const uint32_t lixel)const;
+    CalibrationPhotonResult image(
+        const uint64_t symmetry,
+        const CalibrationPhotonResult &result)const;
+};
+
+}  // namespace calibration
+}  // namespace plenoscope
+
+#endif  // PLENOSCOPE_CALIBRATION_LIXELSYMMETRIES_H_
@@ -1,10 +1,33 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict_portal_plenoscope/calibration/OnlineLixelStatistics.h"
+#include <math.h>
+#include <limits>
 
 namespace plenoscope {
 namespace calibration {
 
-OnlineLixelStatistics::OnlineLixelStatistics(): count(0) {}
+OnlineLixelStatistics::OnlineLixelStatistics():
+    count(0),
+    sum_weights(0.0),
+    sum_squared_weights(0.0)
+{}
+
+void OnlineLixelStatistics::merge(const OnlineLixelStatistics &other) {
+    count += other.count;
+    sum_weights += other.sum_weights;
+    sum_squared_weights += other.sum_squared_weights;
+    cx.merge(other.cx);
+    cy.merge(other.cy);
+    x.merge(other.x);
+    y.merge(other.y);
+    timed_delay.merge(other.timed_delay);
+}
+
+double OnlineLixelStatistics::relative_uncertainty()const {
+    if (sum_weights <= 0.0)
+        return std::numeric_limits<double>::infinity();
+    return sqrt(sum_squared_weights)/sum_weights;
+}
 
 }  // namespace calibration
 }  // namespace plenoscope
@@ -9,12 +9,20 @@ namespace calibration {
 
 struct OnlineLixelStatistics {
     unsigned int count;
+    // Photons from a stratified calibration carry weights, see Strata.h.
+    // For unit weights, both sums equal count.
+    double sum_weights;
+    double sum_squared_weights;
     OnlineStatistics cx;
     OnlineStatistics cy;
     OnlineStatistics x;
     OnlineStatistics y;
     OnlineStatistics timed_delay;
     OnlineLixelStatistics();
+    void merge(const OnlineLixelStatistics &other);
+    // The relative uncertainty of the efficiency, 1/sqrt(effective count).
+    // It is also the standard error of the means in units of their stddev.
+    double relative_uncertainty()const;
 };
 
 }  // namespace calibration
@@ -7,27 +7,58 @@ namespace plenoscope {
 
 OnlineStatistics::OnlineStatistics():
     n_samples(0.0),
+    w_sum(0.0),
     _sum(0.0),
     smean(0.0),
     m2(0.0)
 {}
 
+OnlineStatistics::OnlineStatistics(
+    const double num_samples,
+    const double sum_of_weights,
+    const double mean,
+    const double sum_of_squared_differences
+):
+    n_samples(num_samples),
+    w_sum(sum_of_weights),
+    _sum(sum_of_weights*mean),
+    smean(mean),
+    m2(sum_of_squared_differences)
+{}
+
 void OnlineStatistics::add(const double x) {
+    add(x, 1.0);
+}
+
+void OnlineStatistics::add(const double x, const double weight) {
     // Online variance
     n_samples += 1.0;
+    w_sum += weight;
     const double delta = x - smean;
-    smean += delta/n_samples;
-    m2 += delta*(x - smean);
+    smean += delta*weight/w_sum;
+    m2 += weight*delta*(x - smean);
 
     // Online Mean
-    _sum += x;
+    _sum += weight*x;
+}
+
+void OnlineStatistics::merge(const OnlineStatistics &other) {
+    if (other.n_samples == 0.0)
+        return;
+    const double w = w_sum + other.w_sum;
+    const double delta = other.smean - smean;
+    smean += delta*other.w_sum/w;
+    m2 += other.m2 + delta*delta*w_sum*other.w_sum/w;
+    w_sum = w;
+    n_samples += other.n_samples;
+    _sum += other._sum;
 }
 
 double OnlineStatistics::variance()const {
     if (n_samples < 2.0)
         return std::numeric_limits<double>::quiet_NaN();
     else
-        return m2/n_samples;
+        return m2/w_sum;
 
     // In wikipedia it is: m2/(num_samples - 1.0).
     // We remove the substraction of 1.0, since it does not fit to the classic
@@ -39,7 +70,7 @@ double OnlineStatistics::stddev()const {
 }
 
 double OnlineStatistics::mean()const {
-    return _sum/n_samples;
+    return _sum/w_sum;
 }
 
 double OnlineStatistics::sum()const {
@@ -50,4 +81,12 @@ double OnlineStatistics::num_samples()const {
     return n_samples;
 }
 
+double OnlineStatistics::sum_of_weights()const {
+    return w_sum;
+}
+
+double OnlineStatistics::sum_of_squared_differences()const {
+    return m2;
+}
+
 }  // namespace plenoscope
@@ -6,20 +6,35 @@ namespace plenoscope {
 
 class OnlineStatistics {
     // https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
-    // Online algorithm
+    // Online algorithm, weighted incremental algorithm for add(x, weight)
     double n_samples;
+    double w_sum;
     double _sum;
     double smean;
     double m2;
 
  public:
     OnlineStatistics();
+    // Restores the state of a previous OnlineStatistics from its moments.
+    OnlineStatistics(
+        const double num_samples,
+        const double sum_of_weights,
+        const double mean,
+        const double sum_of_squared_differences);
     void add(const double x);
+    // The sample x is counted once, but contributes with weight to the
+    // mean and the variance.
+    void add(const double x, const double weight);
+    // Combines the samples of other into this, see Chan et al.
+    // 'Parallel algorithm' on the same wikipedia page.
+    void merge(const OnlineStatistics &other);
     double variance()const;
     double stddev()const;
     double mean()const;
     double sum()const;
     double num_samples()const;
+    double sum_of_weights()const;
+    double sum_of_squared_differences()const;
 };
 
 }  // namespace plenoscope
@@ -0,0 +1,164 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_portal_plenoscope/calibration/PartialLixelStatistics.h"
+#include <string.h>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace plenoscope {
+namespace calibration {
+
+namespace {
+
+const uint64_t HEADER_SIZE = 2*sizeof(uint32_t) + 3*sizeof(uint64_t);
+const uint64_t NUM_QUANTITIES = 5u;
+const uint64_t RECORD_SIZE =
+    2*sizeof(uint32_t) + 2*sizeof(double) +
+    2*NUM_QUANTITIES*sizeof(double);
+
+template<typename T>
+void append(std::vector<char> *buffer, const T value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+T take(const std::vector<char> &buffer, uint64_t *pos) {
+    T value;
+    memcpy(&value, &buffer[*pos], sizeof(T));
+    *pos += sizeof(T);
+    return value;
+}
+
+void append(std::vector<char> *buffer, const OnlineStatistics &stat) {
+    append<double>(buffer, stat.num_samples() > 0.0 ? stat.mean() : 0.0);
+    append<double>(buffer, stat.sum_of_squared_differences());
+}
+
+OnlineStatistics take_online_statistics(
+    const std::vector<char> &buffer,
+    uint64_t *pos,
+    const OnlineLixelStatistics &lixel
+) {
+    const double mean = take<double>(buffer, pos);
+    const double m2 = take<double>(buffer, pos);
+    return OnlineStatistics(lixel.count, lixel.sum_weights, mean, m2);
+}
+
+void throw_corrupt(const std::string &path, const std::string &reason) {
+    std::stringstream info;
+    info << __FILE__ << " " << __LINE__ << "\n";
+    info << "PartialLixelStatistics: File '" << path << "' is corrupt. ";
+    info << reason << "\n";
+    throw std::runtime_error(info.str());
+}
+
+}  // namespace
+
+PartialLixelStatistics::PartialLixelStatistics(): num_photons_emitted(0u) {}
+
+void write_partial(
+    const std::vector<OnlineLixelStatistics> &lixel_stats,
+    const uint64_t num_photons_emitted,
+    const std::string &path
+) {
+    uint64_t num_records = 0u;
+    for (const OnlineLixelStatistics &lixel : lixel_stats)
+        if (lixel.count > 0u)
+            num_records++;
+
+    std::vector<char> buffer;
+    buffer.reserve(HEADER_SIZE + num_records*RECORD_SIZE);
+    append<uint32_t>(&buffer, PARTIAL_LIXEL_STATISTICS_MAGIC);
+    append<uint32_t>(&buffer, PARTIAL_LIXEL_STATISTICS_VERSION);
+    append<uint64_t>(&buffer, lixel_stats.size());
+    append<uint64_t>(&buffer, num_photons_emitted);
+    append<uint64_t>(&buffer, num_records);
+
+    for (uint64_t i = 0; i < lixel_stats.size(); i++) {
+        const OnlineLixelStatistics &lixel = lixel_stats[i];
+        if (lixel.count == 0u)
+            continue;
+        append<uint32_t>(&buffer, static_cast<uint32_t>(i));
+        append<uint32_t>(&buffer, lixel.count);
+        append<double>(&buffer, lixel.sum_weights);
+        append<double>(&buffer, lixel.sum_squared_weights);
+        append(&buffer, lixel.cx);
+        append(&buffer, lixel.cy);
+        append(&buffer, lixel.x);
+        append(&buffer, lixel.y);
+        append(&buffer, lixel.timed_delay);
+    }
+
+    std::ofstream file;
+    file.open(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "PartialLixelStatistics: Unable to write file: '";
+        info << path << "'\n";
+        throw std::runtime_error(info.str());
+    }
+    file.write(buffer.data(), buffer.size());
+    file.close();
+}
+
+PartialLixelStatistics read_partial(const std::string &path) {
+    std::ifstream file;
+    file.open(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "PartialLixelStatistics: Unable to read file: '";
+        info << path << "'\n";
+        throw std::runtime_error(info.str());
+    }
+    const uint64_t file_size = file.tellg();
+    file.seekg(0);
+    std::vector<char> buffer(file_size);
+    file.read(buffer.data(), file_size);
+    file.close();
+
+    if (file_size < HEADER_SIZE)
+        throw_corrupt(path, "It is too small to hold the header.");
+
+    uint64_t pos = 0u;
+    if (take<uint32_t>(buffer, &pos) != PARTIAL_LIXEL_STATISTICS_MAGIC)
+        throw_corrupt(path, "The magic is wrong.");
+    const uint32_t version = take<uint32_t>(buffer, &pos);
+    if (version != PARTIAL_LIXEL_STATISTICS_VERSION) {
+        std::stringstream reason;
+        reason << "Expected version " << PARTIAL_LIXEL_STATISTICS_VERSION;
+        reason << ", but actual " << version << ".";
+        throw_corrupt(path, reason.str());
+    }
+    const uint64_t num_lixel = take<uint64_t>(buffer, &pos);
+    PartialLixelStatistics partial;
+    partial.num_photons_emitted = take<uint64_t>(buffer, &pos);
+    const uint64_t num_records = take<uint64_t>(buffer, &pos);
+
+    if (file_size != HEADER_SIZE + num_records*RECORD_SIZE)
+        throw_corrupt(path, "The size does not match the num. records.");
+
+    partial.lixel_stats.resize(num_lixel);
+    for (uint64_t r = 0; r < num_records; r++) {
+        const uint32_t lixel_id = take<uint32_t>(buffer, &pos);
+        if (lixel_id >= num_lixel)
+            throw_corrupt(path, "A lixel_id exceeds num_lixel.");
+        OnlineLixelStatistics &lixel = partial.lixel_stats[lixel_id];
+        lixel.count = take<uint32_t>(buffer, &pos);
+        lixel.sum_weights = take<double>(buffer, &pos);
+        lixel.sum_squared_weights = take<double>(buffer, &pos);
+        lixel.cx = take_online_statistics(buffer, &pos, lixel);
+        lixel.cy = take_online_statistics(buffer, &pos, lixel);
+        lixel.x = take_online_statistics(buffer, &pos, lixel);
+        lixel.y = take_online_statistics(buffer, &pos, lixel);
+        lixel.timed_delay = take_online_statistics(buffer, &pos, lixel);
+    }
+    return partial;
+}
+
+}  // namespace calibration
+}  // namespace plenoscope
@@ -0,0 +1,50 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef PLENOSCOPE_CALIBRATION_PARTIALLIXELSTATISTICS_H_
+#define PLENOSCOPE_CALIBRATION_PARTIALLIXELSTATISTICS_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "merlict_portal_plenoscope/calibration/OnlineLixelStatistics.h"
+
+namespace plenoscope {
+namespace calibration {
+
+// The partial statistics of one map-job of a map-and-reduce calibration.
+// Instead of every single photon, only the moments (count, mean, and the
+// sum of squared differences to the mean) of each lixel are kept, which
+// can be merged with the statistics of other jobs.
+//
+// File layout, little endian:
+//  header:
+//      uint32 PARTIAL_LIXEL_STATISTICS_MAGIC
+//      uint32 PARTIAL_LIXEL_STATISTICS_VERSION
+//      uint64 num_lixel
+//      uint64 num_photons_emitted
+//      uint64 num_records
+//  num_records records, only for lixel with count > 0:
+//      uint32 lixel_id
+//      uint32 count
+//      float64 sum_weights, float64 sum_squared_weights
+//      float64 mean, float64 sum_of_squared_differences
+//          for cx, cy, x, y, and time_delay.
+struct PartialLixelStatistics {
+    uint64_t num_photons_emitted;
+    std::vector<OnlineLixelStatistics> lixel_stats;
+    PartialLixelStatistics();
+};
+
+const uint32_t PARTIAL_LIXEL_STATISTICS_MAGIC = 0x53584c50;  // 'PLXS'
+const uint32_t PARTIAL_LIXEL_STATISTICS_VERSION = 2u;
+
+void write_partial(
+    const std::vector<OnlineLixelStatistics> &lixel_stats,
+    const uint64_t num_photons_emitted,
+    const std::string &path);
+
+PartialLixelStatistics read_partial(const std::string &path);
+
+}  // namespace calibration
+}  // namespace plenoscope
+
+#endif  // PLENOSCOPE_CALIBRATION_PARTIALLIXELSTATISTICS_H_
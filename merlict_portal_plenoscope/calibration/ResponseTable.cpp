@@ -0,0 +1,368 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_portal_plenoscope/calibration/ResponseTable.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace plenoscope {
+namespace calibration {
+
+namespace {
+
+const uint64_t HEADER_SIZE =
+    4*sizeof(uint32_t) + 2*sizeof(double) + 4*sizeof(uint64_t);
+const uint64_t ENTRY_SIZE = sizeof(uint32_t) + 2*sizeof(float);
+
+template<typename T>
+void append(std::vector<char> *buffer, const T value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+T take(const std::vector<char> &buffer, uint64_t *pos) {
+    T value;
+    memcpy(&value, &buffer[*pos], sizeof(T));
+    *pos += sizeof(T);
+    return value;
+}
+
+void throw_corrupt(const std::string &path, const std::string &reason) {
+    std::stringstream info;
+    info << __FILE__ << " " << __LINE__ << "\n";
+    info << "ResponseTable: File '" << path << "' is corrupt. ";
+    info << reason << "\n";
+    throw std::runtime_error(info.str());
+}
+
+// Returns num_bins when value is outside of [-limit, limit).
+uint64_t axis_bin(
+    const double value,
+    const double limit,
+    const uint32_t num_bins
+) {
+    const double b = floor((value + limit)/(2.0*limit)*num_bins);
+    if (b < 0.0 || b >= num_bins)
+        return num_bins;
+    return static_cast<uint64_t>(b);
+}
+
+// Squared distance of the origin to the nearest point of the square with
+// lower edges x, y.
+double squared_distance_to_square(
+    const double x,
+    const double y,
+    const double width
+) {
+    const double nx = std::min(std::max(0.0, x), x + width);
+    const double ny = std::min(std::max(0.0, y), y + width);
+    return nx*nx + ny*ny;
+}
+
+}  // namespace
+
+ResponseTableBinning::ResponseTableBinning():
+    num_bins_xy(0u),
+    num_bins_c(0u),
+    aperture_radius(0.0),
+    max_incident_angle(0.0) {}
+
+ResponseTableBinning::ResponseTableBinning(
+    const uint32_t _num_bins_xy,
+    const uint32_t _num_bins_c,
+    const double _aperture_radius,
+    const double _max_incident_angle
+):
+    num_bins_xy(_num_bins_xy),
+    num_bins_c(_num_bins_c),
+    aperture_radius(_aperture_radius),
+    max_incident_angle(_max_incident_angle) {
+    if (
+        num_bins_xy == 0u ||
+        num_bins_c == 0u ||
+        aperture_radius <= 0.0 ||
+        max_incident_angle <= 0.0 ||
+        max_incident_angle >= M_PI/2.0
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "ResponseTableBinning: Expected num_bins_xy > 0, ";
+        info << "num_bins_c > 0, aperture_radius > 0, and ";
+        info << "0 < max_incident_angle < pi/2, but actual: ";
+        info << num_bins_xy << ", " << num_bins_c << ", ";
+        info << aperture_radius << "m, " << max_incident_angle << "rad.\n";
+        throw std::invalid_argument(info.str());
+    }
+}
+
+uint64_t ResponseTableBinning::size()const {
+    return static_cast<uint64_t>(num_bins_xy)*num_bins_xy*
+        num_bins_c*num_bins_c;
+}
+
+double ResponseTableBinning::max_c()const {
+    return sin(max_incident_angle);
+}
+
+double ResponseTableBinning::xy_bin_width()const {
+    return 2.0*aperture_radius/num_bins_xy;
+}
+
+double ResponseTableBinning::c_bin_width()const {
+    return 2.0*max_c()/num_bins_c;
+}
+
+uint64_t ResponseTableBinning::bin(
+    const double x,
+    const double y,
+    const double cx,
+    const double cy
+)const {
+    const uint64_t ix = axis_bin(x, aperture_radius, num_bins_xy);
+    const uint64_t iy = axis_bin(y, aperture_radius, num_bins_xy);
+    const uint64_t icx = axis_bin(cx, max_c(), num_bins_c);
+    const uint64_t icy = axis_bin(cy, max_c(), num_bins_c);
+    if (
+        ix == num_bins_xy || iy == num_bins_xy ||
+        icx == num_bins_c || icy == num_bins_c
+    )
+        return size();
+    return ((ix*num_bins_xy + iy)*num_bins_c + icx)*num_bins_c + icy;
+}
+
+void ResponseTableBinning::lower_edges(
+    const uint64_t bin,
+    double *x,
+    double *y,
+    double *cx,
+    double *cy
+)const {
+    const uint64_t icy = bin%num_bins_c;
+    const uint64_t icx = (bin/num_bins_c)%num_bins_c;
+    const uint64_t iy = (bin/num_bins_c/num_bins_c)%num_bins_xy;
+    const uint64_t ix = bin/num_bins_c/num_bins_c/num_bins_xy;
+    (*x) = -aperture_radius + ix*xy_bin_width();
+    (*y) = -aperture_radius + iy*xy_bin_width();
+    (*cx) = -max_c() + icx*c_bin_width();
+    (*cy) = -max_c() + icy*c_bin_width();
+}
+
+bool ResponseTableBinning::overlaps_aperture_and_field_of_view(
+    const uint64_t bin
+)const {
+    double x, y, cx, cy;
+    lower_edges(bin, &x, &y, &cx, &cy);
+    return
+        squared_distance_to_square(x, y, xy_bin_width()) <
+            aperture_radius*aperture_radius &&
+        squared_distance_to_square(cx, cy, c_bin_width()) <
+            max_c()*max_c();
+}
+
+ResponseTable::ResponseTable():
+    geometry_hash(0u),
+    num_lixel(0u),
+    num_photons_per_bin(0u),
+    bin_begin(1u, 0u) {}
+
+ResponseTable::ResponseTable(
+    const ResponseTableBinning &_binning,
+    const uint64_t _geometry_hash,
+    const uint64_t _num_lixel,
+    const uint64_t _num_photons_per_bin
+):
+    binning(_binning),
+    geometry_hash(_geometry_hash),
+    num_lixel(_num_lixel),
+    num_photons_per_bin(_num_photons_per_bin),
+    bin_begin(1u, 0u) {
+    bin_begin.reserve(binning.size() + 1u);
+}
+
+void ResponseTable::append_bin(const std::vector<ResponseEntry> &bin_entries) {
+    if (num_bins_appended() == binning.size()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "ResponseTable: All " << binning.size();
+        info << " bins are appended already.\n";
+        throw std::out_of_range(info.str());
+    }
+    entries.insert(entries.end(), bin_entries.begin(), bin_entries.end());
+    bin_begin.push_back(entries.size());
+}
+
+uint64_t ResponseTable::num_bins_appended()const {
+    return bin_begin.size() - 1u;
+}
+
+double ResponseTable::efficiency(const uint64_t bin)const {
+    double sum = 0.0;
+    for (uint64_t e = bin_begin[bin]; e < bin_begin[bin + 1]; e++)
+        sum += entries[e].probability;
+    return sum;
+}
+
+bool ResponseTable::draw(
+    const uint64_t bin,
+    const double uniform,
+    uint32_t *lixel,
+    double *time_delay
+)const {
+    double cumulative = 0.0;
+    for (uint64_t e = bin_begin[bin]; e < bin_begin[bin + 1]; e++) {
+        cumulative += entries[e].probability;
+        if (uniform < cumulative) {
+            (*lixel) = entries[e].lixel;
+            (*time_delay) = entries[e].time_delay;
+            return true;
+        }
+    }
+    return false;
+}
+
+void write_response_table(
+    const ResponseTable &table,
+    const std::string &path
+) {
+    if (table.num_bins_appended() != table.binning.size()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "ResponseTable: Expected all " << table.binning.size();
+        info << " bins to be appended, but actual ";
+        info << table.num_bins_appended() << ".\n";
+        throw std::logic_error(info.str());
+    }
+
+    std::vector<char> buffer;
+    buffer.reserve(
+        HEADER_SIZE +
+        table.bin_begin.size()*sizeof(uint64_t) +
+        table.entries.size()*ENTRY_SIZE);
+    append<uint32_t>(&buffer, RESPONSE_TABLE_MAGIC);
+    append<uint32_t>(&buffer, RESPONSE_TABLE_VERSION);
+    append<uint32_t>(&buffer, table.binning.num_bins_xy);
+    append<uint32_t>(&buffer, table.binning.num_bins_c);
+    append<double>(&buffer, table.binning.aperture_radius);
+    append<double>(&buffer, table.binning.max_incident_angle);
+    append<uint64_t>(&buffer, table.geometry_hash);
+    append<uint64_t>(&buffer, table.num_lixel);
+    append<uint64_t>(&buffer, table.num_photons_per_bin);
+    append<uint64_t>(&buffer, table.entries.size());
+    for (const uint64_t begin : table.bin_begin)
+        append<uint64_t>(&buffer, begin);
+    for (const ResponseEntry &entry : table.entries) {
+        append<uint32_t>(&buffer, entry.lixel);
+        append<float>(&buffer, entry.probability);
+        append<float>(&buffer, entry.time_delay);
+    }
+
+    std::ofstream file;
+    file.open(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "ResponseTable: Unable to write file: '";
+        info << path << "'\n";
+        throw std::runtime_error(info.str());
+    }
+    file.write(buffer.data(), buffer.size());
+    file.close();
+}
+
+ResponseTable read_response_table(
+    const std::string &path,
+    const uint64_t expected_geometry_hash
+) {
+    std::ifstream file;
+    file.open(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "ResponseTable: Unable to read file: '";
+        info << path << "'\n";
+        throw std::runtime_error(info.str());
+    }
+    const uint64_t file_size = file.tellg();
+    file.seekg(0);
+    std::vector<char> buffer(file_size);
+    file.read(buffer.data(), file_size);
+    file.close();
+
+    if (file_size < HEADER_SIZE)
+        throw_corrupt(path, "It is too small to hold the header.");
+
+    uint64_t pos = 0u;
+    if (take<uint32_t>(buffer, &pos) != RESPONSE_TABLE_MAGIC)
+        throw_corrupt(path, "The magic is wrong.");
+    const uint32_t version = take<uint32_t>(buffer, &pos);
+    if (version != RESPONSE_TABLE_VERSION) {
+        std::stringstream reason;
+        reason << "Expected version " << RESPONSE_TABLE_VERSION;
+        reason << ", but actual " << version << ".";
+        throw_corrupt(path, reason.str());
+    }
+    const uint32_t num_bins_xy = take<uint32_t>(buffer, &pos);
+    const uint32_t num_bins_c = take<uint32_t>(buffer, &pos);
+    const double aperture_radius = take<double>(buffer, &pos);
+    const double max_incident_angle = take<double>(buffer, &pos);
+    const uint64_t geometry_hash = take<uint64_t>(buffer, &pos);
+    const uint64_t num_lixel = take<uint64_t>(buffer, &pos);
+    const uint64_t num_photons_per_bin = take<uint64_t>(buffer, &pos);
+    const uint64_t num_entries = take<uint64_t>(buffer, &pos);
+
+    if (geometry_hash != expected_geometry_hash) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "ResponseTable: The table in '" << path << "' ";
+        info << "belongs to a different light field sensor geometry. ";
+        info << "Expected geometry_hash " << expected_geometry_hash;
+        info << ", but actual " << geometry_hash << ".\n";
+        throw std::invalid_argument(info.str());
+    }
+
+    ResponseTable table(
+        ResponseTableBinning(
+            num_bins_xy,
+            num_bins_c,
+            aperture_radius,
+            max_incident_angle),
+        geometry_hash,
+        num_lixel,
+        num_photons_per_bin);
+    const uint64_t num_bins = table.binning.size();
+    if (
+        file_size !=
+        HEADER_SIZE + (num_bins + 1u)*sizeof(uint64_t) +
+        num_entries*ENTRY_SIZE
+    )
+        throw_corrupt(path, "The size does not match the num. entries.");
+
+    table.bin_begin.resize(num_bins + 1u);
+    for (uint64_t b = 0; b < num_bins + 1u; b++) {
+        table.bin_begin[b] = take<uint64_t>(buffer, &pos);
+        if (
+            table.bin_begin[b] > num_entries ||
+            (b > 0u && table.bin_begin[b] < table.bin_begin[b - 1u])
+        )
+            throw_corrupt(path, "The bin_begin are not monotonic.");
+    }
+    if (table.bin_begin[0] != 0u || table.bin_begin[num_bins] != num_entries)
+        throw_corrupt(path, "The bin_begin do not span the entries.");
+
+    table.entries.resize(num_entries);
+    for (uint64_t e = 0; e < num_entries; e++) {
+        table.entries[e].lixel = take<uint32_t>(buffer, &pos);
+        if (table.entries[e].lixel >= num_lixel)
+            throw_corrupt(path, "A lixel exceeds num_lixel.");
+        table.entries[e].probability = take<float>(buffer, &pos);
+        table.entries[e].time_delay = take<float>(buffer, &pos);
+    }
+    return table;
+}
+
+}  // namespace calibration
+}  // namespace plenoscope
@@ -0,0 +1,121 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef PLENOSCOPE_CALIBRATION_RESPONSETABLE_H_
+#define PLENOSCOPE_CALIBRATION_RESPONSETABLE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace plenoscope {
+namespace calibration {
+
+// A photon entering the plenoscope is described by its support x, y on the
+// principal aperture plane and by the x, y components cx, cy of its incident
+// direction. The binning divides the square [-aperture_radius,
+// aperture_radius]^2 into num_bins_xy^2 and the square [-max_c, max_c]^2
+// into num_bins_c^2 bins, with max_c = sin(max_incident_angle).
+// Only the bins overlapping the aperture disc and the field of view cone
+// are populated.
+struct ResponseTableBinning {
+    uint32_t num_bins_xy;
+    uint32_t num_bins_c;
+    double aperture_radius;
+    double max_incident_angle;
+
+    ResponseTableBinning();
+    ResponseTableBinning(
+        const uint32_t num_bins_xy,
+        const uint32_t num_bins_c,
+        const double aperture_radius,
+        const double max_incident_angle);
+    uint64_t size()const;
+    double max_c()const;
+    double xy_bin_width()const;
+    double c_bin_width()const;
+    // Returns size() when the photon is outside of the binning.
+    uint64_t bin(
+        const double x,
+        const double y,
+        const double cx,
+        const double cy)const;
+    void lower_edges(
+        const uint64_t bin,
+        double *x,
+        double *y,
+        double *cx,
+        double *cy)const;
+    bool overlaps_aperture_and_field_of_view(const uint64_t bin)const;
+};
+
+struct ResponseEntry {
+    uint32_t lixel;
+    float probability;
+    float time_delay;
+};
+
+// The response of the plenoscope to photons within a bin, i.e. the
+// probabilities to be absorbed in the lixels, and the mean time delays
+// relative to the principal aperture plane. The probabilities of a bin
+// sum up to the bin's efficiency, the rest of the photons is lost.
+// The entries of bin b are entries[bin_begin[b]] to
+// entries[bin_begin[b + 1] - 1].
+//
+// File layout, little endian:
+//  header:
+//      uint32 RESPONSE_TABLE_MAGIC
+//      uint32 RESPONSE_TABLE_VERSION
+//      uint32 num_bins_xy
+//      uint32 num_bins_c
+//      float64 aperture_radius
+//      float64 max_incident_angle
+//      uint64 geometry_hash
+//      uint64 num_lixel
+//      uint64 num_photons_per_bin
+//      uint64 num_entries
+//  (num_bins + 1) uint64 bin_begin
+//  num_entries entries:
+//      uint32 lixel
+//      float32 probability
+//      float32 time_delay
+struct ResponseTable {
+    ResponseTableBinning binning;
+    uint64_t geometry_hash;
+    uint64_t num_lixel;
+    uint64_t num_photons_per_bin;
+    std::vector<uint64_t> bin_begin;
+    std::vector<ResponseEntry> entries;
+
+    ResponseTable();
+    ResponseTable(
+        const ResponseTableBinning &binning,
+        const uint64_t geometry_hash,
+        const uint64_t num_lixel,
+        const uint64_t num_photons_per_bin);
+    // Bins have to be appended in order.
+    void append_bin(const std::vector<ResponseEntry> &bin_entries);
+    uint64_t num_bins_appended()const;
+    double efficiency(const uint64_t bin)const;
+    // Picks the lixel which absorbs a photon in bin with the uniform random
+    // number in [0, 1). Returns false when the photon is lost.
+    bool draw(
+        const uint64_t bin,
+        const double uniform,
+        uint32_t *lixel,
+        double *time_delay)const;
+};
+
+const uint32_t RESPONSE_TABLE_MAGIC = 0x5452584c;  // 'LXRT'
+const uint32_t RESPONSE_TABLE_VERSION = 1u;
+
+void write_response_table(
+    const ResponseTable &table,
+    const std::string &path);
+
+ResponseTable read_response_table(
+    const std::string &path,
+    const uint64_t expected_geometry_hash);
+
+}  // namespace calibration
+}  // namespace plenoscope
+
+#endif  // PLENOSCOPE_CALIBRATION_RESPONSETABLE_H_
@@ -0,0 +1,75 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_portal_plenoscope/calibration/Strata.h"
+#include <math.h>
+#include <sstream>
+#include <stdexcept>
+namespace ml = merlict;
+
+
+namespace plenoscope {
+namespace calibration {
+
+Strata::Strata(
+    const double _max_aperture_radius,
+    const double _max_incident_angle,
+    const uint32_t _num_aperture_rings,
+    const uint32_t _num_aperture_sectors,
+    const uint32_t _num_zenith_rings,
+    const uint32_t _num_azimuth_sectors
+):
+    max_aperture_radius(_max_aperture_radius),
+    max_incident_angle(_max_incident_angle),
+    num_aperture_rings(_num_aperture_rings),
+    num_aperture_sectors(_num_aperture_sectors),
+    num_zenith_rings(_num_zenith_rings),
+    num_azimuth_sectors(_num_azimuth_sectors) {
+    if (size() == 0u) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "Calibration-Strata: Expected at least one ring and one ";
+        info << "sector for both the aperture and the directions.\n";
+        throw std::invalid_argument(info.str());
+    }
+}
+
+uint64_t Strata::num_directions()const {
+    return static_cast<uint64_t>(num_zenith_rings)*num_azimuth_sectors;
+}
+
+uint64_t Strata::size()const {
+    return static_cast<uint64_t>(num_aperture_rings)*num_aperture_sectors*
+        num_directions();
+}
+
+ml::Vec3 Strata::draw_support_on_aperture(
+    const uint64_t stratum,
+    ml::random::Generator *prng
+)const {
+    const uint64_t aperture = stratum/num_directions();
+    const uint64_t ring = aperture/num_aperture_sectors;
+    const uint64_t sector = aperture%num_aperture_sectors;
+    const double r_sq = (ring + prng->uniform())/num_aperture_rings;
+    const double r = max_aperture_radius*sqrt(r_sq);
+    const double phi = 2.0*M_PI*(sector + prng->uniform())/
+        num_aperture_sectors;
+    return ml::Vec3(r*cos(phi), r*sin(phi), 0.0);
+}
+
+ml::Vec3 Strata::draw_incident_direction(
+    const uint64_t stratum,
+    ml::random::Generator *prng
+)const {
+    const uint64_t direction = stratum%num_directions();
+    const uint64_t ring = direction/num_azimuth_sectors;
+    const uint64_t sector = direction%num_azimuth_sectors;
+    const double cap_height = 1.0 - cos(max_incident_angle);
+    const double cos_zd = 1.0 - cap_height*(ring + prng->uniform())/
+        num_zenith_rings;
+    const double sin_zd = sqrt(1.0 - cos_zd*cos_zd);
+    const double az = 2.0*M_PI*(sector + prng->uniform())/
+        num_azimuth_sectors;
+    return ml::Vec3(sin_zd*cos(az), sin_zd*sin(az), cos_zd);
+}
+
+}  // namespace calibration
+}  // namespace plenoscope
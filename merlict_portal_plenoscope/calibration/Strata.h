@@ -0,0 +1,45 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef PLENOSCOPE_CALIBRATION_STRATA_H_
+#define PLENOSCOPE_CALIBRATION_STRATA_H_
+
+#include <stdint.h>
+#include "merlict/Vec3.h"
+#include "merlict/random/Generator.h"
+
+namespace plenoscope {
+namespace calibration {
+
+// Divides the space of the calibration photons, i.e. their support on the
+// aperture disc and their incident direction within the field-of-view cap,
+// into strata of equal measure.
+// The aperture is divided into rings of equal area and azimuth sectors, the
+// field-of-view into zenith rings of equal solid angle and azimuth sectors.
+struct Strata {
+    const double max_aperture_radius;
+    const double max_incident_angle;
+    const uint32_t num_aperture_rings;
+    const uint32_t num_aperture_sectors;
+    const uint32_t num_zenith_rings;
+    const uint32_t num_azimuth_sectors;
+
+    Strata(
+        const double _max_aperture_radius,
+        const double _max_incident_angle,
+        const uint32_t _num_aperture_rings,
+        const uint32_t _num_aperture_sectors,
+        const uint32_t _num_zenith_rings,
+        const uint32_t _num_azimuth_sectors);
+    uint64_t size()const;
+    merlict::Vec3 draw_support_on_aperture(
+        const uint64_t stratum,
+        merlict::random::Generator *prng)const;
+    merlict::Vec3 draw_incident_direction(
+        const uint64_t stratum,
+        merlict::random::Generator *prng)const;
+    uint64_t num_directions()const;
+};
+
+}  // namespace calibration
+}  // namespace plenoscope
+
+#endif  // PLENOSCOPE_CALIBRATION_STRATA_H_
@@ -3,6 +3,7 @@
 #include <math.h>
 #include <vector>
 #include "merlict/merlict.h"
+#include "merlict_portal_plenoscope/light_field_sensor/SensorFrame.h"
 namespace ml = merlict;
 
 
@@ -33,6 +34,7 @@ void Factory::add_lens_array(ml::Frame* frame, ml::Scenery* scenery) {
         lens->set_curvature_radius_and_outer_hex_radius(
             geometry->pixel_lens_curvature_radius(),
             geometry->pixel_lens_outer_aperture_radius());
+        lenses.push_back(lens);
     }
 }
 
@@ -48,15 +50,16 @@ void Factory::add_pixel_bin_array(ml::Frame* frame, ml::Scenery* scenery) {
     scenery->colors.add("bin_wall_green", ml::COLOR_GREEN);
 
     for (unsigned int i = 0; i < flower_positions.size(); i++) {
-        add_pixel_bin_with_name_at_pos(
-            bin_array,
-            scenery,
-            "bin_" + std::to_string(i),
-            flower_positions.at(i));
+        bins.push_back(
+            add_pixel_bin_with_name_at_pos(
+                bin_array,
+                scenery,
+                "bin_" + std::to_string(i),
+                flower_positions.at(i)));
     }
 }
 
-void Factory::add_pixel_bin_with_name_at_pos(
+ml::Frame* Factory::add_pixel_bin_with_name_at_pos(
     ml::Frame* frame,
     ml::Scenery* scenery,
     const std::string name,
@@ -82,6 +85,7 @@ void Factory::add_pixel_bin_with_name_at_pos(
         binwall->inner_color = scenery->colors.get("bin_wall_green");
         binwall->outer_reflection = geometry->config.bin_reflection;
     }
+    return bin;
 }
 
 void Factory::add_light_field_sensor_frontplate(
@@ -100,18 +104,20 @@ void Factory::add_light_field_sensor_frontplate(
     std::vector<ml::Vec3> face_plate_positions = face_plate_grid.get_grid();
     ml::Frame* face_plate = frame->add<ml::Frame>();
     face_plate->set_name_pos_rot("face_plate", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    unindexed.push_back(face_plate);
 
-    for (unsigned int i = 0; i < face_plate_positions.size(); i++) {
-        ml::HexPlane* face = face_plate->add<ml::HexPlane>();
-        face->set_name_pos_rot(
-            "face_"+std::to_string(i),
-            face_plate_positions.at(i),
-            ml::ROT3_UNITY);
-        face->outer_color = scenery->colors.get("housing_gray");
-        face->inner_color = scenery->colors.get("housing_gray");
-        face->set_outer_hex_radius(
-            geometry->pixel_lens_outer_aperture_radius());
-    }
+    ml::HexGridArray* faces = face_plate->add<ml::HexGridArray>();
+    faces->set_name_pos_rot("faces", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    faces->set_lattice(
+        face_plate_grid.get_unit_a(),
+        face_plate_grid.get_unit_b());
+    faces->set_positions(face_plate_positions);
+
+    ml::HexPlane* face = faces->add<ml::HexPlane>();
+    face->set_name_pos_rot("face", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    face->outer_color = scenery->colors.get("housing_gray");
+    face->inner_color = scenery->colors.get("housing_gray");
+    face->set_outer_hex_radius(geometry->pixel_lens_outer_aperture_radius());
 
     ml::Annulus* outer_front_ring = face_plate->add<ml::Annulus>();
     outer_front_ring->set_name_pos_rot(
@@ -146,6 +152,7 @@ void Factory::add_lixel_sensor_plane(ml::Frame* frame, ml::Scenery* scenery) {
         subpix->outer_color = scenery->colors.get("cell_red");
         subpix->inner_color = scenery->colors.get("cell_red");
         subpix->set_outer_hex_radius(geometry->lixel_outer_radius());
+        lixels.push_back(subpix);
 
         ml::sensor::Sensor* sub_pixel_sensor =
             new ml::sensor::Sensor(i, subpix);
@@ -162,6 +169,7 @@ void Factory::add_image_sensor_housing(ml::Frame *frame, ml::Scenery* scenery) {
     ml::Frame* sensor_housing = frame->add<ml::Frame>();
     sensor_housing->set_name_pos_rot(
         "sensor_housing", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    unindexed.push_back(sensor_housing);
 
     scenery->colors.add("frontplate_gray", ml::COLOR_GRAY);
 
@@ -192,7 +200,13 @@ void Factory::add_light_field_sensor_to_frame_in_scenery(
     ml::Frame *frame,
     ml::Scenery* scenery
 ) {
-    ml::Frame* light_field_sensor_front = frame->add<ml::Frame>();
+    SensorFrame* sensor = frame->add<SensorFrame>();
+    sensor->set_name_pos_rot(
+        "light_field_sensor",
+        ml::VEC3_ORIGIN,
+        ml::ROT3_UNITY);
+
+    ml::Frame* light_field_sensor_front = sensor->add<ml::Frame>();
     light_field_sensor_front->set_name_pos_rot(
         "front",
         ml::VEC3_ORIGIN,
@@ -201,9 +215,11 @@ void Factory::add_light_field_sensor_to_frame_in_scenery(
     add_lens_array(light_field_sensor_front, scenery);
     add_light_field_sensor_frontplate(light_field_sensor_front, scenery);
 
-    add_image_sensor_housing(frame, scenery);
-    add_pixel_bin_array(frame, scenery);
-    add_lixel_sensor_plane(frame, scenery);
+    add_image_sensor_housing(sensor, scenery);
+    add_pixel_bin_array(sensor, scenery);
+    add_lixel_sensor_plane(sensor, scenery);
+
+    sensor->set_index(*geometry, lenses, bins, lixels, unindexed);
 }
 
 void Factory::add_demonstration_light_field_sensor_to_frame_in_scenery(
@@ -3,6 +3,7 @@
 #define PLENOSCOPE_LIGHTFIELDSENSOR_FACTORY_H_
 
 #include <string>
+#include <vector>
 #include "merlict/merlict.h"
 #include "merlict_portal_plenoscope/light_field_sensor/Geometry.h"
 #include "merlict_portal_plenoscope/PlenoscopeScenery.h"
@@ -12,6 +13,10 @@ namespace light_field_sensor {
 
 class Factory {
     merlict::sensor::Sensors *sub_pixel_sensors;
+    std::vector<const merlict::Frame*> lenses;
+    std::vector<const merlict::Frame*> bins;
+    std::vector<const merlict::Frame*> lixels;
+    std::vector<const merlict::Frame*> unindexed;
  public:
     const Geometry* geometry;
     explicit Factory(const Geometry* geo);
@@ -35,7 +40,7 @@ class Factory {
     void add_pixel_bin_array(
         merlict::Frame* frame,
         merlict::Scenery* scenery);
-    void add_pixel_bin_with_name_at_pos(
+    merlict::Frame* add_pixel_bin_with_name_at_pos(
         merlict::Frame* frame,
         merlict::Scenery* scenery,
         const std::string name,
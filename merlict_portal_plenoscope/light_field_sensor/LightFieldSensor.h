@@ -5,5 +5,6 @@
 #include "merlict_portal_plenoscope/light_field_sensor/Config.h"
 #include "merlict_portal_plenoscope/light_field_sensor/Geometry.h"
 #include "merlict_portal_plenoscope/light_field_sensor/Factory.h"
+#include "merlict_portal_plenoscope/light_field_sensor/SensorFrame.h"
 
 #endif  // PLENOSCOPE_LIGHTFIELDSENSOR_LIGHTFIELDSENSOR_H_
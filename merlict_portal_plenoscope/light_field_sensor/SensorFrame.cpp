@@ -0,0 +1,230 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_portal_plenoscope/light_field_sensor/SensorFrame.h"
+#include <math.h>
+#include <algorithm>
+#include <sstream>
+namespace ml = merlict;
+
+
+namespace plenoscope {
+namespace light_field_sensor {
+
+CellIndex::CellIndex():
+    cell_size(1.0),
+    x_cell_min(0),
+    y_cell_min(0),
+    num_x_cells(0),
+    num_y_cells(0) {}
+
+CellIndex::CellIndex(
+    const std::vector<ml::Vec3> &_points,
+    const double _cell_size
+):
+    points(_points),
+    cell_size(_cell_size),
+    x_cell_min(0),
+    y_cell_min(0),
+    num_x_cells(0),
+    num_y_cells(0) {
+    if (cell_size <= 0.0) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "CellIndex: Expected cell_size > 0, but actual it is ";
+        info << cell_size << ".\n";
+        throw std::invalid_argument(info.str());
+    }
+    if (points.size() == 0)
+        return;
+
+    int64_t x_cell_max = cell(points[0].x);
+    int64_t y_cell_max = cell(points[0].y);
+    x_cell_min = x_cell_max;
+    y_cell_min = y_cell_max;
+    for (const ml::Vec3 &p : points) {
+        x_cell_min = std::min(x_cell_min, cell(p.x));
+        y_cell_min = std::min(y_cell_min, cell(p.y));
+        x_cell_max = std::max(x_cell_max, cell(p.x));
+        y_cell_max = std::max(y_cell_max, cell(p.y));
+    }
+    num_x_cells = x_cell_max - x_cell_min + 1;
+    num_y_cells = y_cell_max - y_cell_min + 1;
+
+    std::vector<uint32_t> cell_of_point(points.size());
+    cell_begin.resize(num_x_cells*num_y_cells + 1, 0u);
+    for (uint32_t i = 0; i < points.size(); i++) {
+        cell_of_point[i] =
+            (cell(points[i].x) - x_cell_min)*num_y_cells +
+            (cell(points[i].y) - y_cell_min);
+        cell_begin[cell_of_point[i] + 1]++;
+    }
+    for (uint64_t c = 0; c < cell_begin.size() - 1; c++)
+        cell_begin[c + 1] += cell_begin[c];
+
+    std::vector<uint32_t> fill(cell_begin.begin(), cell_begin.end() - 1);
+    point_ids.resize(points.size());
+    for (uint32_t i = 0; i < points.size(); i++)
+        point_ids[fill[cell_of_point[i]]++] = i;
+}
+
+int64_t CellIndex::cell(const double v)const {
+    return static_cast<int64_t>(floor(v/cell_size));
+}
+
+SensorFrame::SensorFrame():
+    num_paxel(0),
+    lens_radius(0.0),
+    lens_half_thickness(0.0),
+    bin_plane_z(0.0),
+    bin_hight(0.0),
+    lixel_radius(0.0) {}
+
+void SensorFrame::set_index(
+    const Geometry &geometry,
+    const std::vector<const ml::Frame*> &_lenses,
+    const std::vector<const ml::Frame*> &_bins,
+    const std::vector<const ml::Frame*> &_lixels,
+    const std::vector<const ml::Frame*> &_unindexed
+) {
+    if (
+        _lenses.size() != geometry.num_pixels() ||
+        _bins.size() != geometry.num_pixels() ||
+        _lixels.size() != geometry.num_lixel()
+    ) {
+        std::stringstream info;
+        info << __FILE__ << " " << __LINE__ << "\n";
+        info << "SensorFrame: Expected one lens and one bin for each of the ";
+        info << geometry.num_pixels() << " pixels, and ";
+        info << geometry.num_lixel() << " lixels, but actual there are ";
+        info << _lenses.size() << " lenses, " << _bins.size() << " bins, ";
+        info << "and " << _lixels.size() << " lixels.\n";
+        throw std::invalid_argument(info.str());
+    }
+    lenses = _lenses;
+    bins = _bins;
+    lixels = _lixels;
+    unindexed = _unindexed;
+
+    bin_positions = geometry.paxel_grid_centers_of_pixels;
+    num_paxel = geometry.paxel_per_pixel_template_grid.size();
+    pixel_index = CellIndex(geometry.pixel_grid, geometry.pixel_spacing());
+    bin_index = CellIndex(bin_positions, geometry.pixel_spacing());
+    paxel_index = CellIndex(
+        geometry.paxel_per_pixel_template_grid,
+        geometry.lixel_spacing());
+
+    lens_radius = geometry.pixel_lens_outer_aperture_radius();
+    const double curvature_radius = geometry.pixel_lens_curvature_radius();
+    // The caps are placed at the height of a cap away from the lens center.
+    // Twice this height bounds both the caps and the walls.
+    lens_half_thickness = 2.0*(curvature_radius - sqrt(
+        curvature_radius*curvature_radius - lens_radius*lens_radius));
+    bin_plane_z = geometry.pixel_plane_to_paxel_plane_distance();
+    bin_hight = geometry.bin_hight();
+    lixel_radius = geometry.lixel_outer_radius();
+}
+
+namespace {
+
+// Finds the range of the ray's parameter within z_start < z < z_stop.
+// Returns false when the ray does not reach the slab in front of its support.
+bool ray_in_slab(
+    const ml::Ray &ray,
+    const double z_start,
+    const double z_stop,
+    double *t_start,
+    double *t_stop
+) {
+    const double t_a = (z_start - ray.support().z)/ray.direction().z;
+    const double t_b = (z_stop - ray.support().z)/ray.direction().z;
+    *t_start = std::max(std::min(t_a, t_b), 0.0);
+    *t_stop = std::max(t_a, t_b);
+    return *t_start <= *t_stop;
+}
+
+bool find_along_ray_in_slab(
+    const ml::Ray &ray,
+    const double z_start,
+    const double z_stop,
+    const CellIndex &index,
+    const double radius,
+    const std::vector<const ml::Frame*> &frames,
+    std::vector<const ml::Frame*> *candidates
+) {
+    double t_start, t_stop;
+    if (!ray_in_slab(ray, z_start, z_stop, &t_start, &t_stop))
+        return true;
+    const ml::Vec3 a = ray.position_at(t_start);
+    const ml::Vec3 b = ray.position_at(t_stop);
+    return index.find(
+        a.x, a.y, b.x, b.y, radius, SensorFrame::MAX_CELLS,
+        [&](const uint32_t i) {candidates->push_back(frames[i]);});
+}
+
+}  // namespace
+
+bool SensorFrame::find_intersection_candidates(
+    const ml::Ray* ray,
+    std::vector<const ml::Frame*> *candidates
+)const {
+    const ml::Ray r = ml::ray_with_respect_to_frame(ray, this);
+    if (fabs(r.direction().z) < 1e-9)
+        return false;
+    const double margin = 1e-3*lixel_radius;
+    // Nothing is allocated per ray. When the ray turns out to be too flat,
+    // the candidates appended so far are taken back.
+    const uint64_t num_candidates = candidates->size();
+    candidates->insert(candidates->end(), unindexed.begin(), unindexed.end());
+
+    if (!find_along_ray_in_slab(
+            r,
+            -lens_half_thickness - margin,
+            lens_half_thickness + margin,
+            pixel_index,
+            lens_radius + margin,
+            lenses,
+            candidates)) {
+        candidates->resize(num_candidates);
+        return false;
+    }
+
+    if (!find_along_ray_in_slab(
+            r,
+            bin_plane_z - bin_hight - margin,
+            bin_plane_z + margin,
+            bin_index,
+            lens_radius + margin,
+            bins,
+            candidates)) {
+        candidates->resize(num_candidates);
+        return false;
+    }
+
+    const double t_lixel = (bin_plane_z - r.support().z)/r.direction().z;
+    if (t_lixel >= 0.0) {
+        const ml::Vec3 p = r.position_at(t_lixel);
+        bool paxels_found = true;
+        const bool flowers_found = bin_index.find(
+            p.x, p.y, p.x, p.y,
+            lens_radius + lixel_radius + margin,
+            MAX_CELLS,
+            [&](const uint32_t flower) {
+                const double x = p.x - bin_positions[flower].x;
+                const double y = p.y - bin_positions[flower].y;
+                const ml::Frame* const* flower_lixels =
+                    &lixels[flower*num_paxel];
+                paxels_found = paxel_index.find(
+                    x, y, x, y, lixel_radius + margin, MAX_CELLS,
+                    [&](const uint32_t paxel) {
+                        candidates->push_back(flower_lixels[paxel]);
+                    }) && paxels_found;
+            });
+        if (!flowers_found || !paxels_found) {
+            candidates->resize(num_candidates);
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace light_field_sensor
+}  // namespace plenoscope
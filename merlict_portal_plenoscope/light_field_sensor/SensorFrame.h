@@ -0,0 +1,141 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef PLENOSCOPE_LIGHTFIELDSENSOR_SENSORFRAME_H_
+#define PLENOSCOPE_LIGHTFIELDSENSOR_SENSORFRAME_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "merlict/merlict.h"
+#include "merlict_portal_plenoscope/light_field_sensor/Geometry.h"
+
+namespace plenoscope {
+namespace light_field_sensor {
+
+class CellIndex {
+    // Buckets points on the xy-plane into square cells, so that the points
+    // close to a line segment can be found without testing all of them.
+    std::vector<merlict::Vec3> points;
+    double cell_size;
+    int64_t x_cell_min;
+    int64_t y_cell_min;
+    int64_t num_x_cells;
+    int64_t num_y_cells;
+    std::vector<uint32_t> cell_begin;
+    std::vector<uint32_t> point_ids;
+
+    int64_t cell(const double v)const;
+
+ public:
+    CellIndex();
+    CellIndex(const std::vector<merlict::Vec3> &points, const double cell_size);
+    // Calls on_point(id) for the ids of the points within radius of the
+    // segment from (x0, y0) to (x1, y1). Returns false, and calls nothing,
+    // when the segment covers more than max_cells cells.
+    template<typename OnPoint>
+    bool find(
+        const double x0, const double y0,
+        const double x1, const double y1,
+        const double radius,
+        const uint64_t max_cells,
+        OnPoint on_point)const;
+};
+
+template<typename OnPoint>
+bool CellIndex::find(
+    const double x0, const double y0,
+    const double x1, const double y1,
+    const double radius,
+    const uint64_t max_cells,
+    OnPoint on_point
+)const {
+    const int64_t ix_start = std::max(
+        cell(std::min(x0, x1) - radius) - x_cell_min,
+        static_cast<int64_t>(0));
+    const int64_t ix_stop = std::min(
+        cell(std::max(x0, x1) + radius) - x_cell_min + 1,
+        num_x_cells);
+    const int64_t iy_start = std::max(
+        cell(std::min(y0, y1) - radius) - y_cell_min,
+        static_cast<int64_t>(0));
+    const int64_t iy_stop = std::min(
+        cell(std::max(y0, y1) + radius) - y_cell_min + 1,
+        num_y_cells);
+    if (ix_start >= ix_stop || iy_start >= iy_stop)
+        return true;
+    if (
+        static_cast<uint64_t>((ix_stop - ix_start)*(iy_stop - iy_start)) >
+        max_cells
+    )
+        return false;
+
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    const double segment_length_square = dx*dx + dy*dy;
+    const double radius_square = radius*radius;
+    for (int64_t ix = ix_start; ix < ix_stop; ix++) {
+        for (int64_t iy = iy_start; iy < iy_stop; iy++) {
+            const uint64_t c = ix*num_y_cells + iy;
+            for (uint32_t k = cell_begin[c]; k < cell_begin[c + 1]; k++) {
+                const merlict::Vec3 &p = points[point_ids[k]];
+                double a = 0.0;
+                if (segment_length_square > 0.0)
+                    a = std::max(0.0, std::min(1.0,
+                        ((p.x - x0)*dx + (p.y - y0)*dy)/
+                        segment_length_square));
+                const double ex = x0 + a*dx - p.x;
+                const double ey = y0 + a*dy - p.y;
+                if (ex*ex + ey*ey <= radius_square)
+                    on_point(point_ids[k]);
+            }
+        }
+    }
+    return true;
+}
+
+
+class SensorFrame :public merlict::Frame {
+    // Holds the lenses, bins and lixels of a light field sensor as ordinary
+    // frames, but instead of testing their bounding spheres one by one, it
+    // finds the few which a ray can reach from the hexagonal grids of the
+    // Geometry.
+    // The ray is intersected with the slab of the lens plane, the slab of the
+    // bin walls, and the lixel plane. Only the lenses, bins and lixels close
+    // to these crossings become candidates. The remaining frames, e.g. the
+    // face plate and the housing, are always candidates.
+    // Rays which are too flat to cross the slabs within a few cells are
+    // handed back to the generic tree traversal.
+    std::vector<const merlict::Frame*> lenses;
+    std::vector<const merlict::Frame*> bins;
+    std::vector<const merlict::Frame*> lixels;
+    std::vector<const merlict::Frame*> unindexed;
+
+    CellIndex pixel_index;
+    CellIndex bin_index;
+    CellIndex paxel_index;
+    std::vector<merlict::Vec3> bin_positions;
+    uint64_t num_paxel;
+
+    double lens_radius;
+    double lens_half_thickness;
+    double bin_plane_z;
+    double bin_hight;
+    double lixel_radius;
+
+ public:
+    static const uint64_t MAX_CELLS = 64;
+    SensorFrame();
+    void set_index(
+        const Geometry &geometry,
+        const std::vector<const merlict::Frame*> &lenses,
+        const std::vector<const merlict::Frame*> &bins,
+        const std::vector<const merlict::Frame*> &lixels,
+        const std::vector<const merlict::Frame*> &unindexed);
+    bool find_intersection_candidates(
+        const merlict::Ray* ray,
+        std::vector<const merlict::Frame*> *candidates)const;
+};
+
+}  // namespace light_field_sensor
+}  // namespace plenoscope
+
+#endif  // PLENOSCOPE_LIGHTFIELDSENSOR_SENSORFRAME_H_
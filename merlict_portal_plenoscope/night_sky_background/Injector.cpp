@@ -1,6 +1,7 @@
 // Copyright 2016 Sebastian A. Mueller
 #include "merlict_portal_plenoscope/night_sky_background/Injector.h"
-#include <limits>
+#include <cmath>
+#include <sstream>
 #include "merlict/merlict.h"
 namespace ml = merlict;
 
@@ -8,11 +9,65 @@ namespace ml = merlict;
 namespace plenoscope {
 namespace night_sky_background {
 
+double exposure_start_time_around_cherenkov_photons(
+    const std::vector<std::vector<signal_processing::PipelinePhoton>>
+        *photon_pipelines,
+    const double nsb_exposure_time
+) {
+    double mode_of_cherenkov_arrival_times =
+        signal_processing::mode_of_arrival_times(*photon_pipelines);
+    if (std::isnan(mode_of_cherenkov_arrival_times))
+        mode_of_cherenkov_arrival_times = 0.0;
+    return mode_of_cherenkov_arrival_times - 0.5*nsb_exposure_time;
+}
+
+void sort_and_subtract_exposure_start_time(
+    std::vector<std::vector<signal_processing::PipelinePhoton>>
+        *photon_pipelines,
+    const double nsb_exposure_start_time
+) {
+    for (unsigned int i = 0; i < photon_pipelines->size(); i++) {
+        sort_photon_pipelines_arrival_time(&photon_pipelines->at(i));
+        for (unsigned int p = 0; p < photon_pipelines->at(i).size(); p++) {
+            photon_pipelines->at(i).at(p).arrival_time -=
+                nsb_exposure_start_time;
+        }
+    }
+}
+
+std::vector<double> lixel_nsb_rates(
+    const calibration::LixelEfficiencies *lixel_efficiencies,
+    const Light *nsb
+) {
+    std::vector<double> rates;
+    rates.reserve(lixel_efficiencies->size());
+    for (unsigned int i = 0; i < lixel_efficiencies->size(); i++)
+        rates.push_back(
+            nsb->rate*
+            lixel_efficiencies->at(i)/nsb->sensor_geometry->num_lixel());
+    return rates;
+}
+
+std::vector<double> draw_relative_arrival_times(
+    const double rate,
+    const double exposure_time,
+    ml::random::Generator* prng
+) {
+    std::vector<double> arrival_times;
+    double relative_arrival_times_sum = prng->expovariate(rate);
+    while (relative_arrival_times_sum < exposure_time) {
+        const double time_until_next_photon = prng->expovariate(rate);
+        arrival_times.push_back(relative_arrival_times_sum);
+        relative_arrival_times_sum += time_until_next_photon;
+    }
+    return arrival_times;
+}
+
 void inject_nsb_into_photon_pipeline(
     std::vector<std::vector<signal_processing::PipelinePhoton>>
         *photon_pipelines,
     const double nsb_exposure_time,
-    const std::vector<float> *lixel_efficiencies,
+    const calibration::LixelEfficiencies *lixel_efficiencies,
     const Light *nsb,
     double *nsb_exposure_start_time,
     ml::random::Generator* prng
@@ -20,89 +75,178 @@ void inject_nsb_into_photon_pipeline(
     if (photon_pipelines->size() == 0)
         return;
 
-    // FIND MIN MAX ARRIVAL TIMES OF CHERENKOV PHOTONS
+    const double NSB_EXPOSURE_START_TIME =
+        exposure_start_time_around_cherenkov_photons(
+            photon_pipelines,
+            nsb_exposure_time);
 
-    unsigned int num_cherenkov_photons = 0;
-    std::vector<double> arrival_times;
-    double min_crk_arrival_time = std::numeric_limits<double>::max();
-    double max_crk_arrival_time = std::numeric_limits<double>::min();
+    const std::vector<double> rates = lixel_nsb_rates(lixel_efficiencies, nsb);
 
     for (unsigned int i = 0; i < photon_pipelines->size(); i++) {
-        if (photon_pipelines->at(i).size() > 0) {
-            if (photon_pipelines->at(i).front().arrival_time <
-                min_crk_arrival_time
-            )
-                min_crk_arrival_time =
-                    photon_pipelines->at(i).front().arrival_time;
-            if (photon_pipelines->at(i).back().arrival_time >
-                max_crk_arrival_time
-            )
-                max_crk_arrival_time =
-                    photon_pipelines->at(i).back().arrival_time;
-            num_cherenkov_photons += photon_pipelines->at(i).size();
+        const std::vector<double> nsb_arrival_times =
+            draw_relative_arrival_times(
+                rates.at(i),
+                nsb_exposure_time,
+                prng);
+
+        for (double nsb_arrival_time : nsb_arrival_times) {
+            signal_processing::PipelinePhoton nsb_ph(
+                NSB_EXPOSURE_START_TIME + nsb_arrival_time,
+                nsb->wavelength_probability.draw(prng->uniform()),
+                signal_processing::NIGHT_SKY_BACKGROUND);
+            photon_pipelines->at(i).push_back(nsb_ph);
         }
-        for (signal_processing::PipelinePhoton ph : photon_pipelines->at(i))
-            arrival_times.push_back(ph.arrival_time);
     }
 
-    // FIND MODE OF CHERENKOV PHOTON ARRIVAL TIMES
+    sort_and_subtract_exposure_start_time(
+        photon_pipelines,
+        NSB_EXPOSURE_START_TIME);
 
-    double mode_of_cherenkov_arrival_times;
+    (*nsb_exposure_start_time) = NSB_EXPOSURE_START_TIME;
+}
 
-    if (num_cherenkov_photons == 0) {
-        mode_of_cherenkov_arrival_times = 0.0;
-    } else {
-        const unsigned int bin_edge_count = 2u + sqrt(num_cherenkov_photons);
-        std::vector<double> arrival_time_bin_edges = ml::numeric::linspace(
-            min_crk_arrival_time,
-            max_crk_arrival_time,
-            bin_edge_count);
-        ml::Histogram1 arrival_time_histo(
-            arrival_times, arrival_time_bin_edges);
-        mode_of_cherenkov_arrival_times = arrival_time_histo.mode();
-    }
+void inject_nsb_from_library_into_photon_pipeline(
+    std::vector<std::vector<signal_processing::PipelinePhoton>>
+        *photon_pipelines,
+    const Library *library,
+    double *nsb_exposure_start_time,
+    ml::random::Generator* prng
+) {
+    if (photon_pipelines->size() == 0)
+        return;
 
-    // INIT START TIME OF NSB EXPOSURE
+    if (photon_pipelines->size() != library->num_lixel()) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "inject_nsb_from_library_into_photon_pipeline: ";
+        info << "Expected library to have " << photon_pipelines->size();
+        info << " lixel, but actual: " << library->num_lixel() << ".\n";
+        throw std::invalid_argument(info.str());
+    }
 
+    const double exposure_time = library->exposure_time();
     const double NSB_EXPOSURE_START_TIME =
-        mode_of_cherenkov_arrival_times - 0.5*nsb_exposure_time;
-
-
-    for (unsigned int i = 0; i < photon_pipelines->size(); i++) {
-        const double lixel_nsb_rate =
-            nsb->rate*
-            lixel_efficiencies->at(i)/nsb->sensor_geometry->num_lixel();
-
-        std::vector<double> nsb_arrival_times;
-        double relative_arrival_times_sum = prng->expovariate(lixel_nsb_rate);
-        while (relative_arrival_times_sum < nsb_exposure_time) {
-            const double time_until_next_photon =
-                prng->expovariate(lixel_nsb_rate);
-            nsb_arrival_times.push_back(
-                NSB_EXPOSURE_START_TIME + relative_arrival_times_sum);
-            relative_arrival_times_sum += time_until_next_photon;
-        }
-
-        for (double nsb_arrival_time : nsb_arrival_times) {
+        exposure_start_time_around_cherenkov_photons(
+            photon_pipelines,
+            exposure_time);
+
+    uint32_t realization = static_cast<uint32_t>(
+        prng->uniform()*library->num_realizations());
+    if (realization >= library->num_realizations())
+        realization = library->num_realizations() - 1u;
+    const double offset = prng->uniform()*exposure_time;
+
+    for (uint32_t i = 0; i < photon_pipelines->size(); i++) {
+        const LibraryPhoton* end = library->end(realization, i);
+        for (const LibraryPhoton* ph = library->begin(realization, i);
+            ph != end;
+            ph++
+        ) {
+            double arrival_time = ph->arrival_time + offset;
+            if (arrival_time >= exposure_time)
+                arrival_time -= exposure_time;
             signal_processing::PipelinePhoton nsb_ph(
-                nsb_arrival_time,
-                nsb->wavelength_probability.draw(prng->uniform()),
+                NSB_EXPOSURE_START_TIME + arrival_time,
+                ph->wavelength,
                 signal_processing::NIGHT_SKY_BACKGROUND);
             photon_pipelines->at(i).push_back(nsb_ph);
         }
+    }
 
-        sort_photon_pipelines_arrival_time(&photon_pipelines->at(i));
+    sort_and_subtract_exposure_start_time(
+        photon_pipelines,
+        NSB_EXPOSURE_START_TIME);
+
+    (*nsb_exposure_start_time) = NSB_EXPOSURE_START_TIME;
+}
+
+void inject_nsb_by_response_table_into_photon_pipeline(
+    std::vector<std::vector<signal_processing::PipelinePhoton>>
+        *photon_pipelines,
+    const double nsb_exposure_time,
+    const calibration::ResponseTable *table,
+    const Light *nsb,
+    double *nsb_exposure_start_time,
+    ml::random::Generator* prng
+) {
+    if (photon_pipelines->size() == 0)
+        return;
+
+    if (photon_pipelines->size() != table->num_lixel) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "inject_nsb_by_response_table_into_photon_pipeline: ";
+        info << "Expected response table to have ";
+        info << photon_pipelines->size() << " lixel, but actual: ";
+        info << table->num_lixel << ".\n";
+        throw std::invalid_argument(info.str());
     }
 
-    // SUBTRACT NSB_EXPOSURE_START_TIME
+    if (
+        table->binning.aperture_radius < nsb->aperture_radius ||
+        table->binning.max_incident_angle < nsb->fov_radius
+    ) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "inject_nsb_by_response_table_into_photon_pipeline: ";
+        info << "Expected response table to cover the aperture radius ";
+        info << nsb->aperture_radius << "m and the field of view radius ";
+        info << nsb->fov_radius << "rad, but actual: ";
+        info << table->binning.aperture_radius << "m and ";
+        info << table->binning.max_incident_angle << "rad.\n";
+        throw std::invalid_argument(info.str());
+    }
 
-    for (unsigned int i = 0; i < photon_pipelines->size(); i++) {
-        for (unsigned int p = 0; p < photon_pipelines->at(i).size(); p++) {
-            photon_pipelines->at(i).at(p).arrival_time -=
-                NSB_EXPOSURE_START_TIME;
+    const double NSB_EXPOSURE_START_TIME =
+        exposure_start_time_around_cherenkov_photons(
+            photon_pipelines,
+            nsb_exposure_time);
+
+    const ml::random::ZenithDistancePicker zenith_picker(
+        0.0,
+        nsb->fov_radius);
+    const ml::random::UniformPicker azimuth_picker(
+        0.0,
+        2*M_PI);
+
+    double nsb_arrival_time = prng->expovariate(nsb->rate);
+    while (nsb_arrival_time < nsb_exposure_time) {
+        const ml::Vec3 support = prng->get_point_on_xy_disc_within_radius(
+            nsb->aperture_radius);
+        const ml::Vec3 direction = ml::random::draw_point_on_sphere(
+            prng,
+            zenith_picker,
+            azimuth_picker);
+        const uint64_t bin = table->binning.bin(
+            support.x,
+            support.y,
+            direction.x,
+            direction.y);
+
+        uint32_t lixel;
+        double time_delay;
+        if (
+            bin < table->binning.size() &&
+            table->draw(bin, prng->uniform(), &lixel, &time_delay)
+        ) {
+            double arrival_time = fmod(
+                nsb_arrival_time + time_delay,
+                nsb_exposure_time);
+            if (arrival_time < 0.0)
+                arrival_time += nsb_exposure_time;
+            signal_processing::PipelinePhoton nsb_ph(
+                NSB_EXPOSURE_START_TIME + arrival_time,
+                nsb->wavelength_probability.draw(prng->uniform()),
+                signal_processing::NIGHT_SKY_BACKGROUND);
+            photon_pipelines->at(lixel).push_back(nsb_ph);
         }
+        nsb_arrival_time += prng->expovariate(nsb->rate);
     }
 
+    sort_and_subtract_exposure_start_time(
+        photon_pipelines,
+        NSB_EXPOSURE_START_TIME);
+
     (*nsb_exposure_start_time) = NSB_EXPOSURE_START_TIME;
 }
 
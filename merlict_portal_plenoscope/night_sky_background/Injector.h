@@ -4,8 +4,10 @@
 
 #include <vector>
 #include "merlict_portal_plenoscope/night_sky_background/Light.h"
+#include "merlict_portal_plenoscope/night_sky_background/Library.h"
 #include "merlict_signal_processing/signal_processing.h"
 #include "merlict_portal_plenoscope/calibration/LixelStatistics.h"
+#include "merlict_portal_plenoscope/calibration/ResponseTable.h"
 
 namespace plenoscope {
 namespace night_sky_background {
@@ -14,12 +16,49 @@ void inject_nsb_into_photon_pipeline(
     std::vector<std::vector<signal_processing::PipelinePhoton>> *
         photon_pipelines,
     const double exposure_time,
-    const std::vector<float> *lixel_efficiencies,
+    const calibration::LixelEfficiencies *lixel_efficiencies,
     const Light *nsb,
     double *nsb_exposure_start_time,
     merlict::random::Generator* prng
 );
 
+// Same as above, but the night sky background is not drawn photon by photon.
+// Instead, one realization is picked at random from the library and is
+// shifted cyclically in time by a random offset within the exposure_time.
+void inject_nsb_from_library_into_photon_pipeline(
+    std::vector<std::vector<signal_processing::PipelinePhoton>> *
+        photon_pipelines,
+    const Library *library,
+    double *nsb_exposure_start_time,
+    merlict::random::Generator* prng
+);
+
+// Same as above, but each photon is drawn on the aperture and within the
+// field of view, and is then assigned to a lixel, or is lost, by a lookup
+// in the response table instead of by ray tracing. Its arrival time is
+// delayed by the table's time delay, cyclically within the exposure_time.
+void inject_nsb_by_response_table_into_photon_pipeline(
+    std::vector<std::vector<signal_processing::PipelinePhoton>> *
+        photon_pipelines,
+    const double exposure_time,
+    const calibration::ResponseTable *table,
+    const Light *nsb,
+    double *nsb_exposure_start_time,
+    merlict::random::Generator* prng
+);
+
+std::vector<double> lixel_nsb_rates(
+    const calibration::LixelEfficiencies *lixel_efficiencies,
+    const Light *nsb
+);
+
+// Arrival times of a Poisson process with rate within [0, exposure_time).
+std::vector<double> draw_relative_arrival_times(
+    const double rate,
+    const double exposure_time,
+    merlict::random::Generator* prng
+);
+
 }  // namespace night_sky_background
 }  // namespace plenoscope
 
@@ -0,0 +1,177 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_portal_plenoscope/night_sky_background/Library.h"
+#include <string.h>
+#include <sstream>
+#include "merlict_portal_plenoscope/night_sky_background/Injector.h"
+namespace ml = merlict;
+
+
+namespace plenoscope {
+namespace night_sky_background {
+
+void write_library(
+    const std::string &path,
+    const uint32_t num_realizations,
+    const double exposure_time,
+    const std::vector<double> &lixel_rates,
+    const ml::random::SamplesFromDistribution* wavelength_probability,
+    ml::random::Generator* prng
+) {
+    std::ofstream file;
+    file.open(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "night_sky_background::write_library: ";
+        info << "Can not open file '" << path << "'.";
+        throw std::runtime_error(info.str());
+    }
+
+    const uint32_t num_lixel = lixel_rates.size();
+    ml::append_uint32(LIBRARY_MAGIC, file);
+    ml::append_uint32(LIBRARY_VERSION, file);
+    ml::append_uint32(num_realizations, file);
+    ml::append_uint32(num_lixel, file);
+    file.write(
+        reinterpret_cast<const char*>(&exposure_time),
+        sizeof(exposure_time));
+
+    // The offsets are only known after the photons are drawn. Reserve their
+    // space now and fill it in at the end, so that the photons can be
+    // streamed to the file one realization at a time.
+    const uint64_t num_offsets =
+        static_cast<uint64_t>(num_realizations)*num_lixel + 1u;
+    std::vector<uint64_t> offsets(num_offsets, 0u);
+    file.write(
+        reinterpret_cast<const char*>(offsets.data()),
+        num_offsets*sizeof(uint64_t));
+
+    uint64_t num_photons = 0u;
+    std::vector<LibraryPhoton> realization;
+    for (uint32_t r = 0; r < num_realizations; r++) {
+        realization.clear();
+        for (uint32_t l = 0; l < num_lixel; l++) {
+            offsets.at(static_cast<uint64_t>(r)*num_lixel + l) = num_photons;
+            const std::vector<double> arrival_times =
+                draw_relative_arrival_times(
+                    lixel_rates.at(l),
+                    exposure_time,
+                    prng);
+            for (const double arrival_time : arrival_times) {
+                LibraryPhoton ph;
+                ph.arrival_time = arrival_time;
+                ph.wavelength = wavelength_probability->draw(prng->uniform());
+                realization.push_back(ph);
+            }
+            num_photons += arrival_times.size();
+        }
+        file.write(
+            reinterpret_cast<const char*>(realization.data()),
+            realization.size()*sizeof(LibraryPhoton));
+    }
+    offsets.back() = num_photons;
+
+    file.seekp(LIBRARY_HEADER_SIZE);
+    file.write(
+        reinterpret_cast<const char*>(offsets.data()),
+        num_offsets*sizeof(uint64_t));
+    file.close();
+}
+
+Library::Library(const std::string &path): map_(path) {
+    std::stringstream info;
+    info << __FILE__ << ", " << __LINE__ << "\n";
+    info << "night_sky_background::Library: ";
+    info << "File '" << path << "' ";
+
+    if (map_.size() < LIBRARY_HEADER_SIZE) {
+        info << "is too small to hold a header.";
+        throw std::runtime_error(info.str());
+    }
+
+    uint32_t magic, version;
+    memcpy(&magic, map_.data() + 0, sizeof(uint32_t));
+    memcpy(&version, map_.data() + 4, sizeof(uint32_t));
+    memcpy(&num_realizations_, map_.data() + 8, sizeof(uint32_t));
+    memcpy(&num_lixel_, map_.data() + 12, sizeof(uint32_t));
+    memcpy(&exposure_time_, map_.data() + 16, sizeof(double));
+
+    if (magic != LIBRARY_MAGIC) {
+        info << "is not a night-sky-background library.";
+        throw std::runtime_error(info.str());
+    }
+    if (version != LIBRARY_VERSION) {
+        info << "has version " << version << ", ";
+        info << "but expected " << LIBRARY_VERSION << ".";
+        throw std::runtime_error(info.str());
+    }
+    if (num_realizations_ == 0u) {
+        info << "has no realizations.";
+        throw std::runtime_error(info.str());
+    }
+
+    const uint64_t num_offsets =
+        static_cast<uint64_t>(num_realizations_)*num_lixel_ + 1u;
+    const uint64_t photons_start =
+        LIBRARY_HEADER_SIZE + num_offsets*sizeof(uint64_t);
+    if (map_.size() < photons_start) {
+        info << "is too small to hold the offsets.";
+        throw std::runtime_error(info.str());
+    }
+    offsets_ = reinterpret_cast<const uint64_t*>(
+        map_.data() + LIBRARY_HEADER_SIZE);
+    photons_ = reinterpret_cast<const LibraryPhoton*>(
+        map_.data() + photons_start);
+
+    const uint64_t photon_bytes = map_.size() - photons_start;
+    if (
+        photon_bytes % sizeof(LibraryPhoton) != 0u ||
+        photon_bytes/sizeof(LibraryPhoton) != num_photons()
+    ) {
+        info << "has " << photon_bytes << " bytes of photons, but its ";
+        info << "offsets expect " << num_photons() << " photons.";
+        throw std::runtime_error(info.str());
+    }
+
+    // With the last offset being num_photons(), non-decreasing offsets
+    // starting at 0 keep begin() and end() within the photons.
+    if (offsets_[0] != 0u) {
+        info << "has offsets which do not start at 0.";
+        throw std::runtime_error(info.str());
+    }
+    for (uint64_t i = 1u; i < num_offsets; i++) {
+        if (offsets_[i] < offsets_[i - 1u]) {
+            info << "has offsets which decrease at " << i << ".";
+            throw std::runtime_error(info.str());
+        }
+    }
+}
+
+uint32_t Library::num_realizations()const {return num_realizations_;}
+
+uint32_t Library::num_lixel()const {return num_lixel_;}
+
+double Library::exposure_time()const {return exposure_time_;}
+
+uint64_t Library::num_photons()const {
+    return offsets_[static_cast<uint64_t>(num_realizations_)*num_lixel_];
+}
+
+const LibraryPhoton* Library::begin(
+    const uint32_t realization,
+    const uint32_t lixel
+)const {
+    return photons_ +
+        offsets_[static_cast<uint64_t>(realization)*num_lixel_ + lixel];
+}
+
+const LibraryPhoton* Library::end(
+    const uint32_t realization,
+    const uint32_t lixel
+)const {
+    return photons_ +
+        offsets_[static_cast<uint64_t>(realization)*num_lixel_ + lixel + 1u];
+}
+
+}  // namespace night_sky_background
+}  // namespace plenoscope
@@ -0,0 +1,70 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef PLENOSCOPE_NIGHTSKYBACKGROUND_LIBRARY_H_
+#define PLENOSCOPE_NIGHTSKYBACKGROUND_LIBRARY_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "merlict/merlict.h"
+
+namespace plenoscope {
+namespace night_sky_background {
+
+// A library holds num_realizations independent realizations of the night
+// sky background in all lixels of a light field sensor during one
+// exposure_time. The photons of realization r in lixel l are found in
+// photons[offsets[r*num_lixel + l], offsets[r*num_lixel + l + 1]).
+//
+// file layout:
+//      uint32  LIBRARY_MAGIC
+//      uint32  LIBRARY_VERSION
+//      uint32  num_realizations
+//      uint32  num_lixel
+//      float64 exposure_time
+//      uint64  offsets[num_realizations*num_lixel + 1]
+//      LibraryPhoton photons[offsets[num_realizations*num_lixel]]
+
+const uint32_t LIBRARY_MAGIC = 0x4C42534E;  // 'NSBL'
+const uint32_t LIBRARY_VERSION = 1u;
+const uint64_t LIBRARY_HEADER_SIZE = 24u;
+
+struct LibraryPhoton {
+    float arrival_time;  // relative to start of exposure
+    float wavelength;
+};
+
+void write_library(
+    const std::string &path,
+    const uint32_t num_realizations,
+    const double exposure_time,
+    const std::vector<double> &lixel_rates,
+    const merlict::random::SamplesFromDistribution* wavelength_probability,
+    merlict::random::Generator* prng);
+
+class Library {
+ public:
+    explicit Library(const std::string &path);
+    uint32_t num_realizations()const;
+    uint32_t num_lixel()const;
+    double exposure_time()const;
+    uint64_t num_photons()const;
+    const LibraryPhoton* begin(
+        const uint32_t realization,
+        const uint32_t lixel)const;
+    const LibraryPhoton* end(
+        const uint32_t realization,
+        const uint32_t lixel)const;
+
+ private:
+    merlict::MemoryMap map_;
+    uint32_t num_realizations_;
+    uint32_t num_lixel_;
+    double exposure_time_;
+    const uint64_t* offsets_;
+    const LibraryPhoton* photons_;
+};
+
+}  // namespace night_sky_background
+}  // namespace plenoscope
+
+#endif  // PLENOSCOPE_NIGHTSKYBACKGROUND_LIBRARY_H_
@@ -4,6 +4,7 @@
 
 #include "merlict_portal_plenoscope/night_sky_background/Injector.h"
 #include "merlict_portal_plenoscope/night_sky_background/Light.h"
+#include "merlict_portal_plenoscope/night_sky_background/Library.h"
 
 namespace plenoscope {
 namespace night_sky_background {
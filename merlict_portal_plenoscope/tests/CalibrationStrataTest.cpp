@@ -0,0 +1,72 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <vector>
+#include "merlict/tests/catch.hpp"
+#include "merlict_portal_plenoscope/calibration/Calibrator.h"
+#include "merlict_portal_plenoscope/calibration/Strata.h"
+#include "merlict/random/random.h"
+namespace ml = merlict;
+namespace cal = plenoscope::calibration;
+
+
+TEST_CASE("CalibrationStrataTest: size", "[merlict]") {
+    const cal::Strata strata(1.0, 0.1, 2, 3, 4, 5);
+    CHECK(strata.size() == 2u*3u*4u*5u);
+    CHECK(strata.num_directions() == 4u*5u);
+    CHECK_THROWS_AS(
+        cal::Strata(1.0, 0.1, 2, 0, 4, 5),
+        std::invalid_argument);
+}
+
+TEST_CASE("CalibrationStrataTest: draws_stay_in_their_stratum", "[merlict]") {
+    const double R = 25.0;
+    const double max_angle = 0.1;
+    const cal::Strata strata(R, max_angle, 2, 3, 4, 5);
+    ml::random::Mt19937 prng(0);
+    const double cap_height = 1.0 - cos(max_angle);
+
+    for (uint64_t s = 0; s < strata.size(); s++) {
+        const uint64_t aperture = s/strata.num_directions();
+        const uint64_t direction = s%strata.num_directions();
+        for (unsigned int i = 0; i < 100; i++) {
+            const ml::Vec3 support = strata.draw_support_on_aperture(
+                s, &prng);
+            const double r_sq = (support.x*support.x + support.y*support.y)/
+                (R*R);
+            double phi = atan2(support.y, support.x);
+            if (phi < 0.0) phi += 2.0*M_PI;
+            CHECK(support.z == 0.0);
+            CHECK(static_cast<uint64_t>(r_sq*2.0) == aperture/3);
+            CHECK(static_cast<uint64_t>(phi/(2.0*M_PI)*3.0) == aperture%3);
+
+            const ml::Vec3 dir = strata.draw_incident_direction(s, &prng);
+            double az = atan2(dir.y, dir.x);
+            if (az < 0.0) az += 2.0*M_PI;
+            CHECK(dir.norm() == Approx(1.0));
+            CHECK(
+                static_cast<uint64_t>((1.0 - dir.z)/cap_height*4.0) ==
+                direction/5);
+            CHECK(static_cast<uint64_t>(az/(2.0*M_PI)*5.0) == direction%5);
+        }
+    }
+}
+
+TEST_CASE("CalibrationStrataTest: distribute_photons_to_strata", "[merlict]") {
+    std::vector<uint64_t> need(10, 0u);
+    std::vector<uint64_t> uniform = cal::distribute_photons_to_strata(
+        1000, 0.2, need);
+    for (const uint64_t n : uniform)
+        CHECK(n == 100u);
+
+    need.at(3) = 50u;
+    need.at(7) = 150u;
+    std::vector<uint64_t> adapted = cal::distribute_photons_to_strata(
+        1000, 0.2, need);
+    CHECK(adapted.at(0) == 20u);
+    CHECK(adapted.at(3) == 20u + 200u);
+    CHECK(adapted.at(7) == 20u + 600u);
+
+    std::vector<uint64_t> few = cal::distribute_photons_to_strata(
+        10, 0.0, need);
+    CHECK(few.at(0) == 1u);
+}
@@ -0,0 +1,113 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <vector>
+#include "merlict/tests/catch.hpp"
+#include "merlict_portal_plenoscope/calibration/LixelSymmetries.h"
+#include "merlict_portal_plenoscope/light_field_sensor/Geometry.h"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+namespace cal = plenoscope::calibration;
+
+
+plenoscope::light_field_sensor::Config small_sensor_config() {
+    plenoscope::light_field_sensor::Config config;
+    config.expected_imaging_system_focal_length = 75.0;
+    config.expected_imaging_system_max_aperture_radius = 25.0;
+    config.max_FoV_diameter = ml::deg2rad(1.5);
+    config.pixel_FoV_hex_flat2flat = ml::deg2rad(0.1);
+    config.num_paxel_on_pixel_diagonal = 5;
+    config.housing_overhead = 1.2;
+    config.lens_refraction = &plenoscope::light_field_sensor::pmma_refraction;
+    return config;
+}
+
+TEST_CASE("CalibrationSymmetryTest: hex_symmetry", "[merlict]") {
+    double x = 1.0;
+    double y = 0.0;
+    cal::HexSymmetry(1, false).apply(&x, &y);
+    CHECK(x == Approx(0.5));
+    CHECK(y == Approx(sqrt(3.0)/2.0));
+
+    x = 0.0;
+    y = 1.0;
+    cal::HexSymmetry(0, true).apply(&x, &y);
+    CHECK(x == Approx(0.0).margin(1e-12));
+    CHECK(y == Approx(-1.0));
+
+    x = 0.0;
+    y = 1.0;
+    cal::HexSymmetry(3, true).apply(&x, &y);
+    CHECK(x == Approx(0.0).margin(1e-12));
+    CHECK(y == Approx(1.0));
+}
+
+TEST_CASE("CalibrationSymmetryTest: lixel_images", "[merlict]") {
+    const plenoscope::light_field_sensor::Geometry geometry(
+        small_sensor_config());
+    const cal::LixelSymmetries symmetries(geometry);
+    const std::vector<ml::Vec3> &lixels = geometry.lixel_positions();
+
+    REQUIRE(symmetries.size() >= 6u);
+    CHECK(symmetries.size() <= cal::NUM_HEX_SYMMETRIES);
+    CHECK(symmetries.at(0).rotation == 0u);
+    CHECK(!symmetries.at(0).mirrored);
+
+    for (uint64_t s = 0; s < symmetries.size(); s++) {
+        std::vector<uint32_t> hits(lixels.size(), 0u);
+        for (uint32_t l = 0; l < lixels.size(); l++) {
+            const uint32_t img = symmetries.image(s, l);
+            REQUIRE(img < lixels.size());
+            hits[img]++;
+            double x = lixels[l].x;
+            double y = lixels[l].y;
+            symmetries.at(s).apply(&x, &y);
+            CHECK(lixels[img].x == Approx(x).margin(1e-9));
+            CHECK(lixels[img].y == Approx(y).margin(1e-9));
+        }
+        // every symmetry permutes the lixels
+        for (const uint32_t h : hits)
+            CHECK(h == 1u);
+    }
+}
+
+TEST_CASE("CalibrationSymmetryTest: photon_result_image", "[merlict]") {
+    const plenoscope::light_field_sensor::Geometry geometry(
+        small_sensor_config());
+    const cal::LixelSymmetries symmetries(geometry);
+
+    plenoscope::CalibrationPhotonResult result;
+    result.reached_sensor = true;
+    result.lixel_id = 42;
+    result.x_pos_on_principal_aperture = 3.0;
+    result.y_pos_on_principal_aperture = -1.0;
+    result.x_tilt_vs_optical_axis = 0.01;
+    result.y_tilt_vs_optical_axis = 0.002;
+    result.time_of_flight = 1e-9;
+
+    for (uint64_t s = 0; s < symmetries.size(); s++) {
+        const plenoscope::CalibrationPhotonResult img =
+            symmetries.image(s, result);
+        double x = 3.0;
+        double y = -1.0;
+        double cx = 0.01;
+        double cy = 0.002;
+        symmetries.at(s).apply(&x, &y);
+        symmetries.at(s).apply(&cx, &cy);
+        CHECK(img.reached_sensor);
+        CHECK(img.lixel_id == symmetries.image(s, 42u));
+        CHECK(img.x_pos_on_principal_aperture == Approx(x));
+        CHECK(img.y_pos_on_principal_aperture == Approx(y));
+        CHECK(img.x_tilt_vs_optical_axis == Approx(cx));
+        CHECK(img.y_tilt_vs_optical_axis == Approx(cy));
+        CHECK(img.time_of_flight == result.time_of_flight);
+    }
+}
+
+TEST_CASE("CalibrationSymmetryTest: sensor_off_axis", "[merlict]") {
+    plenoscope::light_field_sensor::Config config = small_sensor_config();
+    config.sensor_plane2imaging_system.set_transformation(
+        ml::Rot3(0.0, 0.0, 0.0),
+        ml::Vec3(0.1, 0.0, 75.0));
+    const plenoscope::light_field_sensor::Geometry geometry(config);
+    CHECK_THROWS_AS(cal::LixelSymmetries(geometry), std::invalid_argument);
+}
@@ -0,0 +1,74 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/tests/catch.hpp"
+#include "merlict_portal_plenoscope/EventWorkspace.h"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+namespace sp = signal_processing;
+
+
+TEST_CASE("EventWorkspaceTest: reset_keeps_capacity", "[merlict]") {
+    plenoscope::EventWorkspace ws(100u, 1000u);
+    ws.photon_pipelines.resize(3);
+    ws.electric_pipelines.resize(3);
+
+    ws.photon_pipelines.at(0).resize(10);
+    ws.photon_pipelines.at(1).resize(1000);
+    ws.electric_pipelines.at(2).resize(50);
+    ws.extracted_pulses.pulses.resize(500);
+    for (unsigned int i = 0; i < 10; i++)
+        ws.photons.push_back(
+            ml::Photon(ml::VEC3_ORIGIN, ml::VEC3_UNIT_Z, 433e-9));
+
+    ws.reset();
+
+    CHECK(ws.photon_pipelines.size() == 3u);
+    CHECK(ws.electric_pipelines.size() == 3u);
+
+    CHECK(ws.photon_pipelines.at(0).size() == 0u);
+    CHECK(ws.photon_pipelines.at(0).capacity() >= 10u);
+    CHECK(ws.photon_pipelines.at(1).size() == 0u);
+    CHECK(ws.photon_pipelines.at(1).capacity() == 0u);
+    CHECK(ws.electric_pipelines.at(2).size() == 0u);
+    CHECK(ws.electric_pipelines.at(2).capacity() >= 50u);
+    CHECK(ws.extracted_pulses.pulses.size() == 0u);
+    CHECK(ws.extracted_pulses.pulses.capacity() >= 500u);
+    CHECK(ws.photons.size() == 0u);
+    CHECK(ws.photons.capacity() >= 10u);
+
+    ws.extracted_pulses.pulses.resize(2000);
+    ws.reset();
+    CHECK(ws.extracted_pulses.pulses.capacity() == 0u);
+}
+
+TEST_CASE("EventWorkspaceTest: stages_write_into_workspace", "[merlict]") {
+    sp::PhotoElectricConverter::Config config;
+    config.dark_rate = 1e9;
+    sp::PhotoElectricConverter::Converter converter(&config);
+
+    plenoscope::EventWorkspace ws;
+    ws.photon_pipelines.resize(2);
+    ws.electric_pipelines.resize(2);
+
+    ml::random::Mt19937 prng_ws(0u);
+    ml::random::Mt19937 prng(0u);
+    for (int event = 0; event < 3; event++) {
+        ws.reset();
+        for (unsigned int ch = 0; ch < 2; ch++) {
+            converter.get_pulse_pipeline_for_photon_pipeline(
+                ws.photon_pipelines.at(ch),
+                50e-9,
+                &prng_ws,
+                &ws.electric_pipelines.at(ch));
+            std::vector<sp::ElectricPulse> expected =
+                converter.get_pulse_pipeline_for_photon_pipeline(
+                    ws.photon_pipelines.at(ch),
+                    50e-9,
+                    &prng);
+            REQUIRE(ws.electric_pipelines.at(ch).size() == expected.size());
+            for (unsigned int p = 0; p < expected.size(); p++)
+                CHECK(
+                    ws.electric_pipelines.at(ch).at(p).arrival_time ==
+                    expected.at(p).arrival_time);
+        }
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <vector>
+#include "merlict/tests/catch.hpp"
+#include "merlict_portal_plenoscope/light_field_sensor/LightFieldSensor.h"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+namespace lfs = plenoscope::light_field_sensor;
+
+
+lfs::Config small_indexed_sensor_config() {
+    lfs::Config config;
+    config.expected_imaging_system_focal_length = 75.0;
+    config.expected_imaging_system_max_aperture_radius = 25.0;
+    config.max_FoV_diameter = ml::deg2rad(1.0);
+    config.pixel_FoV_hex_flat2flat = ml::deg2rad(0.1);
+    config.num_paxel_on_pixel_diagonal = 5;
+    config.housing_overhead = 1.2;
+    return config;
+}
+
+void collect_leafs(const ml::Frame* frame, std::vector<const ml::Frame*> *l) {
+    // A HexGridArray intersects its elements as a whole.
+    if (
+        frame->has_children() &&
+        dynamic_cast<const ml::HexGridArray*>(frame) == nullptr
+    ) {
+        for (const ml::Frame* child : *frame->get_children())
+            collect_leafs(child, l);
+    } else {
+        l->push_back(frame);
+    }
+}
+
+ml::Intersection brute_force_intersection(
+    const ml::Ray &ray,
+    const std::vector<const ml::Frame*> &leafs
+) {
+    std::vector<ml::Intersection> intersections;
+    for (const ml::Frame* leaf : leafs) {
+        ml::Ray ray_in_leaf = ml::ray_with_respect_to_frame(&ray, leaf);
+        leaf->calculate_intersection_with(&ray_in_leaf, &intersections);
+    }
+    if (intersections.size() == 0)
+        return ml::Intersection();
+    return *std::min_element(
+        intersections.begin(),
+        intersections.end(),
+        ml::Intersection::compare);
+}
+
+TEST_CASE("LightFieldSensorIndexTest: cell_index", "[merlict]") {
+    std::vector<ml::Vec3> points;
+    for (int x = 0; x < 10; x++)
+        for (int y = 0; y < 10; y++)
+            points.push_back(ml::Vec3(x, y, 0.0));
+    lfs::CellIndex index(points, 1.0);
+
+    std::vector<uint32_t> ids;
+    const auto append = [&ids](const uint32_t id) {ids.push_back(id);};
+    CHECK(index.find(4.9, 5.1, 4.9, 5.1, 0.2, 64u, append));
+    REQUIRE(ids.size() == 1u);
+    CHECK(points[ids[0]].x == 5.0);
+    CHECK(points[ids[0]].y == 5.0);
+
+    ids.clear();
+    CHECK(index.find(0.0, 0.0, 9.0, 0.0, 0.1, 64u, append));
+    CHECK(ids.size() == 10u);
+
+    ids.clear();
+    CHECK(!index.find(0.0, 0.0, 9.0, 9.0, 0.1, 16u, append));
+    CHECK(ids.size() == 0u);
+
+    ids.clear();
+    CHECK(index.find(50.0, 50.0, 60.0, 50.0, 1.0, 16u, append));
+    CHECK(ids.size() == 0u);
+}
+
+TEST_CASE("LightFieldSensorIndexTest: same_as_brute_force", "[merlict]") {
+    const lfs::Geometry geometry(small_indexed_sensor_config());
+    ml::Scenery scenery;
+    scenery.root.set_name_pos_rot("root", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+    ml::Frame* sensor_frame = scenery.root.add<ml::Frame>();
+    sensor_frame->set_name_pos_rot(
+        "sensor", ml::Vec3(0.1, -0.2, 0.3), ml::Rot3(0.0, 0.0, 0.2));
+    lfs::Factory factory(&geometry);
+    factory.add_light_field_sensor_to_frame_in_scenery(sensor_frame, &scenery);
+    scenery.root.init_tree_based_on_mother_child_relations();
+
+    std::vector<const ml::Frame*> leafs;
+    collect_leafs(&scenery.root, &leafs);
+    REQUIRE(leafs.size() > geometry.num_lixel());
+
+    const ml::HomTra3* sensor2world = sensor_frame->frame2world();
+    const double r = geometry.max_outer_sensor_radius();
+    const double d = geometry.pixel_plane_to_paxel_plane_distance();
+    ml::random::Mt19937 prng(0);
+    uint64_t num_hits = 0;
+    for (uint64_t i = 0; i < 3000; i++) {
+        ml::Vec3 support, direction;
+        if (i % 3 == 2) {
+            // anywhere, in any direction
+            support = ml::Vec3(
+                prng.uniform()*2.0*r - r,
+                prng.uniform()*2.0*r - r,
+                prng.uniform()*2.0*d - 0.5*d);
+            direction = ml::Vec3(
+                prng.uniform() - 0.5,
+                prng.uniform() - 0.5,
+                prng.uniform() - 0.5);
+        } else {
+            // coming from the imaging system
+            support = ml::Vec3(
+                prng.uniform()*2.0*r - r,
+                prng.uniform()*2.0*r - r,
+                -d);
+            const double theta = prng.uniform()*ml::deg2rad(40.0);
+            const double phi = prng.uniform()*2.0*M_PI;
+            direction = ml::Vec3(
+                sin(theta)*cos(phi), sin(theta)*sin(phi), cos(theta));
+        }
+        const ml::Ray ray(
+            sensor2world->position(support),
+            sensor2world->orientation(direction));
+
+        const ml::Intersection indexed =
+            ml::rays_first_intersection_with_frame(&ray, &scenery.root);
+        const ml::Intersection brute = brute_force_intersection(ray, leafs);
+
+        REQUIRE(indexed.does_intersect() == brute.does_intersect());
+        if (brute.does_intersect()) {
+            num_hits++;
+            CHECK(indexed.object() == brute.object());
+            CHECK(indexed.distance_to_ray_support() ==
+                Approx(brute.distance_to_ray_support()));
+        }
+    }
+    CHECK(num_hits > 1000u);
+}
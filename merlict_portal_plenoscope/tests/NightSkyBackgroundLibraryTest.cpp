@@ -0,0 +1,170 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <fstream>
+#include "merlict/tests/catch.hpp"
+#include "merlict_portal_plenoscope/night_sky_background/NightSkyBackground.h"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+namespace sp = signal_processing;
+namespace nsb = plenoscope::night_sky_background;
+
+
+TEST_CASE("NightSkyBackgroundLibraryTest: write_and_read", "[merlict]") {
+    ml::function::Func1 flux_vs_wavelength(
+        ml::tsvio::gen_table_from_file(
+            "merlict_portal_plenoscope/"
+            "tests/"
+            "resources/"
+            "night_sky_background_flux_vs_wavelength_la_palma.txt"));
+    ml::random::SamplesFromDistribution wavelength_probability(
+        &flux_vs_wavelength);
+
+    const double exposure_time = 1e-6;
+    std::vector<double> rates = {1e9, 0.0, 2e8};
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/nsb_library.bin.tmp";
+
+    ml::random::Mt19937 prng(0u);
+    nsb::write_library(
+        path,
+        7u,
+        exposure_time,
+        rates,
+        &wavelength_probability,
+        &prng);
+
+    nsb::Library library(path);
+    CHECK(library.num_realizations() == 7u);
+    CHECK(library.num_lixel() == 3u);
+    CHECK(library.exposure_time() == exposure_time);
+
+    uint64_t num_photons = 0u;
+    for (uint32_t r = 0; r < library.num_realizations(); r++) {
+        for (uint32_t l = 0; l < library.num_lixel(); l++) {
+            float last_arrival_time = 0.0;
+            for (
+                const nsb::LibraryPhoton* ph = library.begin(r, l);
+                ph != library.end(r, l);
+                ph++
+            ) {
+                CHECK(ph->arrival_time >= last_arrival_time);
+                CHECK(ph->arrival_time < exposure_time);
+                CHECK(ph->wavelength > 0.0);
+                last_arrival_time = ph->arrival_time;
+                num_photons++;
+            }
+        }
+        CHECK(library.begin(r, 1) == library.end(r, 1));
+        const double num_in_first_lixel = library.end(r, 0) -
+            library.begin(r, 0);
+        CHECK(num_in_first_lixel == Approx(1e3).margin(150));
+    }
+    CHECK(num_photons == library.num_photons());
+}
+
+void overwrite_offset(
+    const std::string &path,
+    const uint64_t i,
+    const uint64_t offset
+) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(nsb::LIBRARY_HEADER_SIZE + i*sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&offset), sizeof(uint64_t));
+}
+
+TEST_CASE("NightSkyBackgroundLibraryTest: corrupt_offsets", "[merlict]") {
+    ml::function::Func1 flux_vs_wavelength(
+        ml::tsvio::gen_table_from_file(
+            "merlict_portal_plenoscope/"
+            "tests/"
+            "resources/"
+            "night_sky_background_flux_vs_wavelength_la_palma.txt"));
+    ml::random::SamplesFromDistribution wavelength_probability(
+        &flux_vs_wavelength);
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/nsb_library.bin.tmp";
+    const std::vector<double> rates = {1e9, 2e8};
+    ml::random::Mt19937 prng(0u);
+
+    // 2 realizations of 2 lixel have 5 offsets.
+    struct Corruption {uint64_t i; uint64_t offset;};
+    const std::vector<Corruption> corruptions = {
+        {0u, 1u},
+        {2u, 0u},
+        {2u, 1000000u},
+        {4u, 1000000u}};
+    for (const Corruption &corruption : corruptions) {
+        nsb::write_library(
+            path, 2u, 1e-6, rates, &wavelength_probability, &prng);
+        CHECK_NOTHROW(nsb::Library(path));
+        overwrite_offset(path, corruption.i, corruption.offset);
+        CHECK_THROWS_AS(nsb::Library(path), std::runtime_error);
+    }
+}
+
+TEST_CASE("NightSkyBackgroundLibraryTest: inject", "[merlict]") {
+    ml::function::Func1 flux_vs_wavelength(
+        ml::tsvio::gen_table_from_file(
+            "merlict_portal_plenoscope/"
+            "tests/"
+            "resources/"
+            "night_sky_background_flux_vs_wavelength_la_palma.txt"));
+    ml::random::SamplesFromDistribution wavelength_probability(
+        &flux_vs_wavelength);
+
+    const double exposure_time = 1e-6;
+    std::vector<double> rates = {1e9, 0.0, 2e8};
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/nsb_library.bin.tmp";
+
+    ml::random::Mt19937 prng(0u);
+    nsb::write_library(
+        path,
+        3u,
+        exposure_time,
+        rates,
+        &wavelength_probability,
+        &prng);
+    nsb::Library library(path);
+
+    std::vector<std::vector<sp::PipelinePhoton>> pipelines(3);
+    pipelines.at(2).push_back(sp::PipelinePhoton(42e-9, 433e-9, 1));
+
+    double start_time = 0.0;
+    nsb::inject_nsb_from_library_into_photon_pipeline(
+        &pipelines,
+        &library,
+        &start_time,
+        &prng);
+
+    CHECK(start_time == Approx(42e-9 - 0.5*exposure_time));
+    CHECK(pipelines.at(0).size() > 0u);
+    CHECK(pipelines.at(1).size() == 0u);
+
+    unsigned int num_cherenkov = 0;
+    for (const std::vector<sp::PipelinePhoton> &pipeline : pipelines) {
+        for (unsigned int p = 0; p < pipeline.size(); p++) {
+            CHECK(pipeline.at(p).arrival_time >= 0.0);
+            CHECK(pipeline.at(p).arrival_time < exposure_time);
+            if (p > 0)
+                CHECK(
+                    pipeline.at(p).arrival_time >=
+                    pipeline.at(p - 1).arrival_time);
+            if (pipeline.at(p).simulation_truth_id == 1)
+                num_cherenkov++;
+            else
+                CHECK(
+                    pipeline.at(p).simulation_truth_id ==
+                    sp::NIGHT_SKY_BACKGROUND);
+        }
+    }
+    CHECK(num_cherenkov == 1u);
+
+    std::vector<std::vector<sp::PipelinePhoton>> wrong_size(2);
+    CHECK_THROWS_AS(
+        nsb::inject_nsb_from_library_into_photon_pipeline(
+            &wrong_size,
+            &library,
+            &start_time,
+            &prng),
+        std::invalid_argument);
+}
@@ -59,3 +59,53 @@ TEST_CASE("OnlineStatisticsTest: mean", "[merlict]") {
         ov.add(vals.at(i));
     CHECK(3.0 == ov.mean());
 }
+
+TEST_CASE("OnlineStatisticsTest: merge", "[merlict]") {
+    ml::random::Mt19937 prng(0);
+    pl::OnlineStatistics all;
+    std::vector<pl::OnlineStatistics> parts(7);
+    for (unsigned int i = 0; i < 100000; i++) {
+        const double r = prng.normal(3.0, 2.0);
+        all.add(r);
+        parts.at(i % 5 == 0 ? 0 : 1 + (i % 3)).add(r);
+    }
+    pl::OnlineStatistics merged;
+    for (const pl::OnlineStatistics &part : parts)
+        merged.merge(part);
+
+    CHECK(merged.num_samples() == all.num_samples());
+    CHECK(merged.sum() == Approx(all.sum()).epsilon(1e-9));
+    CHECK(merged.mean() == Approx(all.mean()).epsilon(1e-9));
+    CHECK(merged.stddev() == Approx(all.stddev()).epsilon(1e-9));
+
+    pl::OnlineStatistics empty;
+    empty.merge(pl::OnlineStatistics());
+    CHECK(empty.num_samples() == 0.0);
+}
+
+TEST_CASE("OnlineStatisticsTest: weights_equal_repeated_samples", "[merlict]") {
+    ml::random::Mt19937 prng(0);
+    pl::OnlineStatistics repeated;
+    pl::OnlineStatistics weighted;
+    pl::OnlineStatistics merged;
+    pl::OnlineStatistics part;
+    for (unsigned int i = 0; i < 1000; i++) {
+        const double r = prng.normal(3.0, 2.0);
+        const unsigned int multiplicity = 1 + i%3;
+        for (unsigned int m = 0; m < multiplicity; m++)
+            repeated.add(r);
+        weighted.add(r, multiplicity);
+        if (i%2 == 0)
+            merged.add(r, multiplicity);
+        else
+            part.add(r, multiplicity);
+    }
+    merged.merge(part);
+
+    CHECK(weighted.num_samples() == 1000.0);
+    CHECK(weighted.sum_of_weights() == repeated.num_samples());
+    CHECK(weighted.mean() == Approx(repeated.mean()).epsilon(1e-9));
+    CHECK(weighted.stddev() == Approx(repeated.stddev()).epsilon(1e-9));
+    CHECK(merged.mean() == Approx(repeated.mean()).epsilon(1e-9));
+    CHECK(merged.stddev() == Approx(repeated.stddev()).epsilon(1e-9));
+}
@@ -1,6 +1,13 @@
 // Copyright 2014 Sebastian A. Mueller
 #include "merlict/tests/catch.hpp"
 #include "merlict_portal_plenoscope/calibration/LixelStatistics.h"
+#include "merlict_portal_plenoscope/calibration/LixelStatisticsFiller.h"
+#include "merlict_portal_plenoscope/calibration/PartialLixelStatistics.h"
+#include "merlict/random/random.h"
+#include <stdint.h>
+#include <array>
+#include <fstream>
+#include <sstream>
 
 
 TEST_CASE("PlenoscopeLixelStatisticsTest: default_ctor", "[merlict]") {
@@ -81,3 +88,217 @@ TEST_CASE("PlenoscopeLixelStatisticsTest: read_non_existing_binary_file", "[merl
 TEST_CASE("PlenoscopeLixelStatisticsTest: size_is_just_a_plain_struct", "[merlict]") {
     CHECK(12u*4u == sizeof(plenoscope::calibration::LixelStatistic));
 }
+
+TEST_CASE("PlenoscopeLixelStatisticsTest: merge_fillers", "[merlict]") {
+    namespace cal = plenoscope::calibration;
+    const uint64_t num_lixel = 17;
+    cal::LixelStatisticsFiller all(num_lixel, 1, 10000);
+    std::vector<cal::LixelStatisticsFiller> parts(
+        3,
+        cal::LixelStatisticsFiller(num_lixel, 1, 10000));
+
+    merlict::random::Mt19937 prng(0);
+    for (unsigned int i = 0; i < 10000; i++) {
+        plenoscope::CalibrationPhotonResult result;
+        result.reached_sensor = prng.uniform() > 0.3;
+        result.lixel_id = num_lixel*prng.uniform();
+        result.x_pos_on_principal_aperture = prng.uniform();
+        result.y_pos_on_principal_aperture = prng.uniform();
+        result.x_tilt_vs_optical_axis = prng.uniform();
+        result.y_tilt_vs_optical_axis = prng.uniform();
+        result.time_of_flight = prng.uniform();
+        all.fill(result);
+        parts.at(i % 3).fill(result);
+    }
+
+    parts.at(0).merge(parts.at(1), 0, 8);
+    parts.at(0).merge(parts.at(1), 8, num_lixel);
+    parts.at(0).merge(parts.at(2), 0, num_lixel);
+
+    const std::vector<cal::LixelStatistic> expected =
+        all.get_lixel_statistics();
+    const std::vector<cal::LixelStatistic> merged =
+        parts.at(0).get_lixel_statistics();
+    REQUIRE(merged.size() == num_lixel);
+    for (uint64_t i = 0; i < num_lixel; i++) {
+        CHECK(merged.at(i).efficiency == expected.at(i).efficiency);
+        CHECK(merged.at(i).cx_mean == Approx(expected.at(i).cx_mean));
+        CHECK(merged.at(i).cx_std == Approx(expected.at(i).cx_std));
+        CHECK(merged.at(i).y_std == Approx(expected.at(i).y_std));
+        CHECK(
+            merged.at(i).time_delay_mean ==
+            Approx(expected.at(i).time_delay_mean));
+    }
+}
+
+TEST_CASE("PlenoscopeLixelStatisticsTest: merge_partial_files", "[merlict]") {
+    namespace cal = plenoscope::calibration;
+    const uint64_t num_lixel = 17;
+    const uint64_t num_jobs = 3;
+    const uint64_t photons_per_job = 3000;
+    cal::LixelStatisticsFiller all(num_lixel, num_jobs, photons_per_job);
+    std::vector<cal::LixelStatisticsFiller> jobs(
+        num_jobs,
+        cal::LixelStatisticsFiller(num_lixel, 1, photons_per_job));
+
+    merlict::random::Mt19937 prng(0);
+    for (uint64_t j = 0; j < num_jobs; j++) {
+        for (uint64_t i = 0; i < photons_per_job; i++) {
+            plenoscope::CalibrationPhotonResult result;
+            result.reached_sensor = prng.uniform() > 0.3;
+            // the last lixel is never hit to test sparse records.
+            result.lixel_id = (num_lixel - 1)*prng.uniform();
+            result.x_pos_on_principal_aperture = prng.uniform();
+            result.y_pos_on_principal_aperture = prng.uniform();
+            result.x_tilt_vs_optical_axis = prng.uniform();
+            result.y_tilt_vs_optical_axis = prng.uniform();
+            result.time_of_flight = prng.uniform();
+            all.fill(result);
+            jobs.at(j).fill(result);
+        }
+        std::stringstream path;
+        path << "merlict_portal_plenoscope/tests/resources/";
+        path << "partial_lixel_statistics_" << j << ".bin.tmp";
+        cal::write_partial(
+            jobs.at(j).online_lixel_statistics(),
+            photons_per_job,
+            path.str());
+    }
+
+    uint64_t num_photons_emitted = 0;
+    std::vector<cal::OnlineLixelStatistics> merged_stats(num_lixel);
+    for (uint64_t j = 0; j < num_jobs; j++) {
+        std::stringstream path;
+        path << "merlict_portal_plenoscope/tests/resources/";
+        path << "partial_lixel_statistics_" << j << ".bin.tmp";
+        const cal::PartialLixelStatistics partial = cal::read_partial(
+            path.str());
+        CHECK(partial.num_photons_emitted == photons_per_job);
+        REQUIRE(partial.lixel_stats.size() == num_lixel);
+        CHECK(partial.lixel_stats.at(num_lixel - 1).count == 0u);
+        num_photons_emitted += partial.num_photons_emitted;
+        for (uint64_t i = 0; i < num_lixel; i++)
+            merged_stats.at(i).merge(partial.lixel_stats.at(i));
+    }
+
+    cal::LixelStatisticsFiller merged_filler(
+        num_lixel,
+        1,
+        num_photons_emitted);
+    merged_filler.merge(merged_stats);
+
+    const std::vector<cal::LixelStatistic> expected =
+        all.get_lixel_statistics();
+    const std::vector<cal::LixelStatistic> merged =
+        merged_filler.get_lixel_statistics();
+    REQUIRE(merged.size() == num_lixel);
+    for (uint64_t i = 0; i < num_lixel - 1; i++) {
+        CHECK(merged.at(i).efficiency == Approx(expected.at(i).efficiency));
+        CHECK(merged.at(i).cx_mean == Approx(expected.at(i).cx_mean));
+        CHECK(merged.at(i).cx_std == Approx(expected.at(i).cx_std));
+        CHECK(merged.at(i).x_mean == Approx(expected.at(i).x_mean));
+        CHECK(merged.at(i).y_std == Approx(expected.at(i).y_std));
+        CHECK(
+            merged.at(i).time_delay_std ==
+            Approx(expected.at(i).time_delay_std));
+    }
+    CHECK(merged.at(num_lixel - 1).efficiency == 0.0);
+}
+
+TEST_CASE("PlenoscopeLixelStatisticsTest: partial_file_wrong_magic", "[merlict]") {
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/"
+        "partial_lixel_statistics_wrong_magic.bin.tmp";
+    std::ofstream file(path, std::ios::binary);
+    const uint64_t zeros[4] = {0, 0, 0, 0};
+    file.write(reinterpret_cast<const char*>(zeros), sizeof(zeros));
+    file.close();
+    CHECK_THROWS_AS(
+        plenoscope::calibration::read_partial(path),
+        std::runtime_error);
+}
+
+TEST_CASE("PlenoscopeLixelStatisticsTest: partial_file_other_version", "[merlict]") {
+    namespace cal = plenoscope::calibration;
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/"
+        "partial_lixel_statistics_other_version.bin.tmp";
+    std::ofstream file(path, std::ios::binary);
+    const uint32_t magic_and_version[2] = {
+        cal::PARTIAL_LIXEL_STATISTICS_MAGIC,
+        cal::PARTIAL_LIXEL_STATISTICS_VERSION - 1u};
+    const uint64_t zeros[3] = {0, 0, 0};
+    file.write(
+        reinterpret_cast<const char*>(magic_and_version),
+        sizeof(magic_and_version));
+    file.write(reinterpret_cast<const char*>(zeros), sizeof(zeros));
+    file.close();
+    CHECK_THROWS_AS(cal::read_partial(path), std::runtime_error);
+}
+
+TEST_CASE("PlenoscopeLixelStatisticsTest: columnar_write_and_read", "[merlict]") {
+    namespace cal = plenoscope::calibration;
+    const unsigned int num_lixels = 1337;
+    std::vector<cal::LixelStatistic> lixel_stats;
+    for (unsigned int i = 0; i < num_lixels; i++) {
+        cal::LixelStatistic stat;
+        float* fields = reinterpret_cast<float*>(&stat);
+        for (unsigned int c = 0; c < cal::NUM_LIXEL_STATISTIC_COLUMNS; c++)
+            fields[c] = i*1000.0 + c;
+        lixel_stats.push_back(stat);
+    }
+
+    std::array<float, 273> info_header;
+    info_header.fill(1.0);
+    const uint64_t hash = cal::geometry_hash(info_header);
+    info_header.at(100) = 2.0;
+    CHECK(hash != cal::geometry_hash(info_header));
+
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/"
+        "my_stats.LixelStatistics.columns.bin.tmp";
+    cal::write_columns(lixel_stats, hash, path);
+    CHECK(cal::is_columnar(path));
+
+    const cal::MappedLixelStatistics mapped(path);
+    CHECK(mapped.num_lixel() == num_lixels);
+    CHECK(mapped.geometry_hash() == hash);
+    const float* cy_std = mapped.column(cal::CY_STD);
+    CHECK(reinterpret_cast<uintptr_t>(cy_std)%cal::LIXEL_STATISTICS_PAGE_SIZE
+        == 0u);
+    for (unsigned int i = 0; i < num_lixels; i++) {
+        CHECK(cy_std[i] == i*1000.0 + 5.0);
+        CHECK(mapped.at(i).time_delay_std == lixel_stats.at(i).time_delay_std);
+    }
+
+    const std::vector<cal::LixelStatistic> lixel_stats_in = cal::read(path);
+    REQUIRE(lixel_stats_in.size() == num_lixels);
+    CHECK(lixel_stats_in.at(42).x_mean == lixel_stats.at(42).x_mean);
+
+    const cal::LixelEfficiencies efficiencies =
+        cal::read_efficiencies(path, hash);
+    REQUIRE(efficiencies.size() == num_lixels);
+    CHECK(efficiencies.is_mapped());
+    CHECK(reinterpret_cast<uintptr_t>(efficiencies.data())%
+        cal::LIXEL_STATISTICS_PAGE_SIZE == 0u);
+    CHECK(efficiencies.at(7) == 7000.0);
+    CHECK_THROWS_AS(
+        cal::read_efficiencies(path, hash + 1u),
+        std::invalid_argument);
+}
+
+TEST_CASE("PlenoscopeLixelStatisticsTest: legacy_layout_is_not_columnar", "[merlict]") {
+    namespace cal = plenoscope::calibration;
+    std::vector<cal::LixelStatistic> lixel_stats(3);
+    lixel_stats.at(2).efficiency = 0.5;
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/"
+        "my_stats.LixelStatistics.legacy.bin.tmp";
+    cal::write(lixel_stats, path);
+    CHECK(!cal::is_columnar(path));
+    const cal::LixelEfficiencies efficiencies =
+        cal::read_efficiencies(path, 0u);
+    REQUIRE(efficiencies.size() == 3u);
+    CHECK(!efficiencies.is_mapped());
+    CHECK(efficiencies.at(2) == 0.5);
+}
@@ -0,0 +1,187 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict/tests/catch.hpp"
+#include "merlict_portal_plenoscope/calibration/ResponseTable.h"
+#include "merlict_portal_plenoscope/light_field_sensor/Config.h"
+#include "merlict_portal_plenoscope/night_sky_background/NightSkyBackground.h"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+namespace cal = plenoscope::calibration;
+namespace sp = signal_processing;
+
+
+TEST_CASE("ResponseTableTest: binning", "[merlict]") {
+    const cal::ResponseTableBinning binning(8u, 2u, 10.0, 0.1);
+    CHECK(binning.size() == 8u*8u*2u*2u);
+    CHECK(binning.xy_bin_width() == Approx(2.5));
+    CHECK(binning.c_bin_width() == Approx(sin(0.1)));
+
+    CHECK(binning.bin(11.0, 0.0, 0.0, 0.0) == binning.size());
+    CHECK(binning.bin(0.0, 0.0, 0.0, -0.2) == binning.size());
+
+    for (uint64_t b = 0; b < binning.size(); b++) {
+        double x, y, cx, cy;
+        binning.lower_edges(b, &x, &y, &cx, &cy);
+        CHECK(binning.bin(
+            x + 0.5*binning.xy_bin_width(),
+            y + 0.5*binning.xy_bin_width(),
+            cx + 0.5*binning.c_bin_width(),
+            cy + 0.5*binning.c_bin_width()) == b);
+    }
+
+    // The corner bins of the aperture do not overlap its disc.
+    CHECK(!binning.overlaps_aperture_and_field_of_view(
+        binning.bin(-9.9, -9.9, 0.0, 0.0)));
+    CHECK(binning.overlaps_aperture_and_field_of_view(
+        binning.bin(-4.9, -4.9, 0.0, 0.0)));
+
+    CHECK_THROWS_AS(
+        cal::ResponseTableBinning(0u, 2u, 10.0, 0.1),
+        std::invalid_argument);
+}
+
+TEST_CASE("ResponseTableTest: draw", "[merlict]") {
+    const cal::ResponseTableBinning binning(1u, 1u, 1.0, 0.1);
+    cal::ResponseTable table(binning, 42u, 3u, 100u);
+    std::vector<cal::ResponseEntry> entries(2);
+    entries[0].lixel = 0u;
+    entries[0].probability = 0.25;
+    entries[0].time_delay = 1e-9;
+    entries[1].lixel = 2u;
+    entries[1].probability = 0.5;
+    entries[1].time_delay = 2e-9;
+    table.append_bin(entries);
+    CHECK(table.num_bins_appended() == 1u);
+    CHECK(table.efficiency(0u) == Approx(0.75));
+    CHECK_THROWS_AS(table.append_bin(entries), std::out_of_range);
+
+    uint32_t lixel;
+    double time_delay;
+    CHECK(table.draw(0u, 0.1, &lixel, &time_delay));
+    CHECK(lixel == 0u);
+    CHECK(time_delay == Approx(1e-9));
+    CHECK(table.draw(0u, 0.5, &lixel, &time_delay));
+    CHECK(lixel == 2u);
+    CHECK(time_delay == Approx(2e-9));
+    CHECK(!table.draw(0u, 0.8, &lixel, &time_delay));
+}
+
+TEST_CASE("ResponseTableTest: write_and_read", "[merlict]") {
+    const cal::ResponseTableBinning binning(2u, 3u, 5.0, 0.05);
+    cal::ResponseTable table(binning, 1337u, 10u, 1000u);
+    for (uint64_t b = 0; b < binning.size(); b++) {
+        std::vector<cal::ResponseEntry> entries(b%3);
+        for (uint64_t e = 0; e < entries.size(); e++) {
+            entries[e].lixel = (b + e)%10u;
+            entries[e].probability = 0.1*e;
+            entries[e].time_delay = 1e-9*b;
+        }
+        table.append_bin(entries);
+    }
+
+    const std::string path =
+        "merlict_portal_plenoscope/tests/resources/response_table.bin.tmp";
+    cal::write_response_table(table, path);
+
+    const cal::ResponseTable back = cal::read_response_table(path, 1337u);
+    CHECK(back.binning.num_bins_xy == 2u);
+    CHECK(back.binning.num_bins_c == 3u);
+    CHECK(back.binning.aperture_radius == 5.0);
+    CHECK(back.binning.max_incident_angle == 0.05);
+    CHECK(back.num_lixel == 10u);
+    CHECK(back.num_photons_per_bin == 1000u);
+    REQUIRE(back.bin_begin == table.bin_begin);
+    REQUIRE(back.entries.size() == table.entries.size());
+    for (uint64_t e = 0; e < table.entries.size(); e++) {
+        CHECK(back.entries[e].lixel == table.entries[e].lixel);
+        CHECK(back.entries[e].probability == table.entries[e].probability);
+        CHECK(back.entries[e].time_delay == table.entries[e].time_delay);
+    }
+
+    CHECK_THROWS_AS(
+        cal::read_response_table(path, 1336u),
+        std::invalid_argument);
+
+    cal::ResponseTable incomplete(binning, 1337u, 10u, 1000u);
+    CHECK_THROWS_AS(
+        cal::write_response_table(incomplete, path),
+        std::logic_error);
+}
+
+TEST_CASE("ResponseTableTest: inject_nsb", "[merlict]") {
+    plenoscope::light_field_sensor::Config config;
+    config.expected_imaging_system_focal_length = 75.0;
+    config.expected_imaging_system_max_aperture_radius = 25.0;
+    config.max_FoV_diameter = ml::deg2rad(6.5);
+    config.pixel_FoV_hex_flat2flat = ml::deg2rad(0.1);
+    config.num_paxel_on_pixel_diagonal = 13;
+    config.housing_overhead = 1.2;
+    config.lens_refraction = &plenoscope::light_field_sensor::pmma_refraction;
+    plenoscope::light_field_sensor::Geometry geometry(config);
+
+    ml::function::Func1 flux_vs_wavelength(
+        ml::tsvio::gen_table_from_file(
+            "merlict_portal_plenoscope/"
+            "tests/"
+            "resources/"
+            "night_sky_background_flux_vs_wavelength_la_palma.txt"));
+    plenoscope::night_sky_background::Light nsb(
+        &geometry,
+        &flux_vs_wavelength);
+    nsb.rate = 1e10;
+    const double exposure_time = 1e-6;
+
+    // Photons with x < 0 are absorbed in lixel 0, the others in lixel 1
+    // with a probability of one half.
+    const cal::ResponseTableBinning binning(
+        2u,
+        1u,
+        nsb.aperture_radius,
+        nsb.fov_radius);
+    cal::ResponseTable table(binning, 0u, 2u, 1u);
+    std::vector<cal::ResponseEntry> left(1);
+    left[0].lixel = 0u;
+    left[0].probability = 1.0;
+    left[0].time_delay = 0.5*exposure_time;
+    std::vector<cal::ResponseEntry> right(1);
+    right[0].lixel = 1u;
+    right[0].probability = 0.5;
+    right[0].time_delay = 0.0;
+    table.append_bin(left);
+    table.append_bin(left);
+    table.append_bin(right);
+    table.append_bin(right);
+
+    std::vector<std::vector<sp::PipelinePhoton>> pipelines(2);
+    double exposure_start_time;
+    ml::random::Mt19937 prng(0u);
+    plenoscope::night_sky_background::
+        inject_nsb_by_response_table_into_photon_pipeline(
+            &pipelines,
+            exposure_time,
+            &table,
+            &nsb,
+            &exposure_start_time,
+            &prng);
+
+    const double expected = nsb.rate*exposure_time;
+    CHECK(pipelines[0].size() == Approx(0.5*expected).margin(300));
+    CHECK(pipelines[1].size() == Approx(0.25*expected).margin(300));
+    for (const std::vector<sp::PipelinePhoton> &pipeline : pipelines) {
+        for (const sp::PipelinePhoton &ph : pipeline) {
+            CHECK(ph.arrival_time >= 0.0);
+            CHECK(ph.arrival_time < exposure_time);
+        }
+    }
+
+    std::vector<std::vector<sp::PipelinePhoton>> too_many(3);
+    CHECK_THROWS_AS(
+        plenoscope::night_sky_background::
+            inject_nsb_by_response_table_into_photon_pipeline(
+                &too_many,
+                exposure_time,
+                &table,
+                &nsb,
+                &exposure_start_time,
+                &prng),
+        std::invalid_argument);
+}
@@ -26,6 +26,11 @@ Converter::Converter(const Config* config) {
         info << "\n";
         throw std::invalid_argument(info.str());
     }
+
+    const ml::function::UniformGrid &grid = ml::function::WAVELENGTH_GRID;
+    if (grid.is_covered_by(*config->quantum_efficiency_vs_wavelength))
+        quantum_efficiency_table = grid.sample(
+            *config->quantum_efficiency_vs_wavelength);
 }
 
 std::vector<ElectricPulse> Converter::get_pulse_pipeline_for_photon_pipeline(
@@ -34,19 +39,32 @@ std::vector<ElectricPulse> Converter::get_pulse_pipeline_for_photon_pipeline(
     ml::random::Generator* prng
 ) {
     std::vector<ElectricPulse> electric_pipeline;
+    get_pulse_pipeline_for_photon_pipeline(
+        photon_pipeline,
+        exposure_time,
+        prng,
+        &electric_pipeline);
+    return electric_pipeline;
+}
+
+void Converter::get_pulse_pipeline_for_photon_pipeline(
+    const std::vector<PipelinePhoton> &photon_pipeline,
+    const double exposure_time,
+    ml::random::Generator* prng,
+    std::vector<ElectricPulse> *electric_pipeline
+) {
+    electric_pipeline->clear();
     for (const PipelinePhoton &ph : photon_pipeline) {
         if (
-            config->quantum_efficiency_vs_wavelength->evaluate(ph.wavelength) >=
-            prng->uniform()
+            quantum_efficiency(ph.wavelength) >= prng->uniform()
         ) {
             const ElectricPulse converted_photon(
                 ph.arrival_time,
                 ph.simulation_truth_id);
-            add_pulse(converted_photon, &electric_pipeline, prng);
+            add_pulse(converted_photon, electric_pipeline, prng);
         }
     }
-    add_accidental_pulse(&electric_pipeline, exposure_time, prng);
-    return electric_pipeline;
+    add_accidental_pulse(electric_pipeline, exposure_time, prng);
 }
 
 void Converter::add_pulse(
@@ -86,5 +104,19 @@ void Converter::add_accidental_pulse(
     }
 }
 
+double Converter::quantum_efficiency(const double wavelength)const {
+    if (
+        quantum_efficiency_table.empty() ||
+        !ml::function::WAVELENGTH_GRID.contains(wavelength)
+    )
+        return config->quantum_efficiency_vs_wavelength->evaluate(wavelength);
+    double weight;
+    const uint32_t i = ml::function::WAVELENGTH_GRID.bin(wavelength, &weight);
+    return ml::function::UniformGrid::interpolate(
+        quantum_efficiency_table[i],
+        quantum_efficiency_table[i + 1],
+        weight);
+}
+
 }  // namespace PhotoElectricConverter
 }  // namespace signal_processing
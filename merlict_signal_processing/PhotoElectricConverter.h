@@ -26,6 +26,10 @@ static const merlict::function::Func1 zero_efficiency(
 
 class Converter {
     const Config* config;
+    // The quantum efficiency sampled on the function::WAVELENGTH_GRID, or
+    // empty when it does not cover the grid. Wavelengths outside of the grid
+    // are evaluated directly.
+    std::vector<double> quantum_efficiency_table;
 
  public:
     explicit Converter(const Config* config);
@@ -33,6 +37,11 @@ class Converter {
         const std::vector<PipelinePhoton> &photon_pipeline,
         const double exposure_time,
         merlict::random::Generator* prng);
+    void get_pulse_pipeline_for_photon_pipeline(
+        const std::vector<PipelinePhoton> &photon_pipeline,
+        const double exposure_time,
+        merlict::random::Generator* prng,
+        std::vector<ElectricPulse> *electric_pipeline);
     void add_pulse(
         const ElectricPulse &pulse,
         std::vector<ElectricPulse> *electric_pipeline,
@@ -41,6 +50,7 @@ class Converter {
         std::vector<ElectricPulse> *electric_pipeline,
         const double exposure_time,
         merlict::random::Generator* prng)const;
+    double quantum_efficiency(const double wavelength)const;
 };
 
 }  // namespace PhotoElectricConverter
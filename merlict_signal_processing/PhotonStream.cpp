@@ -1,9 +1,11 @@
 // Copyright 2016 Sebastian A. Mueller
 #include "merlict_signal_processing/PhotonStream.h"
 #include <math.h>
+#include <string.h>
 #include <sstream>
 #include <fstream>
 #include "merlict_signal_processing/pulse_extraction.h"
+#include "merlict_signal_processing/simulation_truth.h"
 #include "merlict/merlict.h"
 namespace ml = merlict;
 
@@ -15,55 +17,319 @@ Stream::Stream() {
     time_slice_duration = 0.0;
 }
 
-void write(
-    const std::vector<std::vector<ExtractedPulse>> &channels,
+FlatStream::FlatStream() {
+    time_slice_duration = 0.0;
+    channel_begin.push_back(0u);
+}
+
+uint64_t FlatStream::num_channels()const {
+    return channel_begin.size() - 1u;
+}
+
+SparsePulse::SparsePulse():
+    channel(0u),
+    arrival_time_slice(0u),
+    simulation_truth_id(DEFAULT_SIMULATION_TRUTH)
+{}
+
+SparsePulse::SparsePulse(
+    const uint32_t _channel,
+    const uint8_t _arrival_time_slice,
+    const int32_t _simulation_truth_id
+):
+    channel(_channel),
+    arrival_time_slice(_arrival_time_slice),
+    simulation_truth_id(_simulation_truth_id)
+{}
+
+SparseStream::SparseStream() {
+    num_channels = 0u;
+    time_slice_duration = 0.0;
+}
+
+namespace {
+
+uint8_t first_reserved_symbol(const uint16_t compression) {
+    if (compression == NO_COMPRESSION) {
+        return NEXT_CHANNEL_MARKER;
+    } else if (compression == RUN_LENGTH_COMPRESSION) {
+        return RUN_MARKER;
+    } else {
+        std::stringstream info;
+        info << "PhotonStream\n";
+        info << "Unknown compression " << compression << "\n";
+        throw std::invalid_argument(info.str());
+    }
+}
+
+void append_channel_markers(
+    uint64_t num_markers,
+    const uint16_t compression,
+    std::vector<uint8_t> *buffer
+) {
+    if (compression == RUN_LENGTH_COMPRESSION) {
+        while (num_markers >= 3u) {
+            const uint8_t run = num_markers > 255u ? 255u : num_markers;
+            buffer->push_back(RUN_MARKER);
+            buffer->push_back(run);
+            num_markers -= run;
+        }
+    }
+    buffer->insert(buffer->end(), num_markers, NEXT_CHANNEL_MARKER);
+}
+
+void append_arrival_time_slice(
+    const uint8_t arrival_time_slice,
+    const uint8_t first_reserved,
+    std::vector<uint8_t> *buffer
+) {
+    if (arrival_time_slice >= first_reserved) {
+        std::stringstream info;
+        info << "PhotonStream::encode\n";
+        info << "Expected arrival slice of photon < ";
+        info << static_cast<int>(first_reserved);
+        info << ", but actual it is ";
+        info << static_cast<int>(arrival_time_slice) << "\n";
+        throw std::runtime_error(info.str());
+    }
+    buffer->push_back(arrival_time_slice);
+}
+
+// Expects the symbols to be appended already after HEADER_SIZE bytes.
+void fill_header(
     const float time_slice_duration,
-    const std::string path
+    const uint32_t num_channels,
+    const uint16_t compression,
+    std::vector<uint8_t> *buffer
 ) {
-    const uint32_t num_channels = channels.size();
-    const uint32_t num_symbols = num_symbols_to_represent(channels);
+    const uint32_t num_time_slices_and_compression =
+        static_cast<uint32_t>(NUMBER_TIME_SLICES) |
+        (static_cast<uint32_t>(compression) << 16);
+    const uint32_t num_symbols = buffer->size() - HEADER_SIZE;
+    memcpy(&(*buffer)[0], &time_slice_duration, 4u);
+    memcpy(&(*buffer)[4], &num_channels, 4u);
+    memcpy(&(*buffer)[8], &num_time_slices_and_compression, 4u);
+    memcpy(&(*buffer)[12], &num_symbols, 4u);
+}
 
-    std::ofstream file;
-    file.open(path, std::ios::binary);
+struct Header {
+    float time_slice_duration;
+    uint32_t num_channels;
+    uint16_t compression;
+    uint32_t num_symbols;
+};
 
-    if (!file.is_open()) {
+Header decode_header(const uint8_t* data, const uint64_t size) {
+    if (size < HEADER_SIZE) {
         std::stringstream info;
-        info << "Can not write file '" << path << "'.\n";
+        info << "PhotonStream::decode\n";
+        info << "Expected at least " << HEADER_SIZE << " bytes for header, ";
+        info << "but actual there are " << size << "\n";
+        throw std::runtime_error(info.str());
+    }
+
+    Header header;
+    uint32_t num_time_slices_and_compression;
+    memcpy(&header.time_slice_duration, &data[0], 4u);
+    memcpy(&header.num_channels, &data[4], 4u);
+    memcpy(&num_time_slices_and_compression, &data[8], 4u);
+    memcpy(&header.num_symbols, &data[12], 4u);
+
+    const uint32_t num_time_slices =
+        num_time_slices_and_compression & 0xFFFF;
+    header.compression = num_time_slices_and_compression >> 16;
+
+    if (num_time_slices != NUMBER_TIME_SLICES) {
+        std::stringstream info;
+        info << "PhotonStream::decode\n";
+        info << "Expected num_time_slices == " << NUMBER_TIME_SLICES;
+        info << ", but actual it is " << num_time_slices << "\n";
+        throw std::runtime_error(info.str());
+    }
+    if (header.compression != NO_COMPRESSION &&
+        header.compression != RUN_LENGTH_COMPRESSION
+    ) {
+        std::stringstream info;
+        info << "PhotonStream::decode\n";
+        info << "Unknown compression " << header.compression << "\n";
+        throw std::runtime_error(info.str());
+    }
+    if (size < HEADER_SIZE + header.num_symbols) {
+        std::stringstream info;
+        info << "PhotonStream::decode\n";
+        info << "Expected " << header.num_symbols << " symbols, ";
+        info << "but actual there are " << size - HEADER_SIZE << "\n";
         throw std::runtime_error(info.str());
     }
+    return header;
+}
 
-    // PhotonStream Header 16 byte
-    // -------------------
-    ml::append_float32(time_slice_duration, file);
-    ml::append_uint32(num_channels, file);
-    ml::append_uint32(NUMBER_TIME_SLICES, file);
-    ml::append_uint32(num_symbols, file);
+// Calls on_markers(n) for n consecutive NEXT_CHANNEL_MARKERs and
+// on_slice(s) for each arrival time slice s.
+template<typename OnMarkers, typename OnSlice>
+void decode_symbols(
+    const uint8_t* data,
+    const Header &header,
+    OnMarkers on_markers,
+    OnSlice on_slice
+) {
+    uint64_t num_markers = 0u;
+    const uint8_t* symbols = data + HEADER_SIZE;
+    for (uint32_t i = 0; i < header.num_symbols; i++) {
+        const uint8_t symbol = symbols[i];
+        if (symbol == NEXT_CHANNEL_MARKER) {
+            on_markers(1u);
+            num_markers++;
+        } else if (
+            header.compression == RUN_LENGTH_COMPRESSION &&
+            symbol == RUN_MARKER
+        ) {
+            i++;
+            const uint8_t run = i < header.num_symbols ? symbols[i] : 0u;
+            on_markers(run);
+            num_markers += run;
+        } else {
+            on_slice(symbol);
+        }
+    }
+    const uint64_t num_channels = header.num_channels > 0 ?
+        num_markers + 1u : num_markers;
+    if (num_channels != header.num_channels) {
+        std::stringstream info;
+        info << "PhotonStream::decode\n";
+        info << "Expected " << header.num_channels << " channels, ";
+        info << "but actual there are " << num_channels << "\n";
+        throw std::runtime_error(info.str());
+    }
+}
+
+}  // namespace
+
+std::vector<uint8_t> encode(
+    const std::vector<std::vector<ExtractedPulse>> &channels,
+    const float time_slice_duration,
+    const uint16_t compression
+) {
+    const uint8_t first_reserved = first_reserved_symbol(compression);
+    const uint32_t num_channels = channels.size();
 
-    // Pulses
-    // ------
+    std::vector<uint8_t> buffer;
+    buffer.reserve(HEADER_SIZE + num_symbols_to_represent(channels));
+    buffer.resize(HEADER_SIZE);
+
+    uint64_t pending_markers = 0u;
     for (uint64_t ch = 0; ch < num_channels; ch++) {
-        for (uint64_t pu = 0; pu < channels.at(ch).size(); pu++) {
-            if (
-                channels.at(ch).at(pu).arrival_time_slice ==
-                NEXT_CHANNEL_MARKER
-            ) {
-                std::stringstream info;
-                info << "PhotonStream::write(" << path << ")\n";
-                info << "Expected arrival slice of photon != ";
-                info << "NEXT_CHANNEL_MARKER\n";
-                throw std::runtime_error(info.str());
-            }
-            ml::append_uint8(channels.at(ch).at(pu).arrival_time_slice, file);
+        if (ch > 0)
+            pending_markers++;
+        if (channels.at(ch).size() == 0)
+            continue;
+        append_channel_markers(pending_markers, compression, &buffer);
+        pending_markers = 0u;
+        for (const ExtractedPulse &pulse : channels.at(ch))
+            append_arrival_time_slice(
+                pulse.arrival_time_slice,
+                first_reserved,
+                &buffer);
+    }
+    append_channel_markers(pending_markers, compression, &buffer);
+
+    fill_header(time_slice_duration, num_channels, compression, &buffer);
+    return buffer;
+}
+
+std::vector<uint8_t> encode(
+    const SparseStream &sparse,
+    const uint16_t compression
+) {
+    const uint8_t first_reserved = first_reserved_symbol(compression);
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(HEADER_SIZE + 2u*sparse.pulses.size() + 1u);
+    buffer.resize(HEADER_SIZE);
+
+    uint32_t channel = 0u;
+    for (const SparsePulse &pulse : sparse.pulses) {
+        if (pulse.channel < channel || pulse.channel >= sparse.num_channels) {
+            std::stringstream info;
+            info << "PhotonStream::encode\n";
+            info << "Expected sparse pulses to be sorted by channel and ";
+            info << "channel < " << sparse.num_channels << ", ";
+            info << "but found channel " << pulse.channel;
+            info << " after channel " << channel << "\n";
+            throw std::runtime_error(info.str());
         }
-        if (ch < num_channels-1)
-            ml::append_uint8(NEXT_CHANNEL_MARKER, file);
+        append_channel_markers(pulse.channel - channel, compression, &buffer);
+        channel = pulse.channel;
+        append_arrival_time_slice(
+            pulse.arrival_time_slice,
+            first_reserved,
+            &buffer);
     }
+    if (sparse.num_channels > 0)
+        append_channel_markers(
+            sparse.num_channels - 1u - channel,
+            compression,
+            &buffer);
 
-    file.close();
+    fill_header(
+        sparse.time_slice_duration,
+        sparse.num_channels,
+        compression,
+        &buffer);
+    return buffer;
 }
 
-void write_simulation_truth(
-    const std::vector<std::vector<ExtractedPulse>> &channels,
+FlatStream decode(const uint8_t* data, const uint64_t size) {
+    const Header header = decode_header(data, size);
+
+    FlatStream stream;
+    stream.time_slice_duration = header.time_slice_duration;
+    stream.channel_begin.reserve(header.num_channels + 1u);
+    stream.arrival_time_slices.reserve(header.num_symbols);
+
+    decode_symbols(
+        data,
+        header,
+        [&stream](const uint64_t num_markers) {
+            stream.channel_begin.insert(
+                stream.channel_begin.end(),
+                num_markers,
+                stream.arrival_time_slices.size());
+        },
+        [&stream](const uint8_t slice) {
+            stream.arrival_time_slices.push_back(slice);
+        });
+
+    if (header.num_channels > 0)
+        stream.channel_begin.push_back(stream.arrival_time_slices.size());
+    return stream;
+}
+
+SparseStream decode_sparse(const uint8_t* data, const uint64_t size) {
+    const Header header = decode_header(data, size);
+
+    SparseStream stream;
+    stream.time_slice_duration = header.time_slice_duration;
+    stream.num_channels = header.num_channels;
+
+    uint32_t channel = 0u;
+    decode_symbols(
+        data,
+        header,
+        [&channel](const uint64_t num_markers) {
+            channel += num_markers;
+        },
+        [&stream, &channel](const uint8_t slice) {
+            stream.pulses.emplace_back(
+                SparsePulse(channel, slice, DEFAULT_SIMULATION_TRUTH));
+        });
+    return stream;
+}
+
+namespace {
+
+void write_buffer(
+    const std::vector<uint8_t> &buffer,
     const std::string path
 ) {
     std::ofstream file;
@@ -75,100 +341,217 @@ void write_simulation_truth(
         throw std::runtime_error(info.str());
     }
 
-    for (uint32_t ch = 0; ch < channels.size(); ch++) {
-        for (uint32_t pu = 0; pu < channels.at(ch).size(); pu++) {
-            ml::append_int32(
-                channels.at(ch).at(pu).simulation_truth_id,
-                file);
-        }
-    }
-
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
     file.close();
 }
 
-Stream read(const std::string path) {
-    Stream stream;
-
-    std::ifstream file;
+void write_truth_buffer(
+    const std::vector<int32_t> &truth,
+    const std::string path
+) {
+    std::ofstream file;
     file.open(path, std::ios::binary);
 
     if (!file.is_open()) {
         std::stringstream info;
-        info << __FILE__ << " " << __LINE__ << "\n";
-        info << "PhotonStream: Unable to open file: '" << path << "'\n";
-        throw std::runtime_error(info.str());}
-
-    stream.time_slice_duration = ml::read_float32(file);
-    ml::read_uint32(file);
-    uint32_t num_time_slices = ml::read_uint32(file);
-    if (num_time_slices != NUMBER_TIME_SLICES) {
-        std::stringstream info;
-        info << "PhotonStream::read(" << path << ")\n";
-        info << "Expected num_time_slices == " << NUMBER_TIME_SLICES;
-        info << ", but actual it is " << num_time_slices << "\n";
+        info << "Can not write file '" << path << "'.\n";
         throw std::runtime_error(info.str());
     }
-    uint32_t num_symbols = ml::read_uint32(file);
 
-    if (num_symbols > 0) {
-        std::vector<ExtractedPulse> first_channel;
-        stream.photon_stream.push_back(first_channel);
+    file.write(
+        reinterpret_cast<const char*>(truth.data()),
+        truth.size()*sizeof(int32_t));
+    file.close();
+}
+
+std::vector<int32_t> read_simulation_truth(
+    const std::string truth_path,
+    const uint64_t num_pulses
+) {
+    ml::MemoryMap map(truth_path);
+    if (map.size() < num_pulses*sizeof(int32_t)) {
+        std::stringstream info;
+        info << __FILE__ << ", " << __LINE__ << "\n";
+        info << "PhotonStream: Expected " << num_pulses << " truth ids ";
+        info << "in file '" << truth_path << "'\n";
+        throw std::runtime_error(info.str());
     }
+    std::vector<int32_t> truth(num_pulses);
+    if (num_pulses > 0)
+        memcpy(truth.data(), map.data(), num_pulses*sizeof(int32_t));
+    return truth;
+}
 
-    uint32_t channel = 0;
-    for (uint32_t i = 0; i < num_symbols; i++) {
-        uint8_t symbol = ml::read_uint8(file);
-        if (symbol == NEXT_CHANNEL_MARKER) {
-            channel++;
-            if (i < num_symbols) {
-                std::vector<ExtractedPulse> next_channel;
-                stream.photon_stream.push_back(next_channel);
-            }
-        } else {
+Stream to_stream(const FlatStream &flat) {
+    const bool has_truth = flat.simulation_truth_ids.size() ==
+        flat.arrival_time_slices.size();
+    Stream stream;
+    stream.time_slice_duration = flat.time_slice_duration;
+    stream.photon_stream.resize(flat.num_channels());
+    for (uint64_t ch = 0; ch < flat.num_channels(); ch++) {
+        std::vector<ExtractedPulse> &channel = stream.photon_stream.at(ch);
+        channel.reserve(flat.channel_begin[ch + 1] - flat.channel_begin[ch]);
+        for (
+            uint64_t p = flat.channel_begin[ch];
+            p < flat.channel_begin[ch + 1];
+            p++
+        ) {
             ExtractedPulse pulse;
-            pulse.arrival_time_slice = symbol;
-            stream.photon_stream.at(channel).push_back(pulse);
+            pulse.arrival_time_slice = flat.arrival_time_slices[p];
+            if (has_truth)
+                pulse.simulation_truth_id = flat.simulation_truth_ids[p];
+            channel.push_back(pulse);
         }
     }
+    return stream;
+}
 
-    file.close();
+}  // namespace
+
+void write(
+    const std::vector<std::vector<ExtractedPulse>> &channels,
+    const float time_slice_duration,
+    const std::string path,
+    const uint16_t compression
+) {
+    std::vector<uint8_t> buffer;
+    try {
+        buffer = encode(channels, time_slice_duration, compression);
+    } catch (std::exception &error) {
+        std::stringstream info;
+        info << "PhotonStream::write(" << path << ")\n";
+        info << error.what();
+        throw std::runtime_error(info.str());
+    }
+    write_buffer(buffer, path);
+}
 
+void write(
+    const SparseStream &sparse,
+    const std::string path,
+    const uint16_t compression
+) {
+    std::vector<uint8_t> buffer;
+    try {
+        buffer = encode(sparse, compression);
+    } catch (std::exception &error) {
+        std::stringstream info;
+        info << "PhotonStream::write(" << path << ")\n";
+        info << error.what();
+        throw std::runtime_error(info.str());
+    }
+    write_buffer(buffer, path);
+}
+
+void write_simulation_truth(
+    const std::vector<std::vector<ExtractedPulse>> &channels,
+    const std::string path
+) {
+    std::vector<int32_t> truth;
+    truth.reserve(num_pulses(channels));
+    for (uint32_t ch = 0; ch < channels.size(); ch++)
+        for (uint32_t pu = 0; pu < channels.at(ch).size(); pu++)
+            truth.push_back(channels.at(ch).at(pu).simulation_truth_id);
+    write_truth_buffer(truth, path);
+}
+
+void write_simulation_truth(
+    const SparseStream &sparse,
+    const std::string path
+) {
+    std::vector<int32_t> truth;
+    truth.reserve(sparse.pulses.size());
+    for (const SparsePulse &pulse : sparse.pulses)
+        truth.push_back(pulse.simulation_truth_id);
+    write_truth_buffer(truth, path);
+}
+
+FlatStream read_flat(const std::string path) {
+    ml::MemoryMap map(path);
+    try {
+        return decode(map.data(), map.size());
+    } catch (std::exception &error) {
+        std::stringstream info;
+        info << "PhotonStream::read(" << path << ")\n";
+        info << error.what();
+        throw std::runtime_error(info.str());
+    }
+}
+
+FlatStream read_flat_with_simulation_truth(
+    const std::string path,
+    const std::string truth_path
+) {
+    FlatStream stream = read_flat(path);
+    stream.simulation_truth_ids = read_simulation_truth(
+        truth_path,
+        stream.arrival_time_slices.size());
     return stream;
 }
 
+Stream read(const std::string path) {
+    return to_stream(read_flat(path));
+}
+
 Stream read_with_simulation_truth(
     const std::string path,
     const std::string truth_path
 ) {
-    Stream stream = read(path);
+    return to_stream(read_flat_with_simulation_truth(path, truth_path));
+}
 
-    std::ifstream file;
-    file.open(truth_path, std::ios::binary);
-    if (!file.is_open()) {
+SparseStream read_sparse(const std::string path) {
+    ml::MemoryMap map(path);
+    try {
+        return decode_sparse(map.data(), map.size());
+    } catch (std::exception &error) {
         std::stringstream info;
-        info << __FILE__ << " " << __LINE__ << "\n";
-        info << "PhotonStream: Unable to open file: '" << truth_path << "'\n";
-        throw std::runtime_error(info.str());}
-
-    for (
-        uint32_t channel = 0;
-        channel < stream.photon_stream.size();
-        channel++
-    ) {
-        for (
-            uint32_t pulse = 0;
-            pulse < stream.photon_stream.at(channel).size();
-            pulse++
-        ) {
-            stream.photon_stream.at(channel).at(pulse).simulation_truth_id =
-                ml::read_int32(file);
-        }
+        info << "PhotonStream::read_sparse(" << path << ")\n";
+        info << error.what();
+        throw std::runtime_error(info.str());
     }
+}
 
-    file.close();
+SparseStream read_sparse_with_simulation_truth(
+    const std::string path,
+    const std::string truth_path
+) {
+    SparseStream stream = read_sparse(path);
+    const std::vector<int32_t> truth = read_simulation_truth(
+        truth_path,
+        stream.pulses.size());
+    for (uint64_t p = 0; p < stream.pulses.size(); p++)
+        stream.pulses[p].simulation_truth_id = truth[p];
     return stream;
 }
 
+SparseStream to_sparse(const Stream &dense) {
+    SparseStream sparse;
+    sparse.time_slice_duration = dense.time_slice_duration;
+    sparse.num_channels = dense.photon_stream.size();
+    sparse.pulses.reserve(num_pulses(dense.photon_stream));
+    for (uint32_t ch = 0; ch < dense.photon_stream.size(); ch++)
+        for (const ExtractedPulse &pulse : dense.photon_stream.at(ch))
+            sparse.pulses.emplace_back(
+                SparsePulse(
+                    ch,
+                    pulse.arrival_time_slice,
+                    pulse.simulation_truth_id));
+    return sparse;
+}
+
+Stream to_dense(const SparseStream &sparse) {
+    Stream dense;
+    dense.time_slice_duration = sparse.time_slice_duration;
+    dense.photon_stream.resize(sparse.num_channels);
+    for (const SparsePulse &pulse : sparse.pulses)
+        dense.photon_stream.at(pulse.channel).emplace_back(
+            ExtractedPulse(
+                pulse.arrival_time_slice,
+                pulse.simulation_truth_id));
+    return dense;
+}
+
 uint64_t num_pulses(
     const std::vector<std::vector<ExtractedPulse>> &raw
 ) {
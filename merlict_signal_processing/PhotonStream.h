@@ -11,23 +11,103 @@ namespace signal_processing {
 namespace PhotonStream {
 
 // Write and read ElectricPulses in the very compact photon_stream format.
+//
+// Header 16 byte
+//      float32 time_slice_duration
+//      uint32  num_channels
+//      uint32  num_time_slices | compression << 16
+//      uint32  num_symbols
+// Symbols num_symbols byte
+//
+// Files without compression have compression == 0 and thus look exactly
+// like the original format. With RUN_LENGTH_COMPRESSION, runs of three or
+// more NEXT_CHANNEL_MARKERs, i.e. empty channels, are written as the two
+// symbols RUN_MARKER, run_length. Arrival slices must then be below
+// RUN_MARKER.
 
 const uint8_t NEXT_CHANNEL_MARKER = 255;
+const uint8_t RUN_MARKER = 254;
+const uint64_t HEADER_SIZE = 16u;
+
+const uint16_t NO_COMPRESSION = 0u;
+const uint16_t RUN_LENGTH_COMPRESSION = 1u;
+
+struct Stream {
+    std::vector<std::vector<ExtractedPulse>> photon_stream;
+    float time_slice_duration;
+    Stream();
+};
+
+// Serializes header and symbols of an event into one contiguous buffer.
+std::vector<uint8_t> encode(
+    const std::vector<std::vector<ExtractedPulse>> &pulses,
+    const float time_slice_duration,
+    const uint16_t compression = NO_COMPRESSION);
+
+// The pulses of channel c are at [channel_begin[c], channel_begin[c + 1]).
+// simulation_truth_ids is empty unless it was read explicitly.
+struct FlatStream {
+    float time_slice_duration;
+    std::vector<uint64_t> channel_begin;
+    std::vector<uint8_t> arrival_time_slices;
+    std::vector<int32_t> simulation_truth_ids;
+    FlatStream();
+    uint64_t num_channels()const;
+};
+
+FlatStream decode(const uint8_t* data, const uint64_t size);
+
+// Most channels of a light field event are empty. The sparse representation
+// only holds the pulses, sorted by channel, so its size scales with the
+// number of pulses and not with the number of channels.
+struct SparsePulse {
+    uint32_t channel;
+    uint8_t arrival_time_slice;
+    int32_t simulation_truth_id;
+    SparsePulse();
+    SparsePulse(
+        const uint32_t channel,
+        const uint8_t arrival_time_slice,
+        const int32_t simulation_truth_id);
+};
+
+struct SparseStream {
+    std::vector<SparsePulse> pulses;
+    uint32_t num_channels;
+    float time_slice_duration;
+    SparseStream();
+};
+
+std::vector<uint8_t> encode(
+    const SparseStream &sparse,
+    const uint16_t compression = NO_COMPRESSION);
+
+SparseStream decode_sparse(const uint8_t* data, const uint64_t size);
 
 void write(
     const std::vector<std::vector<ExtractedPulse>> &pulses,
     const float time_slice_duration,
-    const std::string path);
+    const std::string path,
+    const uint16_t compression = NO_COMPRESSION);
+
+void write(
+    const SparseStream &sparse,
+    const std::string path,
+    const uint16_t compression = NO_COMPRESSION);
 
 void write_simulation_truth(
     const std::vector<std::vector<ExtractedPulse>> &pulses,
     const std::string path);
 
-struct Stream {
-    std::vector<std::vector<ExtractedPulse>> photon_stream;
-    float time_slice_duration;
-    Stream();
-};
+void write_simulation_truth(
+    const SparseStream &sparse,
+    const std::string path);
+
+FlatStream read_flat(const std::string path);
+
+FlatStream read_flat_with_simulation_truth(
+    const std::string path,
+    const std::string truth_path);
 
 Stream read(const std::string path);
 
@@ -35,6 +115,16 @@ Stream read_with_simulation_truth(
     const std::string path,
     const std::string truth_path);
 
+SparseStream read_sparse(const std::string path);
+
+SparseStream read_sparse_with_simulation_truth(
+    const std::string path,
+    const std::string truth_path);
+
+SparseStream to_sparse(const Stream &dense);
+
+Stream to_dense(const SparseStream &sparse);
+
 uint64_t num_pulses(
     const std::vector<std::vector<ExtractedPulse>> &pulses);
 
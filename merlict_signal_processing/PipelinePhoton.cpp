@@ -26,12 +26,21 @@ std::vector<std::vector<PipelinePhoton>> get_photon_pipelines(
     const merlict::sensor::Sensors* sensors
 ) {
     std::vector<std::vector<PipelinePhoton>> photon_pipelines;
+    get_photon_pipelines(sensors, &photon_pipelines);
+    return photon_pipelines;
+}
+
+void get_photon_pipelines(
+    const merlict::sensor::Sensors* sensors,
+    std::vector<std::vector<PipelinePhoton>>* photon_pipelines
+) {
     const unsigned int num_sensors = sensors->size();
-    photon_pipelines.reserve(num_sensors);
+    photon_pipelines->resize(num_sensors);
 
     // for each sensor
     for (unsigned int i = 0; i < num_sensors; i++) {
-        std::vector<PipelinePhoton> photon_pipeline;
+        std::vector<PipelinePhoton> &photon_pipeline = photon_pipelines->at(i);
+        photon_pipeline.clear();
         const unsigned int num_photons =
             sensors->by_occurence[i]->photon_arrival_history.size();
         photon_pipeline.reserve(num_photons);
@@ -50,10 +59,7 @@ std::vector<std::vector<PipelinePhoton>> get_photon_pipelines(
         }
 
         sort_photon_pipelines_arrival_time(&photon_pipeline);
-        photon_pipelines.push_back(photon_pipeline);
     }
-
-    return photon_pipelines;
 }
 
 void sort_photon_pipelines_arrival_time(std::vector<PipelinePhoton>* pipeline) {
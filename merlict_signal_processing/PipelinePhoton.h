@@ -22,6 +22,11 @@ struct PipelinePhoton {
 std::vector<std::vector<PipelinePhoton>> get_photon_pipelines(
     const merlict::sensor::Sensors* sensors);
 
+// Reuses the memory already allocated in photon_pipelines.
+void get_photon_pipelines(
+    const merlict::sensor::Sensors* sensors,
+    std::vector<std::vector<PipelinePhoton>>* photon_pipelines);
+
 void sort_photon_pipelines_arrival_time(
     std::vector<PipelinePhoton>* pipeline);
 
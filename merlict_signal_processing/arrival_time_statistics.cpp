@@ -0,0 +1,158 @@
+// Copyright 2018 Sebastian A. Mueller
+#include "merlict_signal_processing/arrival_time_statistics.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+
+namespace signal_processing {
+
+ArrivalTimeExtent::ArrivalTimeExtent() {
+    num = 0u;
+    min = std::numeric_limits<double>::max();
+    max = std::numeric_limits<double>::lowest();
+}
+
+void ArrivalTimeExtent::fill(const double arrival_time) {
+    num++;
+    if (arrival_time < min)
+        min = arrival_time;
+    if (arrival_time > max)
+        max = arrival_time;
+}
+
+ArrivalTimeHistogram::ArrivalTimeHistogram(
+    const ArrivalTimeExtent &extent,
+    const uint64_t num_bins
+):
+    counts(num_bins > 0u ? num_bins : 1u, 0u),
+    min_(extent.num > 0u ? extent.min : 0.0) {
+    const double range = extent.num > 0u ? extent.max - extent.min : 0.0;
+    bin_width_ = range/static_cast<double>(counts.size());
+}
+
+uint64_t ArrivalTimeHistogram::bin(const double arrival_time)const {
+    if (bin_width_ <= 0.0)
+        return 0u;
+    const double b = floor((arrival_time - min_)/bin_width_);
+    if (b < 0.0)
+        return 0u;
+    if (b >= static_cast<double>(counts.size()))
+        return counts.size() - 1u;
+    return static_cast<uint64_t>(b);
+}
+
+void ArrivalTimeHistogram::fill(const double arrival_time) {
+    counts[bin(arrival_time)]++;
+}
+
+double ArrivalTimeHistogram::mode()const {
+    const uint64_t idx_max_bin =
+        std::max_element(counts.begin(), counts.end()) - counts.begin();
+    return min_ + bin_width_*(static_cast<double>(idx_max_bin) + 0.5);
+}
+
+namespace {
+
+template<typename Pulse>
+ArrivalTimeExtent extent_of(
+    const std::vector<std::vector<Pulse>> &pipelines
+) {
+    ArrivalTimeExtent extent;
+    for (const std::vector<Pulse> &pipeline : pipelines)
+        for (const Pulse &pulse : pipeline)
+            extent.fill(pulse.arrival_time);
+    return extent;
+}
+
+uint64_t num_bins_for(const ArrivalTimeExtent &extent) {
+    return 1u + static_cast<uint64_t>(sqrt(static_cast<double>(extent.num)));
+}
+
+template<typename Pulse>
+ArrivalTimeHistogram histogram_of(
+    const std::vector<std::vector<Pulse>> &pipelines,
+    const ArrivalTimeExtent &extent
+) {
+    ArrivalTimeHistogram histogram(extent, num_bins_for(extent));
+    for (const std::vector<Pulse> &pipeline : pipelines)
+        for (const Pulse &pulse : pipeline)
+            histogram.fill(pulse.arrival_time);
+    return histogram;
+}
+
+template<typename Pulse>
+double mode_of(const std::vector<std::vector<Pulse>> &pipelines) {
+    const ArrivalTimeExtent extent = extent_of(pipelines);
+    if (extent.num == 0u)
+        return std::nan("");
+    return histogram_of(pipelines, extent).mode();
+}
+
+template<typename Pulse>
+double median_of(const std::vector<std::vector<Pulse>> &pipelines) {
+    const ArrivalTimeExtent extent = extent_of(pipelines);
+    if (extent.num == 0u)
+        return std::nan("");
+    const ArrivalTimeHistogram histogram = histogram_of(pipelines, extent);
+
+    uint64_t rank = extent.num/2u;
+    uint64_t median_bin = 0u;
+    while (rank >= histogram.counts[median_bin]) {
+        rank -= histogram.counts[median_bin];
+        median_bin++;
+    }
+
+    std::vector<double> in_median_bin;
+    in_median_bin.reserve(histogram.counts[median_bin]);
+    for (const std::vector<Pulse> &pipeline : pipelines)
+        for (const Pulse &pulse : pipeline)
+            if (histogram.bin(pulse.arrival_time) == median_bin)
+                in_median_bin.push_back(pulse.arrival_time);
+
+    std::nth_element(
+        in_median_bin.begin(),
+        in_median_bin.begin() + rank,
+        in_median_bin.end());
+    return in_median_bin[rank];
+}
+
+}  // namespace
+
+ArrivalTimeExtent arrival_time_extent(
+    const std::vector<std::vector<PipelinePhoton>> &pipelines
+) {
+    return extent_of(pipelines);
+}
+
+ArrivalTimeExtent arrival_time_extent(
+    const std::vector<std::vector<ElectricPulse>> &pipelines
+) {
+    return extent_of(pipelines);
+}
+
+double mode_of_arrival_times(
+    const std::vector<std::vector<PipelinePhoton>> &pipelines
+) {
+    return mode_of(pipelines);
+}
+
+double mode_of_arrival_times(
+    const std::vector<std::vector<ElectricPulse>> &pipelines
+) {
+    return mode_of(pipelines);
+}
+
+double median_of_arrival_times(
+    const std::vector<std::vector<PipelinePhoton>> &pipelines
+) {
+    return median_of(pipelines);
+}
+
+double median_of_arrival_times(
+    const std::vector<std::vector<ElectricPulse>> &pipelines
+) {
+    return median_of(pipelines);
+}
+
+}  // namespace signal_processing
@@ -0,0 +1,66 @@
+// Copyright 2018 Sebastian A. Mueller
+#ifndef SIGNALPROCESSING_ARRIVAL_TIME_STATISTICS_H_
+#define SIGNALPROCESSING_ARRIVAL_TIME_STATISTICS_H_
+
+#include <stdint.h>
+#include <vector>
+#include "merlict_signal_processing/PipelinePhoton.h"
+#include "merlict_signal_processing/ElectricPulse.h"
+
+namespace signal_processing {
+
+// Statistics of the arrival times in all channels of an event, estimated
+// in passes over the pipelines without copying the arrival times.
+
+struct ArrivalTimeExtent {
+    uint64_t num;
+    double min;
+    double max;
+    ArrivalTimeExtent();
+    void fill(const double arrival_time);
+};
+
+// num_bins bins of equal width in [extent.min, extent.max].
+// extent.max is put into the last bin.
+class ArrivalTimeHistogram {
+ public:
+    std::vector<uint64_t> counts;
+    ArrivalTimeHistogram(
+        const ArrivalTimeExtent &extent,
+        const uint64_t num_bins);
+    uint64_t bin(const double arrival_time)const;
+    void fill(const double arrival_time);
+    // Center of the bin with the most counts.
+    double mode()const;
+
+ private:
+    double min_;
+    double bin_width_;
+};
+
+ArrivalTimeExtent arrival_time_extent(
+    const std::vector<std::vector<PipelinePhoton>> &pipelines);
+
+ArrivalTimeExtent arrival_time_extent(
+    const std::vector<std::vector<ElectricPulse>> &pipelines);
+
+// Mode of a histogram with 1 + sqrt(num) bins. NaN when there are no
+// arrival times.
+double mode_of_arrival_times(
+    const std::vector<std::vector<PipelinePhoton>> &pipelines);
+
+double mode_of_arrival_times(
+    const std::vector<std::vector<ElectricPulse>> &pipelines);
+
+// The arrival time with rank num/2. A histogram locates the bin holding
+// this rank and only the arrival times in this bin are selected from.
+// NaN when there are no arrival times.
+double median_of_arrival_times(
+    const std::vector<std::vector<PipelinePhoton>> &pipelines);
+
+double median_of_arrival_times(
+    const std::vector<std::vector<ElectricPulse>> &pipelines);
+
+}  // namespace signal_processing
+
+#endif  // SIGNALPROCESSING_ARRIVAL_TIME_STATISTICS_H_
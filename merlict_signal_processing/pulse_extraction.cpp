@@ -6,6 +6,17 @@
 
 namespace signal_processing {
 
+int32_t extract_arrival_time_slice(
+    const double true_arrival_time,
+    const double time_slice_duration,
+    const double arrival_time_std,
+    merlict::random::Generator* prng
+) {
+    const double reconstructed_arrival_time = true_arrival_time +
+        prng->normal(0.0f, arrival_time_std);
+    return round(reconstructed_arrival_time/time_slice_duration);
+}
+
 std::vector<ExtractedPulse> extract_pulses(
     const std::vector<ElectricPulse> &electric_pulses,
     const double time_slice_duration,
@@ -15,11 +26,11 @@ std::vector<ExtractedPulse> extract_pulses(
     std::vector<ExtractedPulse> channel;
     channel.reserve(electric_pulses.size());
     for (uint32_t p = 0; p < electric_pulses.size(); p++) {
-        const double true_arrival_time = electric_pulses.at(p).arrival_time;
-        const double reconstructed_arrival_time = true_arrival_time +
-            prng->normal(0.0f, arrival_time_std);
-        const int32_t slice = round(
-            reconstructed_arrival_time/time_slice_duration);
+        const int32_t slice = extract_arrival_time_slice(
+            electric_pulses.at(p).arrival_time,
+            time_slice_duration,
+            arrival_time_std,
+            prng);
         if (slice >= 0 && slice < NUMBER_TIME_SLICES) {
             channel.emplace_back(
                 ExtractedPulse(
@@ -49,4 +60,32 @@ std::vector<std::vector<ExtractedPulse>> extract_pulses(
     return channels;
 }
 
+void extract_pulses(
+    const std::vector<std::vector<ElectricPulse>> &electric_pulses,
+    const double time_slice_duration,
+    const double arrival_time_std,
+    merlict::random::Generator* prng,
+    PhotonStream::SparseStream* sparse
+) {
+    sparse->pulses.clear();
+    sparse->num_channels = electric_pulses.size();
+    sparse->time_slice_duration = time_slice_duration;
+    for (uint32_t channel = 0; channel < electric_pulses.size(); channel++) {
+        for (const ElectricPulse &pulse : electric_pulses.at(channel)) {
+            const int32_t slice = extract_arrival_time_slice(
+                pulse.arrival_time,
+                time_slice_duration,
+                arrival_time_std,
+                prng);
+            if (slice >= 0 && slice < NUMBER_TIME_SLICES) {
+                sparse->pulses.emplace_back(
+                    PhotonStream::SparsePulse(
+                        channel,
+                        static_cast<uint8_t>(slice),
+                        pulse.simulation_truth_id));
+            }
+        }
+    }
+}
+
 }  // namespace signal_processing
@@ -6,6 +6,7 @@
 #include <vector>
 #include "merlict_signal_processing/ElectricPulse.h"
 #include "merlict_signal_processing/ExtractedPulse.h"
+#include "merlict_signal_processing/PhotonStream.h"
 #include "merlict/merlict.h"
 
 namespace signal_processing {
@@ -24,6 +25,15 @@ std::vector<std::vector<ExtractedPulse>> extract_pulses(
     const double arrival_time_std,
     merlict::random::Generator* prng);
 
+// Draws the same random numbers as the dense extract_pulses above, but only
+// appends the pulses which are actually extracted into the sparse stream.
+void extract_pulses(
+    const std::vector<std::vector<ElectricPulse>> &electric_pulses,
+    const double time_slice_duration,
+    const double arrival_time_std,
+    merlict::random::Generator* prng,
+    PhotonStream::SparseStream* sparse);
+
 }  // namespace signal_processing
 
 #endif  // SIGNALPROCESSING_PULSE_EXTRACTION_H_
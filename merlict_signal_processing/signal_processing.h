@@ -8,6 +8,7 @@
 #include "ElectricPulse.h"
 #include "ExtractedPulse.h"
 #include "pulse_extraction.h"
+#include "arrival_time_statistics.h"
 #include "PhotoElectricConverter.h"
 
 #endif  // SIGNAL_PROCESSING_SIGNAL_PROCESSING_H_
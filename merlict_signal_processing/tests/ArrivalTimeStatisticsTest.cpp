@@ -0,0 +1,76 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <math.h>
+#include <algorithm>
+#include "merlict/tests/catch.hpp"
+#include "merlict_signal_processing/signal_processing.h"
+#include "merlict/random/random.h"
+namespace ml = merlict;
+namespace sp = signal_processing;
+
+
+std::vector<std::vector<sp::ElectricPulse>> random_pipelines(
+    const unsigned int num_channels,
+    const unsigned int num_pulses,
+    const unsigned int seed
+) {
+    ml::random::Mt19937 prng(seed);
+    std::vector<std::vector<sp::ElectricPulse>> pipelines(num_channels);
+    for (unsigned int i = 0; i < num_pulses; i++) {
+        const unsigned int ch = num_channels*prng.uniform();
+        pipelines.at(ch).push_back(
+            sp::ElectricPulse(prng.normal(25e-9, 5e-9), 0));
+    }
+    return pipelines;
+}
+
+TEST_CASE("ArrivalTimeStatisticsTest: empty", "[merlict]") {
+    std::vector<std::vector<sp::ElectricPulse>> pipelines(10);
+    CHECK(sp::arrival_time_extent(pipelines).num == 0u);
+    CHECK(std::isnan(sp::mode_of_arrival_times(pipelines)));
+    CHECK(std::isnan(sp::median_of_arrival_times(pipelines)));
+}
+
+TEST_CASE("ArrivalTimeStatisticsTest: single_arrival_time", "[merlict]") {
+    std::vector<std::vector<sp::PipelinePhoton>> pipelines(3);
+    pipelines.at(1).push_back(sp::PipelinePhoton(42e-9, 433e-9, 0));
+    CHECK(sp::mode_of_arrival_times(pipelines) == 42e-9);
+    CHECK(sp::median_of_arrival_times(pipelines) == 42e-9);
+}
+
+TEST_CASE("ArrivalTimeStatisticsTest: median_equals_sorting", "[merlict]") {
+    for (unsigned int num_pulses : {1u, 2u, 3u, 10u, 1000u, 12345u}) {
+        std::vector<std::vector<sp::ElectricPulse>> pipelines =
+            random_pipelines(100, num_pulses, num_pulses);
+
+        std::vector<double> all;
+        for (const std::vector<sp::ElectricPulse> &pipeline : pipelines)
+            for (const sp::ElectricPulse &pulse : pipeline)
+                all.push_back(pulse.arrival_time);
+        std::sort(all.begin(), all.end());
+
+        CHECK(sp::median_of_arrival_times(pipelines) == all.at(all.size()/2));
+
+        sp::ArrivalTimeExtent extent = sp::arrival_time_extent(pipelines);
+        CHECK(extent.num == num_pulses);
+        CHECK(extent.min == all.front());
+        CHECK(extent.max == all.back());
+    }
+}
+
+TEST_CASE("ArrivalTimeStatisticsTest: mode", "[merlict]") {
+    std::vector<std::vector<sp::ElectricPulse>> pipelines =
+        random_pipelines(100, 100*1000, 0);
+    CHECK(sp::mode_of_arrival_times(pipelines) == Approx(25e-9).margin(2.5e-9));
+
+    sp::ArrivalTimeExtent extent;
+    extent.fill(0.0);
+    extent.fill(1.0);
+    sp::ArrivalTimeHistogram histogram(extent, 4);
+    CHECK(histogram.bin(0.0) == 0u);
+    CHECK(histogram.bin(0.3) == 1u);
+    CHECK(histogram.bin(1.0) == 3u);
+    histogram.fill(0.6);
+    histogram.fill(0.7);
+    histogram.fill(0.1);
+    CHECK(histogram.mode() == Approx(0.625));
+}
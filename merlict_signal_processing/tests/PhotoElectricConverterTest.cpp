@@ -195,3 +195,31 @@ TEST_CASE("PhotoElectricConverterTest: triangle_qeff", "[merlict]") {
     CHECK(30*1000u == Approx(hist.bins.at(8)).margin(37));
     CHECK(10*1000u == Approx(hist.bins.at(9)).margin(25));
 }
+
+TEST_CASE("PhotoElectricConverterTest: sampled_qeff", "[merlict]") {
+    signal_processing::PhotoElectricConverter::Config config;
+    ml::function::Func1 qeff({
+        {200e-9, 0.0}, {333e-9, 0.4}, {456e-9, 0.3}, {1200e-9, 0.0}});
+    config.quantum_efficiency_vs_wavelength = &qeff;
+    signal_processing::PhotoElectricConverter::Converter conv(&config);
+    for (double wavelength = 200e-9; wavelength < 1200e-9; wavelength += 3e-9)
+        CHECK(conv.quantum_efficiency(wavelength) ==
+            Approx(qeff.evaluate(wavelength)).margin(1e-12));
+    CHECK_THROWS_AS(conv.quantum_efficiency(1200e-9), std::out_of_range);
+
+    // covering more than the wavelengths of the grid
+    ml::function::Func1 wide({{100e-9, 0.2}, {1500e-9, 0.9}});
+    config.quantum_efficiency_vs_wavelength = &wide;
+    signal_processing::PhotoElectricConverter::Converter wide_conv(&config);
+    CHECK(wide_conv.quantum_efficiency(1250e-9) ==
+        Approx(wide.evaluate(1250e-9)).margin(1e-12));
+    CHECK(wide_conv.quantum_efficiency(150e-9) ==
+        Approx(wide.evaluate(150e-9)).margin(1e-12));
+
+    // not covering the wavelengths of the grid
+    ml::function::Func1 narrow({{300e-9, 0.5}, {700e-9, 0.5}});
+    config.quantum_efficiency_vs_wavelength = &narrow;
+    signal_processing::PhotoElectricConverter::Converter narrow_conv(&config);
+    CHECK(narrow_conv.quantum_efficiency(500e-9) == 0.5);
+    CHECK_THROWS_AS(narrow_conv.quantum_efficiency(800e-9), std::out_of_range);
+}
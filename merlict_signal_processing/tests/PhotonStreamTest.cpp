@@ -190,3 +190,170 @@ TEST_CASE("PhotonStreamTest: empty_channels", "[merlict]") {
         exposure_time,
         seed);
 }
+
+TEST_CASE("PhotonStreamTest: encode_symbols", "[merlict]") {
+    std::vector<std::vector<sp::ExtractedPulse>> channels(6);
+    channels.at(0).push_back(sp::ExtractedPulse(7, 0));
+    channels.at(4).push_back(sp::ExtractedPulse(3, 0));
+    channels.at(4).push_back(sp::ExtractedPulse(9, 0));
+
+    std::vector<uint8_t> raw = sp::PhotonStream::encode(channels, 0.5e-9);
+    REQUIRE(raw.size() == sp::PhotonStream::HEADER_SIZE + 8u);
+    std::vector<uint8_t> raw_symbols(raw.begin() + 16, raw.end());
+    std::vector<uint8_t> expected_raw = {7, 255, 255, 255, 255, 3, 9, 255};
+    CHECK(raw_symbols == expected_raw);
+    CHECK(raw.at(8) == 100);
+    CHECK(raw.at(10) == 0);
+
+    std::vector<uint8_t> rle = sp::PhotonStream::encode(
+        channels,
+        0.5e-9,
+        sp::PhotonStream::RUN_LENGTH_COMPRESSION);
+    REQUIRE(rle.size() == sp::PhotonStream::HEADER_SIZE + 6u);
+    std::vector<uint8_t> rle_symbols(rle.begin() + 16, rle.end());
+    std::vector<uint8_t> expected_rle = {7, 254, 4, 3, 9, 255};
+    CHECK(rle_symbols == expected_rle);
+    CHECK(rle.at(8) == 100);
+    CHECK(rle.at(10) == sp::PhotonStream::RUN_LENGTH_COMPRESSION);
+
+    for (const std::vector<uint8_t> &buffer : {raw, rle}) {
+        sp::PhotonStream::FlatStream flat = sp::PhotonStream::decode(
+            buffer.data(),
+            buffer.size());
+        CHECK(flat.time_slice_duration == 0.5e-9f);
+        std::vector<uint64_t> expected_begin = {0, 1, 1, 1, 1, 3, 3};
+        CHECK(flat.channel_begin == expected_begin);
+        std::vector<uint8_t> expected_slices = {7, 3, 9};
+        CHECK(flat.arrival_time_slices == expected_slices);
+        CHECK(flat.simulation_truth_ids.size() == 0u);
+    }
+}
+
+TEST_CASE("PhotonStreamTest: run_length_compression", "[merlict]") {
+    sp::PhotonStream::Stream stream;
+    stream.photon_stream = create_photon_stream(
+        20*1000,
+        2e6,
+        127.0e-9,
+        0.5e-9,
+        0);
+    stream.time_slice_duration = 0.5e-9;
+
+    const std::string path =
+        "merlict_signal_processing/tests/resources/photon_stream_rle.bin.tmp";
+    const std::string truth_path =
+        "merlict_signal_processing/tests/resources/photon_stream_rle_truth.bin.tmp";
+    sp::PhotonStream::write(
+        stream.photon_stream,
+        stream.time_slice_duration,
+        path,
+        sp::PhotonStream::RUN_LENGTH_COMPRESSION);
+    sp::PhotonStream::write_simulation_truth(stream.photon_stream, truth_path);
+
+    sp::PhotonStream::Stream back =
+        sp::PhotonStream::read_with_simulation_truth(path, truth_path);
+    expect_eq(stream, back);
+
+    const uint64_t num_raw_symbols =
+        sp::PhotonStream::num_symbols_to_represent(stream.photon_stream);
+    const std::vector<uint8_t> rle = sp::PhotonStream::encode(
+        stream.photon_stream,
+        stream.time_slice_duration,
+        sp::PhotonStream::RUN_LENGTH_COMPRESSION);
+    CHECK(rle.size() - sp::PhotonStream::HEADER_SIZE < num_raw_symbols);
+
+    // run length encoding reserves RUN_MARKER
+    std::vector<std::vector<sp::ExtractedPulse>> reserved(1);
+    reserved.at(0).push_back(
+        sp::ExtractedPulse(sp::PhotonStream::RUN_MARKER, 0));
+    CHECK_THROWS_AS(
+        sp::PhotonStream::encode(
+            reserved,
+            0.5e-9,
+            sp::PhotonStream::RUN_LENGTH_COMPRESSION),
+        std::runtime_error);
+    CHECK_NOTHROW(sp::PhotonStream::encode(reserved, 0.5e-9));
+}
+
+TEST_CASE("PhotonStreamTest: decode_truncated", "[merlict]") {
+    std::vector<std::vector<sp::ExtractedPulse>> channels(3);
+    channels.at(1).push_back(sp::ExtractedPulse(7, 0));
+    std::vector<uint8_t> buffer = sp::PhotonStream::encode(channels, 0.5e-9);
+    CHECK_THROWS_AS(
+        sp::PhotonStream::decode(buffer.data(), buffer.size() - 1),
+        std::runtime_error);
+    CHECK_THROWS_AS(
+        sp::PhotonStream::decode(buffer.data(), 10),
+        std::runtime_error);
+}
+
+TEST_CASE("PhotonStreamTest: sparse_and_dense_encode_the_same", "[merlict]") {
+    sp::PhotonStream::Stream dense;
+    dense.photon_stream = create_photon_stream(
+        5*1000,
+        2e6,
+        127.0e-9,
+        0.5e-9,
+        0);
+    dense.photon_stream.emplace_back();
+    dense.time_slice_duration = 0.5e-9;
+
+    sp::PhotonStream::SparseStream sparse = sp::PhotonStream::to_sparse(dense);
+    CHECK(sparse.num_channels == dense.photon_stream.size());
+    CHECK(
+        sparse.pulses.size() ==
+        sp::PhotonStream::num_pulses(dense.photon_stream));
+    expect_eq(dense, sp::PhotonStream::to_dense(sparse));
+
+    for (const uint16_t compression : {
+        sp::PhotonStream::NO_COMPRESSION,
+        sp::PhotonStream::RUN_LENGTH_COMPRESSION}
+    ) {
+        const std::vector<uint8_t> from_dense = sp::PhotonStream::encode(
+            dense.photon_stream,
+            dense.time_slice_duration,
+            compression);
+        const std::vector<uint8_t> from_sparse = sp::PhotonStream::encode(
+            sparse,
+            compression);
+        CHECK(from_dense == from_sparse);
+
+        sp::PhotonStream::SparseStream back = sp::PhotonStream::decode_sparse(
+            from_sparse.data(),
+            from_sparse.size());
+        expect_eq(
+            dense,
+            sp::PhotonStream::to_dense(back),
+            false);
+    }
+
+    const std::string path =
+        "merlict_signal_processing/tests/resources/photon_stream_sparse.bin.tmp";
+    const std::string truth_path =
+        "merlict_signal_processing/tests/resources/photon_stream_sparse_truth.bin.tmp";
+    sp::PhotonStream::write(sparse, path);
+    sp::PhotonStream::write_simulation_truth(sparse, truth_path);
+    expect_eq(
+        dense,
+        sp::PhotonStream::to_dense(
+            sp::PhotonStream::read_sparse_with_simulation_truth(
+                path,
+                truth_path)));
+    expect_eq(
+        dense,
+        sp::PhotonStream::read_with_simulation_truth(path, truth_path));
+}
+
+TEST_CASE("PhotonStreamTest: sparse_must_be_sorted_by_channel", "[merlict]") {
+    sp::PhotonStream::SparseStream sparse;
+    sparse.num_channels = 10;
+    sparse.pulses.emplace_back(sp::PhotonStream::SparsePulse(3, 7, 0));
+    sparse.pulses.emplace_back(sp::PhotonStream::SparsePulse(2, 7, 0));
+    CHECK_THROWS_AS(sp::PhotonStream::encode(sparse), std::runtime_error);
+
+    sparse.pulses.at(1).channel = 10;
+    CHECK_THROWS_AS(sp::PhotonStream::encode(sparse), std::runtime_error);
+
+    sparse.pulses.at(1).channel = 9;
+    CHECK_NOTHROW(sp::PhotonStream::encode(sparse));
+}
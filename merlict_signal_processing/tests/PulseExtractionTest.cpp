@@ -122,3 +122,55 @@ TEST_CASE("PulseExtractionTest: arrival_time_std", "[merlict]") {
     CHECK(arrival_time_std == Approx(ml::numeric::stddev(reconstructed_arrival_times)).margin(1e-10));
     CHECK(true_arrival_time == Approx(ml::numeric::mean(reconstructed_arrival_times)).margin(1e-10));
 }
+
+TEST_CASE("PulseExtractionTest: sparse_equals_dense", "[merlict]") {
+    const double time_slice_duration = .5e-9;
+    const double arrival_time_std = 0.4e-9;
+
+    std::vector<std::vector<signal_processing::ElectricPulse>> response(50);
+    ml::random::Mt19937 prng_response(1);
+    for (uint32_t ch = 0; ch < response.size(); ch += 7) {
+        for (int i = 0; i < 20; i++) {
+            signal_processing::ElectricPulse pulse;
+            pulse.arrival_time = 60e-9*prng_response.uniform() - 5e-9;
+            pulse.simulation_truth_id = i;
+            response.at(ch).push_back(pulse);
+        }
+    }
+
+    ml::random::Mt19937 prng_dense(0);
+    std::vector<std::vector<signal_processing::ExtractedPulse>> dense =
+        signal_processing::extract_pulses(
+            response,
+            time_slice_duration,
+            arrival_time_std,
+            &prng_dense);
+
+    ml::random::Mt19937 prng_sparse(0);
+    signal_processing::PhotonStream::SparseStream sparse;
+    signal_processing::extract_pulses(
+        response,
+        time_slice_duration,
+        arrival_time_std,
+        &prng_sparse,
+        &sparse);
+
+    CHECK(sparse.num_channels == response.size());
+    CHECK(sparse.time_slice_duration == float(time_slice_duration));
+    REQUIRE(
+        sparse.pulses.size() ==
+        signal_processing::PhotonStream::num_pulses(dense));
+    uint64_t p = 0;
+    for (uint32_t ch = 0; ch < dense.size(); ch++) {
+        for (const signal_processing::ExtractedPulse &pulse : dense.at(ch)) {
+            CHECK(sparse.pulses.at(p).channel == ch);
+            CHECK(
+                sparse.pulses.at(p).arrival_time_slice ==
+                pulse.arrival_time_slice);
+            CHECK(
+                sparse.pulses.at(p).simulation_truth_id ==
+                pulse.simulation_truth_id);
+            p++;
+        }
+    }
+}
@@ -0,0 +1,177 @@
+// Copyright 2018 Sebastian A. Mueller
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "docopt/docopt.h"
+#include "merlict/merlict.h"
+namespace ml = merlict;
+
+
+static const char USAGE[] =
+R"(Micro benchmark of the math kernels in the inner ray tracing loops
+
+    Usage:
+      benchmark-math [-n=NUMBER]
+      benchmark-math (-h | --help)
+      benchmark-math --version
+
+    Options:
+      -n --num_mega_iterations=NUMBER   Number count [Mega Iterations]
+                                        for each kernel [default: 10].
+      -h --help                         Show this screen.
+      --version                         Show version.
+)";
+
+const uint64_t NUM_SAMPLES = 1024u;
+
+template<typename Kernel>
+void report(
+    const std::string &name,
+    const uint64_t num_iterations,
+    Kernel kernel
+) {
+    const auto start = std::chrono::steady_clock::now();
+    double checksum = 0.0;
+    for (uint64_t i = 0; i < num_iterations; i++)
+        checksum += kernel(i%NUM_SAMPLES);
+    const auto stop = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(
+        stop - start).count();
+    std::cout << std::left << std::setw(40) << name;
+    std::cout << std::right << std::setw(10) << std::fixed;
+    std::cout << std::setprecision(2) << ns/num_iterations << " ns";
+    std::cout << "  (checksum " << std::scientific << checksum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::map<std::string, docopt::value> args = docopt::docopt(
+            USAGE,
+            { argv + 1, argv + argc },
+            true,        // show help if requested
+            "0.1");  // version string
+
+        const uint64_t num_iterations = 1000000u*ml::txt::to_int(
+            args.find("--num_mega_iterations")->second.asString());
+
+        ml::random::Mt19937 prng(0u);
+        std::vector<ml::Ray> rays;
+        std::vector<ml::Ray> downward_rays;
+        std::vector<ml::Vec3> vecs;
+        std::vector<double> ps;
+        std::vector<double> qs;
+        for (uint64_t i = 0; i < NUM_SAMPLES; i++) {
+            rays.push_back(ml::Ray(
+                ml::Vec3(prng.uniform(), prng.uniform(), prng.uniform()),
+                ml::Vec3(prng.uniform(), prng.uniform(), 1.0)));
+            downward_rays.push_back(ml::Ray(
+                ml::Vec3(
+                    2.0*prng.uniform() - 1.0,
+                    2.0*prng.uniform() - 1.0,
+                    1.0 + prng.uniform()),
+                ml::Vec3(
+                    0.1*prng.uniform() - 0.05,
+                    0.1*prng.uniform() - 0.05,
+                    -1.0)));
+            vecs.push_back(
+                ml::Vec3(prng.uniform(), prng.uniform(), prng.uniform()));
+            ps.push_back(prng.uniform() - 0.5);
+            qs.push_back(prng.uniform() - 0.75);
+        }
+
+        ml::Frame root;
+        root.set_name_pos_rot("root", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+        ml::Frame* frame = root.add<ml::Frame>();
+        frame->set_name_pos_rot(
+            "frame",
+            ml::Vec3(1.0, 2.0, 3.0),
+            ml::Rot3(0.1, 0.2, 0.3));
+        ml::SphereCapWithHexagonalBound* cap =
+            root.add<ml::SphereCapWithHexagonalBound>();
+        cap->set_name_pos_rot("cap", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+        cap->set_curvature_radius_and_outer_hex_radius(10.0, 1.0);
+        ml::HexPlane* hex = root.add<ml::HexPlane>();
+        hex->set_name_pos_rot("hex", ml::VEC3_ORIGIN, ml::ROT3_UNITY);
+        hex->set_outer_hex_radius(1.0);
+        ml::Frame* translated = root.add<ml::Frame>();
+        translated->set_name_pos_rot(
+            "translated",
+            ml::Vec3(-1.0, -2.0, -3.0),
+            ml::ROT3_UNITY);
+        root.init_tree_based_on_mother_child_relations();
+
+        const ml::HomTra3 *T = frame->frame2world();
+
+        report("ray_with_respect_to_frame", num_iterations,
+            [&](const uint64_t i) {
+                const ml::Ray r = ml::ray_with_respect_to_frame(
+                    &rays[i],
+                    frame);
+                return r.support().x + r.direction().z;
+            });
+
+        report("ray_with_respect_to_frame, translated", num_iterations,
+            [&](const uint64_t i) {
+                const ml::Ray r = ml::ray_with_respect_to_frame(
+                    &rays[i],
+                    translated);
+                return r.support().x + r.direction().z;
+            });
+
+        report("HomTra3::position", num_iterations,
+            [&](const uint64_t i) {
+                return T->position(vecs[i]).y;
+            });
+
+        report("HomTra3::orientation_inverse", num_iterations,
+            [&](const uint64_t i) {
+                return T->orientation_inverse(vecs[i]).z;
+            });
+
+        report("Vec3 cross, dot, and norm", num_iterations,
+            [&](const uint64_t i) {
+                const ml::Vec3 &a = vecs[i];
+                const ml::Vec3 &b = vecs[(i + 1u)%NUM_SAMPLES];
+                return a.cross(b)*(a + b) + (a - b*0.5).norm();
+            });
+
+        report("Vec3::mirror", num_iterations,
+            [&](const uint64_t i) {
+                ml::Vec3 v = vecs[(i + 1u)%NUM_SAMPLES];
+                rays[i].direction().mirror(&v);
+                return v.x;
+            });
+
+        report("QuadraticEquation", num_iterations,
+            [&](const uint64_t i) {
+                ml::QuadraticEquation eq(ps[i], qs[i]);
+                if (!eq.has_valid_solutions())
+                    return 0.0;
+                return eq.minus_solution() + eq.plus_solution();
+            });
+
+        std::vector<ml::Intersection> intersections;
+        report("SphereCapWithHexagonalBound", num_iterations,
+            [&](const uint64_t i) {
+                intersections.clear();
+                cap->calculate_intersection_with(
+                    &downward_rays[i],
+                    &intersections);
+                return static_cast<double>(intersections.size());
+            });
+
+        report("HexPlane", num_iterations,
+            [&](const uint64_t i) {
+                intersections.clear();
+                hex->calculate_intersection_with(
+                    &downward_rays[i],
+                    &intersections);
+                return static_cast<double>(intersections.size());
+            });
+
+    } catch (std::exception &error) {
+        std::cerr << error.what();
+    }
+    return 0;
+}